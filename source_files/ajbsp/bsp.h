@@ -39,6 +39,9 @@ struct BuildInfo
 
     int split_cost;
 
+    // threads used to evaluate partition candidates in each level
+    int eval_threads;
+
     // from here on, various bits of internal state
     int total_warnings;
     int total_minor_issues;
@@ -60,6 +63,10 @@ namespace ajbsp
 // set the build information.  must be done before anything else.
 void ResetInfo();
 
+// use this many threads to evaluate partition lines (default is 1).
+// the result is identical to a single-threaded build.
+void SetPartitionThreads(int threads);
+
 // attempt to open a wad.  on failure, the FatalError method in the
 // BuildInfo interface is called.
 void OpenWad(const std::string &filename);
@@ -84,6 +91,17 @@ int LevelsInWad();
 // kBuildError
 BuildResult BuildLevel(int level_index);
 
+// the three stages of BuildLevel(), for building several levels at once.
+// the level data is thread-local, so all stages of a level must be run on
+// the same thread.  BeginLevel() and FinishLevel() access the wad files,
+// hence the caller must make sure only one thread is in either of them at
+// any time, and must call FinishLevel() in level order for the XWA file to
+// come out identical to a serial build.  BuildLevelNodes() does the bulk of
+// the work and may run concurrently with anything.
+void        BeginLevel(int level_index, bool show_progress);
+BuildResult BuildLevelNodes();
+BuildResult FinishLevel();
+
 } // namespace ajbsp
 
 //--- editor settings ---
@@ -25,8 +25,8 @@
 #include "bsp_wad.h"
 #include "epi_doomdefs.h"
 #include "epi_endian.h"
-#include "epi_scanner.h"
 #include "epi_str_util.h"
+#include "epi_udmf.h"
 #include "miniz.h"
 
 #define AJBSP_DEBUG_BLOCKMAP 0
@@ -59,31 +59,35 @@ WadFile *xwa_wad;
 
 // Note: ZDoom format support based on code (C) 2002,2003 Randy Heit
 
-// per-level variables
+// per-level variables.  these are thread-local so that several levels
+// can be built at the same time (see BeginLevel).
 
-const char *level_current_name;
+thread_local const char *level_current_name;
 
-int level_current_idx;
-int level_current_start;
+thread_local int level_current_idx;
+thread_local int level_current_start;
 
-MapFormat level_format;
+thread_local MapFormat level_format;
 
-bool level_long_name;
+thread_local bool level_long_name;
 
 // objects of loaded level, and stuff we've built
-std::vector<Vertex *>  level_vertices;
-std::vector<Linedef *> level_linedefs;
-std::vector<Sidedef *> level_sidedefs;
-std::vector<Sector *>  level_sectors;
+thread_local std::vector<Vertex *>  level_vertices;
+thread_local std::vector<Linedef *> level_linedefs;
+thread_local std::vector<Sidedef *> level_sidedefs;
+thread_local std::vector<Sector *>  level_sectors;
 
-std::vector<Seg *>       level_segs;
-std::vector<Subsector *> level_subsecs;
-std::vector<Node *>      level_nodes;
-std::vector<WallTip *>   level_walltips;
+thread_local std::vector<Seg *>       level_segs;
+thread_local std::vector<Subsector *> level_subsecs;
+thread_local std::vector<Node *>      level_nodes;
+thread_local std::vector<WallTip *>   level_walltips;
 
-int num_old_vert   = 0;
-int num_new_vert   = 0;
-int num_real_lines = 0;
+thread_local int num_old_vert   = 0;
+thread_local int num_new_vert   = 0;
+thread_local int num_real_lines = 0;
+
+thread_local Node       *level_root_node   = nullptr;
+thread_local BuildResult level_build_result = kBuildOK;
 
 /* ----- allocation routines ---------------------------- */
 
@@ -418,19 +422,19 @@ void GetLinedefs()
 
 /* ----- UDMF reading routines ------------------------- */
 
-static void ParseVertexField(Vertex *vertex, const uint32_t &key, const epi::Scanner &lex)
+static void ParseVertexField(Vertex *vertex, const epi::UDMFTextMap &textmap, const epi::UDMFField &field)
 {
-    if (key == udmf::kX)
-        vertex->x_ = lex.state_.decimal;
-    else if (key == udmf::kY)
-        vertex->y_ = lex.state_.decimal;
+    if (field.key == udmf::kX)
+        vertex->x_ = textmap.Decimal(field);
+    else if (field.key == udmf::kY)
+        vertex->y_ = textmap.Decimal(field);
 }
 
-static void ParseSidedefField(Sidedef *side, const uint32_t &key, const epi::Scanner &lex)
+static void ParseSidedefField(Sidedef *side, const epi::UDMFTextMap &textmap, const epi::UDMFField &field)
 {
-    if (key == udmf::kSector)
+    if (field.key == udmf::kSector)
     {
-        int num = lex.state_.number;
+        int num = textmap.Number(field);
 
         if (num < 0 || (size_t)num >= level_sectors.size())
             FatalError("AJBSP: illegal sector number #%d\n", (int)num);
@@ -439,24 +443,24 @@ static void ParseSidedefField(Sidedef *side, const uint32_t &key, const epi::Sca
     }
 }
 
-static void ParseLinedefField(Linedef *line, const uint32_t &key, const epi::Scanner &lex)
+static void ParseLinedefField(Linedef *line, const epi::UDMFTextMap &textmap, const epi::UDMFField &field)
 {
-    switch (key)
+    switch (field.key)
     {
     case udmf::kV1:
-        line->start = SafeLookupVertex(lex.state_.number);
+        line->start = SafeLookupVertex(textmap.Number(field));
         break;
     case udmf::kV2:
-        line->end = SafeLookupVertex(lex.state_.number);
+        line->end = SafeLookupVertex(textmap.Number(field));
         break;
     case udmf::kSpecial:
-        line->type = lex.state_.number;
+        line->type = textmap.Number(field);
         break;
     case udmf::kTwoSided:
-        line->two_sided = lex.state_.boolean;
+        line->two_sided = textmap.Boolean(field);
         break;
     case udmf::kSideFront: {
-        int num = lex.state_.number;
+        int num = textmap.Number(field);
 
         if (num < 0 || num >= (int)level_sidedefs.size())
             line->right = nullptr;
@@ -465,7 +469,7 @@ static void ParseLinedefField(Linedef *line, const uint32_t &key, const epi::Sca
     }
     break;
     case udmf::kSideBack: {
-        int num = lex.state_.number;
+        int num = textmap.Number(field);
 
         if (num < 0 || num >= (int)level_sidedefs.size())
             line->left = nullptr;
@@ -478,7 +482,7 @@ static void ParseLinedefField(Linedef *line, const uint32_t &key, const epi::Sca
     }
 }
 
-void ParseUDMF_Block(epi::Scanner &lex, int cur_type)
+void ParseUDMF_Block(const epi::UDMFTextMap &textmap, const epi::UDMFBlock &block, int cur_type)
 {
     Vertex  *vertex = nullptr;
     Sidedef *side   = nullptr;
@@ -503,45 +507,20 @@ void ParseUDMF_Block(epi::Scanner &lex, int cur_type)
         break;
     }
 
-    while (lex.TokensLeft())
-    {
-        if (lex.CheckToken('}'))
-            break;
-
-        std::string key;
-        std::string value;
-
-        if (!lex.GetNextToken())
-            FatalError("AJBSP: Malformed TEXTMAP lump: unclosed block\n");
-
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("AJBSP: Malformed TEXTMAP lump: missing key\n");
-
-        key = lex.state_.string;
-
-        if (!lex.CheckToken('='))
-            FatalError("AJBSP: Malformed TEXTMAP lump: missing '='\n");
-
-        if (!lex.GetNextToken() || lex.state_.token == '}')
-            FatalError("AJBSP: Malformed TEXTMAP lump: missing value\n");
-
-        value = lex.state_.string;
-
-        if (!lex.CheckToken(';'))
-            FatalError("AJBSP: Malformed TEXTMAP lump: missing ';'\n");
-
-        epi::StringHash key_hash(key);
+    const epi::UDMFField *field = textmap.BlockFields(block);
 
+    for (uint32_t i = 0; i < block.total_fields; i++, field++)
+    {
         switch (cur_type)
         {
         case kUDMFVertex:
-            ParseVertexField(vertex, key_hash.Value(), lex);
+            ParseVertexField(vertex, textmap, *field);
             break;
         case kUDMFSidedef:
-            ParseSidedefField(side, key_hash.Value(), lex);
+            ParseSidedefField(side, textmap, *field);
             break;
         case kUDMFLinedef:
-            ParseLinedefField(line, key_hash.Value(), lex);
+            ParseLinedefField(line, textmap, *field);
             break;
         case kUDMFSector:
         case kUDMFThing:
@@ -574,44 +553,17 @@ void ParseUDMF_Block(epi::Scanner &lex, int cur_type)
     }
 }
 
-void ParseUDMF_Pass(const std::string &data, int pass)
+void ParseUDMF_Pass(const epi::UDMFTextMap &textmap, int pass)
 {
     // pass = 1 : vertices, sectors, things
     // pass = 2 : sidedefs
     // pass = 3 : linedefs
 
-    epi::Scanner lex(data);
-
-    while (lex.TokensLeft())
+    for (const epi::UDMFBlock &block : textmap.Blocks())
     {
-        std::string section;
-
-        if (!lex.GetNextToken())
-            return;
-
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("AJBSP: Malformed TEXTMAP lump.\n");
-
-        section = lex.state_.string;
-
-        // ignore top-level assignments
-        if (lex.CheckToken('='))
-        {
-            lex.GetNextToken();
-            section = lex.state_.string;
-            if (!lex.CheckToken(';'))
-                FatalError("AJBSP: Malformed TEXTMAP lump: missing ';'\n");
-            continue;
-        }
-
-        if (!lex.CheckToken('{'))
-            FatalError("AJBSP: Malformed TEXTMAP lump: missing '{'\n");
-
         int cur_type = 0;
 
-        epi::StringHash section_hash(section);
-
-        switch (section_hash.Value())
+        switch (block.name)
         {
         case udmf::kThing:
             if (pass == 1)
@@ -638,7 +590,8 @@ void ParseUDMF_Pass(const std::string &data, int pass)
         }
 
         // process the block
-        ParseUDMF_Block(lex, cur_type);
+        if (cur_type != 0)
+            ParseUDMF_Block(textmap, block, cur_type);
     }
 }
 
@@ -656,13 +609,18 @@ void ParseUDMF()
 
     // now parse it...
 
+    epi::UDMFTextMap textmap;
+
+    if (!textmap.Parse(data))
+        FatalError("AJBSP: %s\n", textmap.GetError().c_str());
+
     // the UDMF spec does not require objects to be in a dependency order.
     // for example: sidedefs may occur *after* the linedefs which refer to
-    // them.  hence we perform multiple passes over the TEXTMAP data.
+    // them.  hence we perform multiple passes over the parsed blocks.
 
-    ParseUDMF_Pass(data, 1);
-    ParseUDMF_Pass(data, 2);
-    ParseUDMF_Pass(data, 3);
+    ParseUDMF_Pass(textmap, 1);
+    ParseUDMF_Pass(textmap, 2);
+    ParseUDMF_Pass(textmap, 3);
 
     num_old_vert = level_vertices.size();
 }
@@ -794,7 +752,7 @@ void PutXGL3Segs()
     }
 }
 
-static int node_cur_index;
+static thread_local int node_cur_index;
 
 static void PutOneZNode(Node *node)
 {
@@ -891,14 +849,15 @@ void SaveXGL3Format(Lump *lump, Node *root_node)
 
 /* ----- whole-level routines --------------------------- */
 
-void LoadLevel()
+void LoadLevel(bool show_progress)
 {
     const Lump *LEV = cur_wad->GetLump(level_current_start);
 
     level_current_name = LEV->Name();
     level_long_name    = false;
 
-    StartupProgressMessage(epi::StringFormat("Building nodes for %s\n", level_current_name).c_str());
+    if (show_progress)
+        StartupProgressMessage(epi::StringFormat("Building nodes for %s\n", level_current_name).c_str());
 
     num_new_vert   = 0;
     num_real_lines = 0;
@@ -964,10 +923,10 @@ BuildResult SaveXWA(Node *root_node)
 
 //----------------------------------------------------------------------
 
-static Lump *zout_lump;
+static thread_local Lump *zout_lump;
 
-static z_stream zout_stream;
-static Bytef    zout_buffer[1024];
+static thread_local z_stream zout_stream;
+static thread_local Bytef    zout_buffer[1024];
 
 void ZLibBeginLump(Lump *lump)
 {
@@ -1085,6 +1044,12 @@ void ResetInfo()
     current_build_info.total_warnings     = 0;
     current_build_info.compress_nodes     = true;
     current_build_info.split_cost         = kSplitCostDefault;
+    current_build_info.eval_threads       = 1;
+}
+
+void SetPartitionThreads(int threads)
+{
+    current_build_info.eval_threads = (threads > 1) ? threads : 1;
 }
 
 void OpenWad(const std::string &filename)
@@ -1145,45 +1110,61 @@ int LevelsInWad()
 
 /* ----- build nodes for a single level ----- */
 
-BuildResult BuildLevel(int level_index)
-{
-    Node      *root_node = nullptr;
-    Subsector *root_sub  = nullptr;
+static thread_local Seg *level_seg_list = nullptr;
 
+void BeginLevel(int level_index, bool show_progress)
+{
     level_current_idx   = level_index;
     level_current_start = cur_wad->LevelHeader(level_index);
     level_format        = cur_wad->LevelFormat(level_index);
 
-    LoadLevel();
+    level_root_node    = nullptr;
+    level_build_result = kBuildOK;
 
-    BuildResult ret = kBuildOK;
+    LoadLevel(show_progress);
 
-    if (num_real_lines > 0)
+    // create initial segs
+    level_seg_list = (num_real_lines > 0) ? CreateSegs() : nullptr;
+}
+
+BuildResult BuildLevelNodes()
+{
+    if (level_seg_list != nullptr)
     {
+        Subsector  *root_sub = nullptr;
         BoundingBox dummy;
 
-        // create initial segs
-        Seg *list = CreateSegs();
+        StartPartitionEvaluator();
 
         // recursively create nodes
-        ret = BuildNodes(list, 0, &dummy, &root_node, &root_sub);
+        level_build_result = BuildNodes(level_seg_list, 0, &dummy, &level_root_node, &root_sub);
+        level_seg_list     = nullptr;
+
+        StopPartitionEvaluator();
     }
 
+    return level_build_result;
+}
+
+BuildResult FinishLevel()
+{
+    BuildResult ret = level_build_result;
+
     if (ret == kBuildOK)
     {
         LogDebug("    Built %zu NODES, %zu SSECTORS, %zu SEGS, %d VERTEXES\n", level_nodes.size(), level_subsecs.size(),
                  level_segs.size(), num_old_vert + num_new_vert);
 
-        if (root_node != nullptr)
+        if (level_root_node != nullptr)
         {
-            LogDebug("    Heights of subtrees: %d / %d\n", ComputeBSPHeight(root_node->r_.node),
-                     ComputeBSPHeight(root_node->l_.node));
+            LogDebug("    Heights of subtrees: %d / %d\n", ComputeBSPHeight(level_root_node->r_.node),
+                     ComputeBSPHeight(level_root_node->l_.node));
         }
 
         ClockwiseBSPTree();
 
         if (xwa_wad != nullptr)
-            ret = SaveXWA(root_node);
+            ret = SaveXWA(level_root_node);
         else
             FatalError("AJBSP: Cannot save nodes to XWA file!\n");
     }
@@ -1193,9 +1174,19 @@ BuildResult BuildLevel(int level_index)
 
     FreeLevel();
 
+    level_root_node = nullptr;
+
     return ret;
 }
 
+BuildResult BuildLevel(int level_index)
+{
+    BeginLevel(level_index, true);
+    BuildLevelNodes();
+
+    return FinishLevel();
+}
+
 } // namespace ajbsp
 
 //--- editor settings ---
@@ -338,18 +338,18 @@ class QuadTree
 
 /* ----- Level data arrays ----------------------- */
 
-extern std::vector<Vertex *>  level_vertices;
-extern std::vector<Linedef *> level_linedefs;
-extern std::vector<Sidedef *> level_sidedefs;
-extern std::vector<Sector *>  level_sectors;
+extern thread_local std::vector<Vertex *>  level_vertices;
+extern thread_local std::vector<Linedef *> level_linedefs;
+extern thread_local std::vector<Sidedef *> level_sidedefs;
+extern thread_local std::vector<Sector *>  level_sectors;
 
-extern std::vector<Seg *>       level_segs;
-extern std::vector<Subsector *> level_subsecs;
-extern std::vector<Node *>      level_nodes;
-extern std::vector<WallTip *>   level_walltips;
+extern thread_local std::vector<Seg *>       level_segs;
+extern thread_local std::vector<Subsector *> level_subsecs;
+extern thread_local std::vector<Node *>      level_nodes;
+extern thread_local std::vector<WallTip *>   level_walltips;
 
-extern int num_old_vert;
-extern int num_new_vert;
+extern thread_local int num_old_vert;
+extern thread_local int num_new_vert;
 
 /* ----- function prototypes ----------------------- */
 
@@ -469,6 +469,10 @@ int ComputeBSPHeight(const Node *node);
 //   in the wrong place order-wise. ]
 void ClockwiseBSPTree();
 
+// thread pool for PickNode, used when current_build_info.eval_threads > 1
+void StartPartitionEvaluator();
+void StopPartitionEvaluator();
+
 } // namespace ajbsp
 
 //--- editor settings ---
@@ -18,10 +18,13 @@
 //
 //------------------------------------------------------------------------
 
+#include <vector>
+
 #include "HandmadeMath.h"
 #include "bsp_local.h"
 #include "bsp_utility.h"
 #include "bsp_wad.h"
+#include "epi_sdl.h"
 
 #define AJBSP_DEBUG_PICKNODE 0
 #define AJBSP_DEBUG_SPLIT    0
@@ -34,6 +37,9 @@
 static constexpr uint8_t kPreciousCostMultiplier = 100;
 static constexpr uint8_t kSegFastModeThreshold   = 200;
 
+// below this many (candidate x seg) checks, threading costs more than it saves
+static constexpr int kParallelEvalMinimumWork = 16384;
+
 //
 // To be able to divide the nodes down, this routine must decide which
 // is the best Seg to use as a nodeline. It does this by selecting the
@@ -86,7 +92,7 @@ class EvalInfo
     }
 };
 
-std::vector<Intersection *> alloc_cuts;
+thread_local std::vector<Intersection *> alloc_cuts;
 
 Intersection *NewIntersection()
 {
@@ -654,6 +660,231 @@ bool PickNodeWorker(QuadTree *part_list, QuadTree *tree, Seg **best, double *bes
     return true;
 }
 
+//
+// Parallel partition evaluation (current_build_info.eval_threads > 1).
+//
+// The cost of each candidate does not depend on the others, and
+// EvalPartition() only gives up on a candidate once its cost is above
+// the bound it was given.  Sharing the best cost found so far between
+// the threads keeps that pruning, while every seg which could win still
+// gets its exact cost.  The winner is the lowest cost, ties going to the
+// seg PickNodeWorker() would have visited first, so the tree is the same
+// as a serial build.
+//
+
+static void CollectPartitionCandidates(QuadTree *part_list, std::vector<Seg *> &candidates)
+{
+    for (Seg *part = part_list->list_; part; part = part->next_)
+    {
+        /* ignore minisegs as partition candidates */
+        if (part->linedef_ != nullptr)
+            candidates.push_back(part);
+    }
+
+    for (int c = 0; c < 2; c++)
+    {
+        if (part_list->subs_[c] != nullptr && !part_list->subs_[c]->Empty())
+            CollectPartitionCandidates(part_list->subs_[c], candidates);
+    }
+}
+
+class PartitionEvaluator
+{
+  private:
+    std::vector<SDL_Thread *> threads_;
+
+    SDL_mutex *lock_;
+    SDL_cond  *wake_;
+    SDL_cond  *done_;
+
+    int  generation_ = 0;
+    int  busy_       = 0;
+    bool quit_       = false;
+
+    // the current job
+    QuadTree                 *tree_       = nullptr;
+    const std::vector<Seg *> *candidates_ = nullptr;
+
+    SDL_atomic_t next_candidate_;
+
+    // best cost found so far by any thread, protected by bound_lock_
+    SDL_SpinLock bound_lock_ = 0;
+    double       bound_      = 0;
+
+    // merged result, protected by lock_
+    double best_cost_  = 0;
+    size_t best_index_ = 0;
+
+  public:
+    PartitionEvaluator(int total_threads)
+    {
+        lock_ = SDL_CreateMutex();
+        wake_ = SDL_CreateCond();
+        done_ = SDL_CreateCond();
+
+        SDL_AtomicSet(&next_candidate_, 0);
+
+        // the calling thread makes up the numbers
+        for (int i = 1; i < total_threads; i++)
+        {
+            SDL_Thread *thread = SDL_CreateThread(WorkerProc, "AJBSP PickNode", this);
+
+            if (thread != nullptr)
+                threads_.push_back(thread);
+        }
+    }
+
+    ~PartitionEvaluator()
+    {
+        SDL_LockMutex(lock_);
+        quit_ = true;
+        SDL_CondBroadcast(wake_);
+        SDL_UnlockMutex(lock_);
+
+        for (SDL_Thread *thread : threads_)
+            SDL_WaitThread(thread, nullptr);
+
+        SDL_DestroyCond(done_);
+        SDL_DestroyCond(wake_);
+        SDL_DestroyMutex(lock_);
+    }
+
+    Seg *Run(QuadTree *tree, const std::vector<Seg *> &candidates)
+    {
+        tree_       = tree;
+        candidates_ = &candidates;
+        best_cost_  = 1.0e99;
+        best_index_ = candidates.size();
+        bound_      = 1.0e99;
+
+        SDL_AtomicSet(&next_candidate_, 0);
+
+        SDL_LockMutex(lock_);
+        generation_++;
+        busy_ = (int)threads_.size();
+        SDL_CondBroadcast(wake_);
+        SDL_UnlockMutex(lock_);
+
+        Evaluate();
+
+        SDL_LockMutex(lock_);
+
+        while (busy_ > 0)
+            SDL_CondWait(done_, lock_);
+
+        SDL_UnlockMutex(lock_);
+
+        if (best_index_ < candidates.size())
+            return candidates[best_index_];
+
+        return nullptr;
+    }
+
+  private:
+    static int WorkerProc(void *data)
+    {
+        ((PartitionEvaluator *)data)->WorkerLoop();
+        return 0;
+    }
+
+    void WorkerLoop()
+    {
+        int seen = 0;
+
+        for (;;)
+        {
+            SDL_LockMutex(lock_);
+
+            while (!quit_ && generation_ == seen)
+                SDL_CondWait(wake_, lock_);
+
+            bool quit = quit_;
+            seen      = generation_;
+
+            SDL_UnlockMutex(lock_);
+
+            if (quit)
+                return;
+
+            Evaluate();
+
+            SDL_LockMutex(lock_);
+            busy_--;
+            SDL_CondSignal(done_);
+            SDL_UnlockMutex(lock_);
+        }
+    }
+
+    double GetBound()
+    {
+        SDL_AtomicLock(&bound_lock_);
+        double bound = bound_;
+        SDL_AtomicUnlock(&bound_lock_);
+
+        return bound;
+    }
+
+    void LowerBound(double cost)
+    {
+        SDL_AtomicLock(&bound_lock_);
+        if (cost < bound_)
+            bound_ = cost;
+        SDL_AtomicUnlock(&bound_lock_);
+    }
+
+    void Evaluate()
+    {
+        double local_cost  = 1.0e99;
+        size_t local_index = candidates_->size();
+
+        for (;;)
+        {
+            size_t i = (size_t)SDL_AtomicAdd(&next_candidate_, 1);
+
+            if (i >= candidates_->size())
+                break;
+
+            double cost = EvalPartition(tree_, (*candidates_)[i], GetBound());
+
+            /* seg unsuitable ? */
+            if (cost < 0)
+                continue;
+
+            if (cost < local_cost || (cost == local_cost && i < local_index))
+            {
+                local_cost  = cost;
+                local_index = i;
+            }
+
+            LowerBound(cost);
+        }
+
+        SDL_LockMutex(lock_);
+
+        if (local_cost < best_cost_ || (local_cost == best_cost_ && local_index < best_index_))
+        {
+            best_cost_  = local_cost;
+            best_index_ = local_index;
+        }
+
+        SDL_UnlockMutex(lock_);
+    }
+};
+
+static thread_local PartitionEvaluator *partition_evaluator = nullptr;
+
+void StartPartitionEvaluator()
+{
+    if (current_build_info.eval_threads > 1)
+        partition_evaluator = new PartitionEvaluator(current_build_info.eval_threads);
+}
+
+void StopPartitionEvaluator()
+{
+    delete partition_evaluator;
+    partition_evaluator = nullptr;
+}
+
 //
 // Find the best seg in the seg_list to use as a partition line.
 //
@@ -689,6 +920,15 @@ static Seg *PickNode(QuadTree *tree)
         }
     }
 
+    if (partition_evaluator != nullptr &&
+        (int64_t)tree->real_num_ * (tree->real_num_ + tree->mini_num_) >= kParallelEvalMinimumWork)
+    {
+        std::vector<Seg *> candidates;
+        CollectPartitionCandidates(tree, candidates);
+
+        return partition_evaluator->Run(tree, candidates);
+    }
+
     if (!PickNodeWorker(tree, tree, &best, &best_cost))
     {
         /* hack here : BuildNodes will detect the cancellation */
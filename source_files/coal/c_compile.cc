@@ -1489,6 +1489,8 @@ void RealVM::GLOBFunction()
     df->source_file = strdup(comp_.source_file);
     df->source_line = comp_.source_line;
 
+    function_index_[df->name] = (int)functions_.size() - 1;
+
     int stack_ofs = 0;
 
     df->return_size = type_size[def->type->aux_type->type];
@@ -2211,6 +2213,90 @@ void RealVM::SetVectorZ(const char *mod_name, const char *var_name, double val)
     return;
 }
 
+int RealVM::BindVariable(Type *type, const char *mod_name, const char *var_name)
+{
+    Scope *scope = &comp_.global_scope;
+
+    if (mod_name)
+    {
+        Definition *mod_def = FindDef(&type_module, (char *)mod_name, &comp_.global_scope);
+        if (!mod_def)
+            return VM::NOT_FOUND;
+
+        scope = comp_.all_modules[mod_def->ofs];
+    }
+
+    Definition *var = FindDef(type, (char *)var_name, scope);
+    if (!var)
+        return VM::NOT_FOUND;
+
+    // global offset zero is reserved, so can never be a variable
+    EPI_ASSERT(var->ofs != VM::NOT_FOUND);
+
+    return var->ofs;
+}
+
+int RealVM::BindFloat(const char *mod_name, const char *var_name)
+{
+    return BindVariable(&type_float, mod_name, var_name);
+}
+
+int RealVM::BindString(const char *mod_name, const char *var_name)
+{
+    return BindVariable(&type_string, mod_name, var_name);
+}
+
+int RealVM::BindVector(const char *mod_name, const char *var_name)
+{
+    return BindVariable(&type_vector, mod_name, var_name);
+}
+
+double RealVM::GetFloat(int var)
+{
+    if (var == VM::NOT_FOUND)
+        RunError("GetFloat failed: variable is not bound\n");
+
+    return COAL_G_FLOAT(var);
+}
+
+const char *RealVM::GetString(int var)
+{
+    if (var == VM::NOT_FOUND)
+        RunError("GetString failed: variable is not bound\n");
+
+    return COAL_G_STRING(var);
+}
+
+double *RealVM::GetVector(int var)
+{
+    if (var == VM::NOT_FOUND)
+        RunError("GetVector failed: variable is not bound\n");
+
+    return COAL_G_VECTOR(var);
+}
+
+void RealVM::SetFloat(int var, double value)
+{
+    if (var != VM::NOT_FOUND)
+        COAL_G_FLOAT(var) = value;
+}
+
+void RealVM::SetString(int var, const char *value)
+{
+    if (var != VM::NOT_FOUND)
+        *COAL_REF_GLOBAL(var) = (double)InternaliseString(value);
+}
+
+void RealVM::SetVector(int var, double val_1, double val_2, double val_3)
+{
+    if (var == VM::NOT_FOUND)
+        return;
+
+    COAL_G_VECTOR(var)[0] = val_1;
+    COAL_G_VECTOR(var)[1] = val_2;
+    COAL_G_VECTOR(var)[2] = val_3;
+}
+
 VM *CreateVM()
 {
     EPI_ASSERT(sizeof(double) == 8);
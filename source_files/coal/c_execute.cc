@@ -88,15 +88,12 @@ void RealVM::SetTrace(bool enable)
 
 int RealVM::FindFunction(const char *func_name)
 {
-    for (int i = (int)functions_.size() - 1; i >= 1; i--)
-    {
-        Function *f = functions_[i];
+    std::unordered_map<std::string, int>::iterator iter = function_index_.find(func_name);
 
-        if (strcmp(f->name, func_name) == 0)
-            return i;
-    }
+    if (iter == function_index_.end())
+        return VM::NOT_FOUND;
 
-    return VM::NOT_FOUND;
+    return iter->second;
 }
 
 int RealVM::FindVariable(const char *var_name)
@@ -27,6 +27,8 @@
 
 #include <stdint.h>
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "coal.h"
@@ -410,6 +412,18 @@ class RealVM : public VM
     void SetVectorY(const char *mod_name, const char *var_name, double val);
     void SetVectorZ(const char *mod_name, const char *var_name, double val);
 
+    int BindFloat(const char *mod_name, const char *var_name);
+    int BindString(const char *mod_name, const char *var_name);
+    int BindVector(const char *mod_name, const char *var_name);
+
+    double      GetFloat(int var);
+    const char *GetString(int var);
+    double     *GetVector(int var);
+
+    void SetFloat(int var, double value);
+    void SetString(int var, const char *value);
+    void SetVector(int var, double val_1, double val_2, double val_3);
+
     int FindFunction(const char *name);
     int FindVariable(const char *name);
 
@@ -433,6 +447,9 @@ class RealVM : public VM
     std::vector<Function *>                 functions_;
     std::vector<RegisteredNativeFunction *> native_funcs_;
 
+    // function name -> index of the last function with that name
+    std::unordered_map<std::string, int> function_index_;
+
     Compiler  comp_;
     Execution exec_;
 
@@ -465,6 +482,8 @@ class RealVM : public VM
     Definition *DeclareDef(Type *type, char *name, Scope *scope);
     Definition *FindDef(Type *type, char *name, Scope *scope);
 
+    int BindVariable(Type *type, const char *mod_name, const char *var_name);
+
     void        StoreLiteral(int ofs);
     Definition *FindLiteral();
 
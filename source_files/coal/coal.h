@@ -75,6 +75,22 @@ class VM
     virtual void SetVectorY(const char *mod_name, const char *var_name, double val)                              = 0;
     virtual void SetVectorZ(const char *mod_name, const char *var_name, double val)                              = 0;
 
+    // Resolve a global variable once, so that it can be read or written
+    // every frame without a name lookup.  Returns NOT_FOUND when the module
+    // or variable does not exist; the accessors below ignore (Set) or fail
+    // on (Get) such a handle.
+    virtual int BindFloat(const char *mod_name, const char *var_name)  = 0;
+    virtual int BindString(const char *mod_name, const char *var_name) = 0;
+    virtual int BindVector(const char *mod_name, const char *var_name) = 0;
+
+    virtual double      GetFloat(int var)  = 0;
+    virtual const char *GetString(int var) = 0;
+    virtual double     *GetVector(int var) = 0;
+
+    virtual void SetFloat(int var, double value)                              = 0;
+    virtual void SetString(int var, const char *value)                        = 0;
+    virtual void SetVector(int var, double val_1, double val_2, double val_3) = 0;
+
     virtual int FindFunction(const char *name) = 0;
     virtual int FindVariable(const char *name) = 0;
 
@@ -658,14 +658,9 @@ AttackDefinition *AttackDefinitionContainer::Lookup(const char *refname)
     if (!refname || !refname[0])
         return nullptr;
 
-    for (std::vector<AttackDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        AttackDefinition *atk = *iter;
-        if (DDFCompareName(atk->name_.c_str(), refname) == 0)
-            return atk;
-    }
+    int idx = name_index_.Find(*this, refname, false);
 
-    return nullptr;
+    return (idx >= 0) ? at(idx) : nullptr;
 }
 
 //--- editor settings ---
@@ -26,6 +26,16 @@ class AttackDefinitionContainer : public std::vector<AttackDefinition *>
 
   public:
     AttackDefinition *Lookup(const char *refname);
+
+    // also drops the name index
+    void clear()
+    {
+        std::vector<AttackDefinition *>::clear();
+        name_index_.Clear();
+    }
+
+  private:
+    DDFNameIndex<AttackDefinition> name_index_;
 };
 
 extern AttackDefinitionContainer atkdefs; // -ACB- 2004/06/09 Implemented
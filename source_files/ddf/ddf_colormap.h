@@ -89,6 +89,22 @@ class ColormapContainer : public std::vector<Colormap *>
 
   public:
     Colormap *Lookup(const char *refname);
+
+    // these also drop the name index
+    void clear()
+    {
+        std::vector<Colormap *>::clear();
+        name_index_.Clear();
+    }
+
+    iterator erase(iterator pos)
+    {
+        name_index_.Clear();
+        return std::vector<Colormap *>::erase(pos);
+    }
+
+  private:
+    DDFNameIndex<Colormap> name_index_;
 };
 
 extern ColormapContainer colormaps; // -ACB- 2004/06/10 Implemented
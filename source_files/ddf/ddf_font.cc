@@ -304,14 +304,9 @@ FontDefinition *FontDefinitionContainer::Lookup(const char *refname)
     if (!refname || !refname[0])
         return nullptr;
 
-    for (std::vector<FontDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        FontDefinition *fnt = *iter;
-        if (DDFCompareName(fnt->name_.c_str(), refname) == 0)
-            return fnt;
-    }
+    int idx = name_index_.Find(*this, refname, false);
 
-    return nullptr;
+    return (idx >= 0) ? at(idx) : nullptr;
 }
 
 //
@@ -104,6 +104,16 @@ class FontDefinitionContainer : public std::vector<FontDefinition *>
   public:
     // Search Functions
     FontDefinition *Lookup(const char *refname);
+
+    // also drops the name index
+    void clear()
+    {
+        std::vector<FontDefinition *>::clear();
+        name_index_.Clear();
+    }
+
+  private:
+    DDFNameIndex<FontDefinition> name_index_;
 };
 
 extern FontDefinitionContainer fontdefs;
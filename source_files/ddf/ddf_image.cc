@@ -416,15 +416,10 @@ ImageDefinition *ImageDefinitionContainer::Lookup(const char *refname, ImageName
     if (!refname || !refname[0])
         return nullptr;
 
-    for (std::vector<ImageDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        ImageDefinition *g = *iter;
-
-        if (DDFCompareName(g->name_.c_str(), refname) == 0 && g->belong_ == belong)
-            return g;
-    }
+    int idx =
+        name_index_.Find(*this, refname, false, [belong](const ImageDefinition *g) { return g->belong_ == belong; });
 
-    return nullptr;
+    return (idx >= 0) ? at(idx) : nullptr;
 }
 
 //--- editor settings ---
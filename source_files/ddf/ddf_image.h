@@ -144,6 +144,16 @@ class ImageDefinitionContainer : public std::vector<ImageDefinition *>
   public:
     // Search Functions
     ImageDefinition *Lookup(const char *refname, ImageNamespace belong);
+
+    // also drops the name index
+    void clear()
+    {
+        std::vector<ImageDefinition *>::clear();
+        name_index_.Clear();
+    }
+
+  private:
+    DDFNameIndex<ImageDefinition> name_index_;
 };
 
 extern ImageDefinitionContainer imagedefs;
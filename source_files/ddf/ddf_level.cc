@@ -519,35 +519,30 @@ MapDefinition *MapDefinitionContainer::Lookup(const char *refname)
     if (!refname || !refname[0])
         return nullptr;
 
-    for (std::vector<MapDefinition *>::reverse_iterator iter = rbegin(), iter_end = rend(); iter != iter_end; iter++)
-    {
-        MapDefinition *m = *iter;
+    int idx = name_index_.Find(*this, refname, true);
 
-        // ignore maps with unknown episode_name
-        // if (! m->episode)
-        //	continue;
+    // Lobo 2022: Allow warping and IDCLEVing to arbitrarily
+    //  named maps. We have to have a levels.ddf entry AND an episode
+    //  so we need to create them on the fly if they are missing.
+    if (idx >= 0)
+    {
+        MapDefinition *m = at(idx);
 
-        // Lobo 2022: Allow warping and IDCLEVing to arbitrarily
-        //  named maps. We have to have a levels.ddf entry AND an episode
-        //  so we need to create them on the fly if they are missing.
-        if (DDFCompareName(m->name_.c_str(), refname) == 0)
+        // Invent a temp episode if we don't have one
+        if (m->episode_name_.empty())
         {
-            // Invent a temp episode if we don't have one
-            if (m->episode_name_.empty())
-            {
-                GameDefinition *temp_gamedef;
-
-                temp_gamedef        = new GameDefinition;
-                temp_gamedef->name_ = "TEMPEPI";
-                m->episode_name_    = temp_gamedef->name_;
-                m->episode_         = temp_gamedef;
-
-                // We must have a default sky
-                if (m->sky_.empty())
-                    m->sky_ = "SKY1";
-            }
-            return m;
+            GameDefinition *temp_gamedef;
+
+            temp_gamedef        = new GameDefinition;
+            temp_gamedef->name_ = "TEMPEPI";
+            m->episode_name_    = temp_gamedef->name_;
+            m->episode_         = temp_gamedef;
+
+            // We must have a default sky
+            if (m->sky_.empty())
+                m->sky_ = "SKY1";
         }
+        return m;
     }
 
     // If we're here then it is a map which has no corresponding
@@ -205,6 +205,16 @@ class MapDefinitionContainer : public std::vector<MapDefinition *>
 
   public:
     MapDefinition *Lookup(const char *name);
+
+    // also drops the name index
+    void clear()
+    {
+        std::vector<MapDefinition *>::clear();
+        name_index_.Clear();
+    }
+
+  private:
+    DDFNameIndex<MapDefinition> name_index_;
 };
 
 extern MapDefinitionContainer mapdefs; // -ACB- 2004/06/29 Implemented
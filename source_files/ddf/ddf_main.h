@@ -141,8 +141,6 @@ bool        DDFMainDecodeBrackets(const char *info, char *outer, char *inner, in
 const char *DDFMainDecodeList(const char *info, char divider, bool simple);
 void        DDFGetLumpNameForFile(const char *filename, char *lumpname);
 
-int DDFCompareName(const char *A, const char *B);
-
 void        DDFMainAddDefine(const char *name, const char *value);
 void        DDFMainAddDefine(const std::string &name, const std::string &value);
 const char *DDFMainGetDefine(const char *name);
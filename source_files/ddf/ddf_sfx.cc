@@ -62,6 +62,9 @@ static void SoundStartEntry(const char *name, bool extend)
 
     dynamic_sfx = sfxdefs.Lookup(name);
 
+    if (dynamic_sfx)
+        sfxdefs.ClearDEHIndex();
+
     if (extend)
     {
         if (!dynamic_sfx)
@@ -358,15 +361,9 @@ SoundEffect *SoundEffectDefinitionContainer::GetEffect(const char *name, bool er
 //
 SoundEffectDefinition *SoundEffectDefinitionContainer::Lookup(const char *name)
 {
-    for (std::vector<SoundEffectDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        SoundEffectDefinition *s = *iter;
-
-        if (DDFCompareName(s->name_.c_str(), name) == 0)
-            return s;
-    }
+    int idx = name_index_.Find(*this, name, false);
 
-    return nullptr;
+    return (idx >= 0) ? at(idx) : nullptr;
 }
 
 //
@@ -374,15 +371,19 @@ SoundEffectDefinition *SoundEffectDefinitionContainer::Lookup(const char *name)
 //
 SoundEffectDefinition *SoundEffectDefinitionContainer::DEHLookup(uint32_t id)
 {
-    for (std::vector<SoundEffectDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        SoundEffectDefinition *s = *iter;
+    if (total_deh_indexed_ > size())
+        ClearDEHIndex();
 
-        if (s->deh_sound_id_ == id)
-            return s;
-    }
+    // emplace keeps the first entry for each id
+    for (; total_deh_indexed_ < size(); total_deh_indexed_++)
+        deh_positions_.emplace(at(total_deh_indexed_)->deh_sound_id_, (int)total_deh_indexed_);
+
+    std::unordered_map<uint32_t, int>::iterator iter = deh_positions_.find(id);
+
+    if (iter == deh_positions_.end())
+        return nullptr;
 
-    return nullptr;
+    return at(iter->second);
 }
 
 //--- editor settings ---
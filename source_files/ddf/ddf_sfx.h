@@ -126,8 +126,30 @@ class SoundEffectDefinitionContainer : public std::vector<SoundEffectDefinition
     SoundEffectDefinition *Lookup(const char *name);
     SoundEffectDefinition *DEHLookup(uint32_t id);
 
+    // also drops the indexes
+    void clear()
+    {
+        std::vector<SoundEffectDefinition *>::clear();
+        name_index_.Clear();
+        ClearDEHIndex();
+    }
+
+    // must be called when an existing entry is redefined, as that may
+    // change its DEH_SOUND_ID
+    void ClearDEHIndex()
+    {
+        deh_positions_.clear();
+        total_deh_indexed_ = 0;
+    }
+
   private:
     std::vector<uint8_t *> dynamic_sound_effects_;
+
+    DDFNameIndex<SoundEffectDefinition> name_index_;
+
+    // DEH_SOUND_ID -> position of the first entry using it
+    std::unordered_map<uint32_t, int> deh_positions_;
+    size_t                            total_deh_indexed_ = 0;
 };
 
 // ----------EXTERNALISATIONS----------
@@ -572,14 +572,9 @@ StyleDefinition *StyleDefinitionContainer::Lookup(const char *refname)
     if (!refname || !refname[0])
         return nullptr;
 
-    for (std::vector<StyleDefinition *>::reverse_iterator iter = rbegin(), iter_end = rend(); iter != iter_end; iter++)
-    {
-        StyleDefinition *m = *iter;
-        if (DDFCompareName(m->name_.c_str(), refname) == 0)
-            return m;
-    }
+    int idx = name_index_.Find(*this, refname, true);
 
-    return nullptr;
+    return (idx >= 0) ? at(idx) : nullptr;
 }
 
 //--- editor settings ---
@@ -203,11 +203,21 @@ class StyleDefinitionContainer : public std::vector<StyleDefinition *>
     // Search Functions
     StyleDefinition *Lookup(const char *refname);
 
+    // also drops the name index
+    void clear()
+    {
+        std::vector<StyleDefinition *>::clear();
+        name_index_.Clear();
+    }
+
   public:
     // If false, always use DDFFONT based menu entries instead of patch
     // graphics; this is mostly for wadfixes or other EC-specific modifcations
     // for projects not targeting EC
     bool patch_menus_allowed_ = true;
+
+  private:
+    DDFNameIndex<StyleDefinition> name_index_;
 };
 
 extern StyleDefinitionContainer styledefs;
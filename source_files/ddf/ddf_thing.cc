@@ -585,6 +585,21 @@ int DDFCompareName(const char *A, const char *B)
     }
 }
 
+uint32_t DDFHashName(const char *name)
+{
+    uint32_t result = 2166136261U; // same FNV-like hash as epi::StringHash
+
+    for (; *name; name++)
+    {
+        if (*name == ' ' || *name == '_')
+            continue;
+
+        result = (result * 16777619) ^ (uint8_t)epi::ToUpperASCII(*name);
+    }
+
+    return result;
+}
+
 //
 //  DDF PARSE ROUTINES
 //
@@ -2813,7 +2828,6 @@ void MapObjectDefinition::DLightCompatibility(void)
 
 MapObjectDefinitionContainer::MapObjectDefinitionContainer()
 {
-    EPI_CLEAR_MEMORY(lookup_cache_, MapObjectDefinition *, kLookupCacheSize);
 }
 
 MapObjectDefinitionContainer::~MapObjectDefinitionContainer()
@@ -2832,6 +2846,9 @@ MapObjectDefinitionContainer::~MapObjectDefinitionContainer()
 
 int MapObjectDefinitionContainer::FindFirst(const char *name, size_t startpos)
 {
+    if (startpos == 0)
+        return name_index_.Find(*this, name, false);
+
     for (; startpos < size(); startpos++)
     {
         MapObjectDefinition *m = at(startpos);
@@ -2844,16 +2861,7 @@ int MapObjectDefinitionContainer::FindFirst(const char *name, size_t startpos)
 
 int MapObjectDefinitionContainer::FindLast(const char *name)
 {
-    int startpos = (int)size() - 1;
-
-    for (; startpos >= 0; startpos--)
-    {
-        MapObjectDefinition *m = at(startpos);
-        if (DDFCompareName(m->name_.c_str(), name) == 0)
-            return startpos;
-    }
-
-    return -1;
+    return name_index_.Find(*this, name, true);
 }
 
 bool MapObjectDefinitionContainer::MoveToEnd(int idx)
@@ -2865,6 +2873,9 @@ bool MapObjectDefinitionContainer::MoveToEnd(int idx)
     if (idx < 0 || (size_t)idx >= size())
         return false;
 
+    // the caller is about to redefine this entry, possibly renumbering it
+    ClearNumberIndex();
+
     if ((size_t)idx == (size() - 1))
         return true; // Already at the end
 
@@ -2875,9 +2886,17 @@ bool MapObjectDefinitionContainer::MoveToEnd(int idx)
 
     push_back(m);
 
+    name_index_.MoveToEnd(idx, (int)size());
+
     return true;
 }
 
+void MapObjectDefinitionContainer::ClearNumberIndex()
+{
+    number_positions_.clear();
+    total_numbers_indexed_ = 0;
+}
+
 const MapObjectDefinition *MapObjectDefinitionContainer::Lookup(const char *refname, bool allow_null)
 {
     // Looks an mobjdef by name.
@@ -2905,28 +2924,23 @@ const MapObjectDefinition *MapObjectDefinitionContainer::Lookup(int id)
     // Looks an mobjdef by number.
     // Fatal error if it does not exist.
 
-    int slot = (((id) + kLookupCacheSize) % kLookupCacheSize);
+    if (total_numbers_indexed_ > size())
+        ClearNumberIndex();
 
-    // check the cache
-    if (lookup_cache_[slot] && lookup_cache_[slot]->number_ == id)
-    {
-        return lookup_cache_[slot];
-    }
+    // later entries overwrite earlier ones with the same number
+    for (; total_numbers_indexed_ < size(); total_numbers_indexed_++)
+        number_positions_[at(total_numbers_indexed_)->number_] = (int)total_numbers_indexed_;
 
-    for (std::vector<MapObjectDefinition *>::reverse_iterator iter = rbegin(), iter_end = rend(); iter != iter_end;
-         iter++)
-    {
-        MapObjectDefinition *m = *iter;
+    std::unordered_map<int, int>::iterator iter = number_positions_.find(id);
 
-        if (m->number_ == id)
-        {
-            // update the cache
-            lookup_cache_[slot] = m;
-            return m;
-        }
-    }
+    if (iter == number_positions_.end())
+        return nullptr;
 
-    return nullptr;
+    MapObjectDefinition *m = at(iter->second);
+
+    EPI_ASSERT(m->number_ == id);
+
+    return m;
 }
 
 const MapObjectDefinition *MapObjectDefinitionContainer::LookupCastMember(int castpos)
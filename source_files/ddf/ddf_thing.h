@@ -941,12 +941,27 @@ class MapObjectDefinitionContainer : public std::vector<MapObjectDefinition *>
     ~MapObjectDefinitionContainer();
 
   private:
-    MapObjectDefinition *lookup_cache_[kLookupCacheSize];
+    DDFNameIndex<MapObjectDefinition> name_index_;
+
+    // thing number -> position of the last entry using it.  Only entries
+    // passed to MoveToEnd() can be renumbered, so that clears it.
+    std::unordered_map<int, int> number_positions_;
+    size_t                       total_numbers_indexed_ = 0;
+
+    void ClearNumberIndex();
 
   public:
     // List Management
     bool MoveToEnd(int idx);
 
+    // also drops the indexes
+    void clear()
+    {
+        std::vector<MapObjectDefinition *>::clear();
+        name_index_.Clear();
+        ClearNumberIndex();
+    }
+
     // Search Functions
     int                        FindFirst(const char *name, size_t startpos = 0);
     int                        FindLast(const char *name);
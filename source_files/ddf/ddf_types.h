@@ -26,6 +26,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "epi.h"
@@ -38,6 +39,86 @@ class WeaponDefinition;
 
 constexpr uint8_t kLookupCacheSize = 211; // Why this number? - Dasho
 
+// Compares DDF names, ignoring case, spaces and underscores.
+int DDFCompareName(const char *A, const char *B);
+
+// Hash of a DDF name which is equal for any names DDFCompareName() matches.
+uint32_t DDFHashName(const char *name);
+
+//
+// Name index kept alongside a definition container (a vector of pointers
+// to definitions with a name_ member).  Entries appended to the container
+// are picked up by the next search, anything which removes entries must
+// call Clear() and anything which moves one must call MoveToEnd().
+//
+template <typename T> class DDFNameIndex
+{
+  public:
+    void Clear()
+    {
+        positions_.clear();
+        total_indexed_ = 0;
+    }
+
+    // Position of the first (or last) entry called `name` which `accept`
+    // agrees with, or -1 when there is none.
+    template <typename Accept>
+    int Find(const std::vector<T *> &defs, const char *name, bool last, Accept accept)
+    {
+        if (total_indexed_ > defs.size())
+            Clear();
+
+        for (; total_indexed_ < defs.size(); total_indexed_++)
+            positions_.emplace(DDFHashName(defs[total_indexed_]->name_.c_str()), (int)total_indexed_);
+
+        int result = -1;
+
+        auto range = positions_.equal_range(DDFHashName(name));
+
+        for (auto iter = range.first; iter != range.second; iter++)
+        {
+            int pos = iter->second;
+
+            if (result >= 0 && (last ? pos < result : pos > result))
+                continue;
+
+            if (DDFCompareName(defs[pos]->name_.c_str(), name) == 0 && accept(defs[pos]))
+                result = pos;
+        }
+
+        return result;
+    }
+
+    int Find(const std::vector<T *> &defs, const char *name, bool last)
+    {
+        return Find(defs, name, last, [](const T *) { return true; });
+    }
+
+    // The entry at `pos` has been moved to the end of the container, and
+    // the ones after it shifted down by one.
+    void MoveToEnd(int pos, int total)
+    {
+        if (total_indexed_ != (size_t)total)
+        {
+            Clear();
+            return;
+        }
+
+        for (auto iter = positions_.begin(); iter != positions_.end(); iter++)
+        {
+            if (iter->second == pos)
+                iter->second = total - 1;
+            else if (iter->second > pos)
+                iter->second--;
+        }
+    }
+
+  private:
+    std::unordered_multimap<uint32_t, int> positions_;
+
+    size_t total_indexed_ = 0;
+};
+
 class MobjStringReference
 {
   public:
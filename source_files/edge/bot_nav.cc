@@ -21,7 +21,6 @@
 #include <algorithm>
 #include <forward_list>
 
-#include "AlmostEquals.h"
 #include "bot_think.h"
 #include "con_main.h"
 #include "ddf_main.h"
@@ -189,12 +188,14 @@ class nav_area_c
     float mid_x;
     float mid_y;
 
-    // info for A* path finding...
+    // info for A* path finding, only valid when `search` matches
+    // nav_search (the fields are reset on first use in each search).
 
-    bool  open   = false; // in the OPEN set?
-    int   parent = -1;    // parent nav_area_c / subsector_t
-    float G      = 0;     // cost of this node (from start node)
-    float H      = 0;     // estimated cost to reach end node
+    int   search   = 0;
+    int   heap_pos = -1;  // index in nav_open_heap, -1 if not in OPEN set
+    int   parent   = -1;  // parent nav_area_c / subsector_t
+    float G        = 0;   // cost of this node (from start node)
+    float H        = 0;   // estimated cost to reach end node
 
     nav_area_c(int _id) : id(_id)
     {
@@ -225,6 +226,15 @@ static std::vector<nav_link_c> nav_links;
 
 static Position nav_finish_mid;
 
+// the OPEN set, a binary heap of nav_areas indices ordered by F = G + H
+static std::vector<int> nav_open_heap;
+
+// bumped for every search, see nav_area_c::search
+static int nav_search = 0;
+
+// true for a Djikstra search (constant H), as used by BotFindThing
+static bool nav_constant_H = false;
+
 Position nav_area_c::get_middle() const
 {
     float z = level_subsectors[id].sector->floor_height;
@@ -497,29 +507,94 @@ static float BotEstimateH(const Subsector *cur_sub)
     return time * 1.25f;
 }
 
-static int BotLowestOpenF()
+static bool BotOpenLess(int a, int b)
 {
-    // return index of the nav_area_c which is in the OPEN set and has the
-    // lowest F value, where F = G + H.  returns -1 if OPEN set is empty.
+    // ties go to the lowest index, the same order the old linear search gave
+    float F_a = nav_areas[a].G + nav_areas[a].H;
+    float F_b = nav_areas[b].G + nav_areas[b].H;
 
-    // this is a brute force search -- consider OPTIMISING it...
+    if (F_a != F_b)
+        return F_a < F_b;
 
-    int   result = -1;
-    float best_F = 9e18;
+    return a < b;
+}
+
+static void BotHeapPlace(int pos, int idx)
+{
+    nav_open_heap[pos]      = idx;
+    nav_areas[idx].heap_pos = pos;
+}
 
-    for (int i = 0; i < (int)nav_areas.size(); i++)
+static void BotHeapUp(int pos)
+{
+    int idx = nav_open_heap[pos];
+
+    while (pos > 0)
     {
-        const nav_area_c &area = nav_areas[i];
+        int up = (pos - 1) / 2;
 
-        if (area.open)
-        {
-            float F = area.G + area.H;
-            if (F < best_F)
-            {
-                best_F = F;
-                result = i;
-            }
-        }
+        if (!BotOpenLess(idx, nav_open_heap[up]))
+            break;
+
+        BotHeapPlace(pos, nav_open_heap[up]);
+        pos = up;
+    }
+
+    BotHeapPlace(pos, idx);
+}
+
+static void BotHeapDown(int pos)
+{
+    int idx   = nav_open_heap[pos];
+    int total = (int)nav_open_heap.size();
+
+    for (;;)
+    {
+        int child = pos * 2 + 1;
+
+        if (child >= total)
+            break;
+
+        if (child + 1 < total && BotOpenLess(nav_open_heap[child + 1], nav_open_heap[child]))
+            child++;
+
+        if (!BotOpenLess(nav_open_heap[child], idx))
+            break;
+
+        BotHeapPlace(pos, nav_open_heap[child]);
+        pos = child;
+    }
+
+    BotHeapPlace(pos, idx);
+}
+
+static void BotBeginSearch(bool constant_H)
+{
+    nav_search++;
+    nav_constant_H = constant_H;
+
+    nav_open_heap.clear();
+}
+
+static int BotLowestOpenF()
+{
+    // remove and return index of the nav_area_c which is in the OPEN set
+    // and has the lowest F value, where F = G + H.  returns -1 if OPEN set
+    // is empty.
+
+    if (nav_open_heap.empty())
+        return -1;
+
+    int result = nav_open_heap[0];
+    int last   = nav_open_heap.back();
+
+    nav_open_heap.pop_back();
+    nav_areas[result].heap_pos = -1;
+
+    if (!nav_open_heap.empty())
+    {
+        BotHeapPlace(0, last);
+        BotHeapDown(0);
     }
 
     return result;
@@ -529,14 +604,28 @@ static void BotTryOpenArea(int idx, int parent, float cost)
 {
     nav_area_c &area = nav_areas[idx];
 
+    if (area.search != nav_search)
+    {
+        area.search   = nav_search;
+        area.heap_pos = -1;
+        area.parent   = -1;
+        area.G        = 9e19;
+        area.H        = nav_constant_H ? 1.0f : BotEstimateH(&level_subsectors[idx]);
+    }
+
     if (cost < area.G)
     {
-        area.open   = true;
         area.parent = parent;
         area.G      = cost;
 
-        if (AlmostEquals(area.H, 0.0f))
-            area.H = BotEstimateH(&level_subsectors[idx]);
+        // G only ever decreases, so the area can only move up the heap
+        if (area.heap_pos < 0)
+        {
+            nav_open_heap.push_back(idx);
+            area.heap_pos = (int)nav_open_heap.size() - 1;
+        }
+
+        BotHeapUp(area.heap_pos);
     }
 }
 
@@ -652,15 +741,7 @@ BotPath *BotFindPath(const Position *start, const Position *finish, int flags)
     // get coordinate of finish subsec
     nav_finish_mid = nav_areas[finish_id].get_middle();
 
-    // prepare all nodes
-    for (nav_area_c &area : nav_areas)
-    {
-        area.open   = false;
-        area.G      = 9e19;
-        area.H      = 0.0;
-        area.parent = -1;
-    }
-
+    BotBeginSearch(false);
     BotTryOpenArea(start_id, -1, 0);
 
     for (;;)
@@ -677,9 +758,8 @@ BotPath *BotFindPath(const Position *start, const Position *finish, int flags)
             return BotStorePath(*start, start_id, *finish, finish_id);
         }
 
-        // move current node to CLOSED set
+        // current node is now in the CLOSED set
         nav_area_c &area = nav_areas[cur];
-        area.open        = false;
 
         // visit each neighbor node
         for (int k = 0; k < area.num_links; k++)
@@ -746,15 +826,8 @@ BotPath *BotFindThing(DeathBot *bot, float radius, MapObject *&best)
     float best_score = 0;
     int   best_id    = -1;
 
-    // prepare all nodes
-    for (nav_area_c &area : nav_areas)
-    {
-        area.open   = false;
-        area.G      = 9e19;
-        area.H      = 1.0; // a constant gives a Djikstra search
-        area.parent = -1;
-    }
-
+    // a constant H gives a Djikstra search
+    BotBeginSearch(true);
     BotTryOpenArea(start_id, -1, 0);
 
     for (;;)
@@ -770,9 +843,8 @@ BotPath *BotFindThing(DeathBot *bot, float radius, MapObject *&best)
             return BotStorePath(pos, start_id, *best, best_id);
         }
 
-        // move current node to CLOSED set
+        // current node is now in the CLOSED set
         nav_area_c &area = nav_areas[cur];
-        area.open        = false;
 
         // visit the things
         BotItemsInSubsector(&level_subsectors[cur], bot, pos, radius, cur, best_id, best_score, best);
@@ -880,6 +952,8 @@ void BotAnalyseLevel()
 
     BotCollectBigItems();
     BotCreateLinks();
+
+    nav_open_heap.reserve(nav_areas.size());
 }
 
 void BotFreeLevel()
@@ -887,6 +961,7 @@ void BotFreeLevel()
     big_items.clear();
     nav_areas.clear();
     nav_links.clear();
+    nav_open_heap.clear();
 }
 
 //--- editor settings ---
@@ -34,6 +34,7 @@
 #include "dm_state.h"
 #include "e_input.h"
 #include "e_player.h"
+#include "e_profile.h"
 #include "epi.h"
 #include "epi_str_compare.h"
 #include "epi_str_util.h"
@@ -61,6 +62,8 @@ static constexpr uint8_t kConsoleWipeTics = 12;
 EDGE_DEFINE_CONSOLE_VARIABLE(debug_fps, "0", kConsoleVariableFlagArchive)
 EDGE_DEFINE_CONSOLE_VARIABLE(debug_position, "0", kConsoleVariableFlagArchive)
 
+extern ConsoleVariable debug_profile;
+
 static ConsoleVisibility console_visible;
 
 // stores the console toggle effect
@@ -1600,6 +1603,52 @@ void ConsoleShowFPS(void)
     FinishUnitBatch();
 }
 
+void ConsoleShowProfile(void)
+{
+    if (debug_profile.d_ <= 0)
+        return;
+
+    StartUnitBatch(false);
+
+    ConsoleSetupFont();
+
+    int chars = 32;
+    int lines = kTotalProfileZones + 1;
+
+    int x = 0;
+    int y = current_screen_height - FNSZ * (lines + 1);
+
+    SolidBox(x, y, XMUL * chars, FNSZ * (lines + 1), kRGBABlack, 0.5);
+
+    x += XMUL;
+    y = current_screen_height - FNSZ - FNSZ * (console_font->definition_->type_ == kFontTypeTrueType ? -0.5 : 0.5);
+
+    RendererVertex *console_glvert = StartText();
+    uint16_t        console_verts  = 0;
+
+    char textbuf[128];
+
+    // listed bottom to top, so the outermost zones end up above their children
+    for (int z = kTotalProfileZones - 1; z >= 0; z--)
+    {
+        ProfileZone zone = (ProfileZone)z;
+
+        int indent = HMM_MIN(ProfileZoneDepth(zone), 4) * 2;
+
+        stbsp_sprintf(textbuf, "%*s%-*s %6.2f %6.2f", indent, "", 16 - indent, ProfileZoneName(zone),
+                      ProfileZoneAverage(zone), ProfileZoneWorst(zone));
+
+        console_verts += AddText(x, y, textbuf, kRGBAWebGray, console_glvert);
+        y -= FNSZ;
+    }
+
+    stbsp_sprintf(textbuf, "%-16s %6s %6s", "zone (ms)", "avg", "max");
+    console_verts += AddText(x, y, textbuf, kRGBAWebGray, console_glvert);
+
+    EndRenderUnit(console_verts);
+    FinishUnitBatch();
+}
+
 void ConsoleShowPosition(void)
 {
     if (debug_position.d_ <= 0)
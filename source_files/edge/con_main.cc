@@ -26,6 +26,7 @@
 #include "ddf_sfx.h"
 #include "dm_state.h"
 #include "e_input.h"
+#include "e_profile.h"
 #include "epi_filesystem.h"
 #include "epi_str_compare.h"
 #include "epi_str_util.h"
@@ -37,6 +38,7 @@
 #include "r_misc.h"
 #include "s_sound.h"
 #include "stb_sprintf.h"
+#include "sv_chunk.h"
 #include "version.h"
 #include "w_files.h"
 #include "w_wad.h"
@@ -521,6 +523,75 @@ int ConsoleCommandScreenShot(char **argv, int argc)
     return 0;
 }
 
+int ConsoleCommandProfileTrace(char **argv, int argc)
+{
+    if (argc > 3)
+    {
+        ConsoleMessage(kConsoleOnly, "Usage: profiletrace [frames] [filename]\n");
+        return 1;
+    }
+
+    int frames = (argc >= 2) ? atoi(argv[1]) : 300;
+
+    if (frames <= 0)
+    {
+        ConsoleMessage(kConsoleOnly, "Frame count must be positive\n");
+        return 1;
+    }
+
+    ProfileStartTrace((argc >= 3) ? argv[2] : "profile_trace", frames);
+
+    return 0;
+}
+
+int ConsoleCommandRewind(char **argv, int argc)
+{
+    if (argc > 2)
+    {
+        ConsoleMessage(kConsoleOnly, "Usage: rewind [snapshots]\n");
+        return 1;
+    }
+
+    if (rewind_snapshots.d_ <= 0)
+    {
+        ConsoleMessage(kConsoleOnly, "Snapshots are disabled, see rewind_snapshots\n");
+        return 1;
+    }
+
+    int steps = (argc >= 2) ? atoi(argv[1]) : 1;
+
+    if (steps <= 0)
+    {
+        ConsoleMessage(kConsoleOnly, "Snapshot count must be positive\n");
+        return 1;
+    }
+
+    DeferredRewind(steps);
+
+    return 0;
+}
+
+int ConsoleCommandSaveBenchmark(char **argv, int argc)
+{
+    if (argc > 2)
+    {
+        ConsoleMessage(kConsoleOnly, "Usage: savebench [mobjs]\n");
+        return 1;
+    }
+
+    int mobjs = (argc >= 2) ? atoi(argv[1]) : 50000;
+
+    if (mobjs <= 0)
+    {
+        ConsoleMessage(kConsoleOnly, "Mobj count must be positive\n");
+        return 1;
+    }
+
+    SaveChunkBenchmark(mobjs);
+
+    return 0;
+}
+
 int ConsoleCommandQuitEDGE(char **argv, int argc)
 {
 #ifdef EDGE_WEB
@@ -809,10 +880,13 @@ const ConsoleCommand builtin_commands[] = {{"cat", ConsoleCommandType},
                                            {"map", ConsoleCommandMap},
                                            {"warp", ConsoleCommandMap}, // compatibility
                                            {"playsound", ConsoleCommandPlaySound},
+                                           {"profiletrace", ConsoleCommandProfileTrace},
                                            {"readme", ConsoleCommandReadme},
                                            {"browse", ConsoleCommandBrowse},
                                            {"pwd", ConsoleCommandPrintWorkingDir},
                                            {"resetvars", ConsoleCommandResetVars},
+                                           {"rewind", ConsoleCommandRewind},
+                                           {"savebench", ConsoleCommandSaveBenchmark},
                                            {"showfiles", ConsoleCommandShowFiles},
                                            {"showgamepads", ConsoleCommandShowGamepads},
                                            {"showcmds", ConsoleCommandShowCommands},
@@ -48,6 +48,7 @@
 #include "dm_state.h"
 #include "dstrings.h"
 #include "e_input.h"
+#include "e_profile.h"
 #include "epi_file.h"
 #include "epi_filesystem.h"
 #include "epi_sdl.h"
@@ -57,6 +58,7 @@
 #include "epi_windows.h"
 #include "f_finale.h"
 #include "f_interm.h"
+#include "g_demo.h"
 #include "g_game.h"
 #include "hu_draw.h"
 #include "hu_stuff.h"
@@ -118,6 +120,11 @@ static bool need_wipe = false;
 // Must be used in conjunction with single_tics.
 static int screenshot_rate;
 
+// -tics <n> : quit once this many game tics have been run (0 = no limit)
+static int tic_limit         = 0;
+static int tic_limit_count   = 0;
+static int tic_limit_started = 0;
+
 // For screenies...
 bool m_screenshot_required = false;
 bool need_save_screenshot  = false;
@@ -491,6 +498,17 @@ static void SetGlobalVariables(void)
 
     if (FindArgument("fliplevels") > 0)
         fliplevels = 1;
+
+    s = ArgumentValue("tics");
+    if (!s.empty())
+        tic_limit = HMM_MAX(0, atoi(s.c_str()));
+
+#ifdef EDGE_HEADLESS
+    // nothing is displayed or heard, so run the simulation flat out
+    single_tics = true;
+    no_sound    = true;
+    no_music    = true;
+#endif
 }
 
 //
@@ -651,10 +669,14 @@ void EdgeDisplay(void)
         {
         case kGameStateLevel:
             PaletteTicker();
-            if (LuaUseLuaHUD())
-                LuaRunHUD();
-            else
-                COALRunHUD();
+            {
+                ProfileScope profile_hud(kProfileZoneHUD);
+
+                if (LuaUseLuaHUD())
+                    LuaRunHUD();
+                else
+                    COALRunHUD();
+            }
             if (need_save_screenshot)
             {
                 // don't draw menu in save game shots
@@ -2095,6 +2117,8 @@ static void InitializeDDF(void)
 
 void EdgeShutdown(void)
 {
+    SaveShutdownWriter();
+    DemoStopRecording();
     StopMusic();
     StopAllSoundEffects();
     LevelShutdown();
@@ -2228,10 +2252,26 @@ static void InitialState(void)
     // do loadgames first, as they contain all of the
     // necessary state already (in the savegame).
 
-    if (FindArgument("playdemo") > 0 || FindArgument("timedemo") > 0 || FindArgument("record") > 0)
-    {
-        FatalError("Demos are no longer supported\n");
-    }
+    ps = ArgumentValue("timedemo");
+    if (!ps.empty() && DemoStartPlayback(ps, true, false))
+        return;
+
+    ps = ArgumentValue("fastdemo");
+    if (!ps.empty() && DemoStartPlayback(ps, true, true))
+        return;
+
+    ps = ArgumentValue("playdemo");
+#ifdef EDGE_HEADLESS
+    if (!ps.empty() && DemoStartPlayback(ps, true, true))
+        return;
+#else
+    if (!ps.empty() && DemoStartPlayback(ps, false, false))
+        return;
+#endif
+
+    ps = ArgumentValue("record");
+    if (!ps.empty())
+        DemoSetRecordName(ps);
 
     ps = ArgumentValue("loadgame");
     if (!ps.empty())
@@ -2289,6 +2329,9 @@ static void InitialState(void)
     // start the appropriate game based on parms
     if (!warp)
     {
+#ifdef EDGE_HEADLESS
+        FatalError("Headless mode needs one of -warp, -playdemo or -loadgame\n");
+#endif
         LogDebug("- Startup: showing title screen.\n");
         StartTitle();
         startup_progress.Clear();
@@ -2377,6 +2420,35 @@ void EdgeIdle(void)
     ReleaseAllKeys();
 }
 
+static void CheckTicLimit(void)
+{
+    if (tic_limit == 0 || game_state < kGameStateLevel)
+        return;
+
+    if (tic_limit_count++ == 0)
+        tic_limit_started = GetMilliseconds();
+
+    if (tic_limit_count < tic_limit)
+        return;
+
+    float seconds = HMM_MAX(1, GetMilliseconds() - tic_limit_started) / 1000.0f;
+
+    LogPrint("Tic limit: ran %d tics in %1.3f seconds (%1.1f tics/sec)\n", tic_limit_count, seconds,
+             tic_limit_count / seconds);
+
+    if (current_map && players[console_player])
+    {
+        Player *p = players[console_player];
+
+        LogPrint("Tic limit: %s kills %d/%d items %d/%d secrets %d/%d health %d\n", current_map->name_.c_str(),
+                 p->kill_count_, intermission_stats.kills, p->item_count_, intermission_stats.items,
+                 p->secret_count_, intermission_stats.secrets, (int)p->health_);
+    }
+
+    tic_limit = 0;
+    app_state = kApplicationPendingQuit;
+}
+
 //
 // This Function is called for a single loop in the system.
 //
@@ -2385,10 +2457,22 @@ void EdgeIdle(void)
 //
 void EdgeTicker(void)
 {
+    uint32_t frame_start = GetMicroseconds();
+
     DoBigGameStuff();
 
+#ifndef EDGE_HEADLESS
     // Update display, next frame, with current state.
-    EdgeDisplay();
+    if (!demo_skip_render)
+    {
+        uint32_t render_start = GetMicroseconds();
+        {
+            ProfileScope profile_display(kProfileZoneDisplay);
+            EdgeDisplay();
+        }
+        DemoAddTiming(kDemoTimingRender, render_start);
+    }
+#endif
 
     // this also runs the responder chain via ProcessInputEvents
     int counts = TryRunTicCommands();
@@ -2397,18 +2481,31 @@ void EdgeTicker(void)
     for (; counts > 0; counts--)
     {
         // run a step in the physics (etc)
-        GameTicker();
+        uint32_t section_start = GetMicroseconds();
+        {
+            ProfileScope profile_simulation(kProfileZoneSimulation);
+            GameTicker();
+        }
+        DemoAddTiming(kDemoTimingSimulation, section_start);
+
+        CheckTicLimit();
 
         // user interface stuff (skull anim, etc)
         MovieTicker();
         ConsoleTicker();
         MenuTicker();
+
+        section_start = GetMicroseconds();
         SoundTicker();
         MusicTicker();
+        DemoAddTiming(kDemoTimingAudio, section_start);
 
         // process mouse and keyboard events
         NetworkUpdate();
     }
+
+    DemoFrameFinished(frame_start);
+    ProfileFrameFinished();
 }
 
 //--- editor settings ---
@@ -0,0 +1,270 @@
+//----------------------------------------------------------------------------
+//  EDGE Subsystem Profiler
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "e_profile.h"
+
+#include <vector>
+
+#include "con_var.h"
+#include "dm_state.h"
+#include "epi.h"
+#include "epi_filesystem.h"
+#include "i_system.h"
+
+EDGE_DEFINE_CONSOLE_VARIABLE(debug_profile, "0", kConsoleVariableFlagNone)
+
+bool profile_active = false;
+
+static constexpr uint8_t kProfileMaximumDepth = 16;
+
+static const char *profile_zone_names[kTotalProfileZones] = {
+    "Simulation",    "PlayerThink", "ScriptTriggers", "Forces",   "Thinkers", "Lights",         "Planes", "Display",
+    "RenderTrueBSP", "BSPTraverse", "BSPWait",        "BSPStall", "Units",    "HUD (COAL/Lua)", "Sound"};
+
+struct ProfileStackEntry
+{
+    ProfileZone zone;
+    uint32_t    start;
+};
+
+static ProfileStackEntry profile_stack[kProfileMaximumDepth];
+static int               profile_depth = 0;
+
+// time spent in each zone during the current frame
+static uint32_t profile_frame_times[kTotalProfileZones];
+static int      profile_zone_depths[kTotalProfileZones];
+
+// accumulated over (roughly) one second
+static uint32_t profile_window_start  = 0;
+static uint32_t profile_window_frames = 0;
+static uint64_t profile_window_totals[kTotalProfileZones];
+static uint32_t profile_window_worst[kTotalProfileZones];
+
+// last computed values, shown by the overlay
+static float profile_average_shown[kTotalProfileZones];
+static float profile_worst_shown[kTotalProfileZones];
+
+//----------------------------------------------------------------------------
+//  TRACE CAPTURE
+//----------------------------------------------------------------------------
+
+struct ProfileTraceEvent
+{
+    uint8_t  zone; // kTotalProfileZones is used for the whole frame
+    uint32_t start;
+    uint32_t duration;
+};
+
+static std::vector<ProfileTraceEvent> trace_events;
+static std::string                    trace_filename;
+static int                            trace_frames_left = 0;
+static uint32_t                       trace_start       = 0;
+static uint32_t                       trace_frame_start = 0;
+
+void ProfileStartTrace(const std::string &filename, int frames)
+{
+    trace_filename = epi::PathAppendIfNotAbsolute(home_directory, filename);
+
+    if (epi::GetExtension(trace_filename).empty())
+        trace_filename += ".json";
+
+    trace_events.clear();
+    trace_events.reserve(frames * 32);
+
+    trace_frames_left = HMM_MAX(1, frames);
+    trace_start       = GetMicroseconds();
+    trace_frame_start = trace_start;
+
+    LogPrint("Profiler: capturing %d frames...\n", trace_frames_left);
+}
+
+static void ProfileWriteTrace(void)
+{
+    FILE *fp = epi::FileOpenRaw(trace_filename, epi::kFileAccessWrite);
+
+    if (!fp)
+    {
+        LogWarning("Profiler: unable to create trace file: %s\n", trace_filename.c_str());
+        return;
+    }
+
+    fprintf(fp, "{\"traceEvents\":[\n");
+
+    for (size_t i = 0; i < trace_events.size(); i++)
+    {
+        const ProfileTraceEvent &ev = trace_events[i];
+
+        const char *name = (ev.zone < kTotalProfileZones) ? profile_zone_names[ev.zone] : "Frame";
+
+        fprintf(fp, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%u,\"dur\":%u}%s\n", name, ev.start,
+                ev.duration, (i + 1 < trace_events.size()) ? "," : "");
+    }
+
+    fprintf(fp, "],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(fp);
+
+    LogPrint("Profiler: wrote %d events to %s\n", (int)trace_events.size(), trace_filename.c_str());
+
+    trace_events.clear();
+    trace_events.shrink_to_fit();
+}
+
+//----------------------------------------------------------------------------
+//  ZONES
+//----------------------------------------------------------------------------
+
+void ProfileBegin(ProfileZone zone)
+{
+    // deeper nesting is simply not recorded
+    if (profile_depth < kProfileMaximumDepth)
+    {
+        profile_stack[profile_depth].zone  = zone;
+        profile_stack[profile_depth].start = GetMicroseconds();
+
+        profile_zone_depths[zone] = profile_depth;
+    }
+
+    profile_depth++;
+}
+
+void ProfileEnd(ProfileZone zone)
+{
+    if (profile_depth == 0)
+        return;
+
+    profile_depth--;
+
+    if (profile_depth >= kProfileMaximumDepth)
+        return;
+
+    ProfileStackEntry &entry = profile_stack[profile_depth];
+
+    EPI_ASSERT(entry.zone == zone);
+
+    uint32_t now  = GetMicroseconds();
+    uint32_t diff = now - entry.start;
+
+    profile_frame_times[zone] += diff;
+
+    if (trace_frames_left > 0)
+    {
+        ProfileTraceEvent ev;
+
+        ev.zone     = zone;
+        ev.start    = entry.start - trace_start;
+        ev.duration = diff;
+
+        trace_events.push_back(ev);
+    }
+}
+
+void ProfileAddTime(ProfileZone zone, uint32_t microseconds)
+{
+    profile_frame_times[zone] += microseconds;
+    profile_zone_depths[zone] = profile_depth;
+}
+
+void ProfileFrameFinished(void)
+{
+    uint32_t now = GetMicroseconds();
+
+    if (profile_active)
+    {
+        profile_window_frames++;
+
+        for (int z = 0; z < kTotalProfileZones; z++)
+        {
+            profile_window_totals[z] += profile_frame_times[z];
+            profile_window_worst[z] = HMM_MAX(profile_window_worst[z], profile_frame_times[z]);
+        }
+
+        // update every second
+        if (now - profile_window_start > 999999)
+        {
+            for (int z = 0; z < kTotalProfileZones; z++)
+            {
+                profile_average_shown[z] =
+                    (double)profile_window_totals[z] / (double)(HMM_MAX(1U, profile_window_frames) * 1000);
+                profile_worst_shown[z] = (double)profile_window_worst[z] / 1000.0;
+
+                profile_window_totals[z] = 0;
+                profile_window_worst[z]  = 0;
+            }
+
+            profile_window_start  = now;
+            profile_window_frames = 0;
+        }
+    }
+
+    if (trace_frames_left > 0)
+    {
+        ProfileTraceEvent ev;
+
+        ev.zone     = kTotalProfileZones;
+        ev.start    = trace_frame_start - trace_start;
+        ev.duration = now - trace_frame_start;
+
+        trace_events.push_back(ev);
+
+        trace_frame_start = now;
+
+        if (--trace_frames_left == 0)
+            ProfileWriteTrace();
+    }
+
+    for (int z = 0; z < kTotalProfileZones; z++)
+        profile_frame_times[z] = 0;
+
+    bool was_active = profile_active;
+
+    profile_active = (debug_profile.d_ > 0 || trace_frames_left > 0);
+
+    if (profile_active && !was_active)
+    {
+        profile_depth         = 0;
+        profile_window_start  = now;
+        profile_window_frames = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+//  RESULTS
+//----------------------------------------------------------------------------
+
+const char *ProfileZoneName(ProfileZone zone)
+{
+    return profile_zone_names[zone];
+}
+
+float ProfileZoneAverage(ProfileZone zone)
+{
+    return profile_average_shown[zone];
+}
+
+float ProfileZoneWorst(ProfileZone zone)
+{
+    return profile_worst_shown[zone];
+}
+
+int ProfileZoneDepth(ProfileZone zone)
+{
+    return profile_zone_depths[zone];
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,99 @@
+//----------------------------------------------------------------------------
+//  EDGE Subsystem Profiler
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+//  Scoped timing zones for the main thread.  Zones nest, and the time
+//  spent in each one is accumulated per frame and averaged over one
+//  second for the "debug_profile" overlay.  The "profiletrace" console
+//  command additionally records every zone entry for a number of frames
+//  and writes them out as Chrome trace JSON (chrome://tracing, Perfetto).
+//
+//  Zones cost a single branch when neither of the above is active.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+enum ProfileZone
+{
+    kProfileZoneSimulation = 0,
+    kProfileZonePlayerThink,
+    kProfileZoneScriptTriggers,
+    kProfileZoneForces,
+    kProfileZoneThinkers,
+    kProfileZoneLights,
+    kProfileZonePlanes,
+    kProfileZoneDisplay,
+    kProfileZoneRenderTrueBSP,
+    kProfileZoneBSPTraverse,
+    kProfileZoneBSPWait,  // renderer waiting on the traversal thread
+    kProfileZoneBSPStall, // traversal thread waiting on the renderer
+    kProfileZoneRenderUnits,
+    kProfileZoneHUD,
+    kProfileZoneSound,
+    kTotalProfileZones
+};
+
+// true when the overlay is enabled or a trace is being captured
+extern bool profile_active;
+
+void ProfileBegin(ProfileZone zone);
+void ProfileEnd(ProfileZone zone);
+
+class ProfileScope
+{
+  public:
+    ProfileScope(ProfileZone zone) : zone_(zone), active_(profile_active)
+    {
+        if (active_)
+            ProfileBegin(zone_);
+    }
+
+    ~ProfileScope()
+    {
+        if (active_)
+            ProfileEnd(zone_);
+    }
+
+  private:
+    ProfileZone zone_;
+    bool        active_;
+};
+
+// Account time measured elsewhere (e.g. on another thread) to a zone,
+// at the current nesting depth.  Not recorded in traces.
+void ProfileAddTime(ProfileZone zone, uint32_t microseconds);
+
+// Called once per EdgeTicker() loop.
+void ProfileFrameFinished(void);
+
+// Capture the next `frames` frames and write them to `filename`
+// (relative to the home directory, ".json" appended if no extension).
+void ProfileStartTrace(const std::string &filename, int frames);
+
+// Results for the overlay: averages over the last second, in
+// milliseconds per frame, and the nesting depth the zone was last seen at.
+const char *ProfileZoneName(ProfileZone zone);
+float       ProfileZoneAverage(ProfileZone zone);
+float       ProfileZoneWorst(ProfileZone zone);
+int         ProfileZoneDepth(ProfileZone zone);
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
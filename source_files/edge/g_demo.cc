@@ -0,0 +1,621 @@
+//----------------------------------------------------------------------------
+//  EDGE Demo Recording and Playback
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+//  Demo file layout (all values little-endian):
+//
+//    "EDGEDEMO"  magic
+//    u8          version
+//    u8          skill, deathmatch
+//    u16 x 16    player flags (kPlayerFlagNoPlayer for empty slots)
+//    u64         RNG seed given to RandomStateWrite()
+//    flags x 2   global gameflags, then level gameflags after InitNew()
+//    string      map name
+//    u16         number of WAD files, then (filename, md5) string pairs
+//
+//  followed by one tic record per game tic:
+//
+//    u8          kDemoTicMarker
+//    11 bytes    ticcmd, for each active player in player number order
+//
+//  and finally kDemoEndMarker.
+//
+
+#include "g_demo.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "dm_state.h"
+#include "e_main.h"
+#include "e_player.h"
+#include "epi_filesystem.h"
+#include "g_game.h"
+#include "i_system.h"
+#include "w_files.h"
+#include "w_wad.h"
+
+static constexpr const char *kDemoMagic     = "EDGEDEMO";
+static constexpr uint8_t     kDemoVersion   = 1;
+static constexpr uint8_t     kDemoTicMarker = 0x01;
+static constexpr uint8_t     kDemoEndMarker = 0x80;
+static constexpr const char *kDemoExtension = ".edm";
+
+bool demo_recording   = false;
+bool demo_playback    = false;
+bool demo_timing      = false;
+bool demo_skip_render = false;
+
+static std::string demo_record_name;
+static FILE       *demo_record_file = nullptr;
+
+// the whole demo is read up front, so that disk access does not
+// show up in the -timedemo results.
+static uint8_t *demo_buffer     = nullptr;
+static int      demo_length     = 0;
+static int      demo_position   = 0;
+static bool     demo_overrun    = false;
+static bool     demo_game_ready = false;
+
+// user preferences, replaced by the demo's gameflags during playback
+static GameFlags saved_global_flags;
+
+// benchmark results
+static int                   demo_tics_run     = 0;
+static uint64_t              demo_elapsed_time = 0;
+static uint64_t              demo_section_times[kTotalDemoTimingSections];
+static std::vector<uint32_t> demo_frame_times;
+
+static const char *demo_section_names[kTotalDemoTimingSections] = {"simulation", "render", "audio"};
+
+static std::string DemoFilename(const std::string &name)
+{
+    std::string filename = epi::PathAppendIfNotAbsolute(home_directory, name);
+
+    if (epi::GetExtension(filename).empty())
+        filename += kDemoExtension;
+
+    return filename;
+}
+
+//----------------------------------------------------------------------------
+//  WRITING
+//----------------------------------------------------------------------------
+
+static void DemoPutByte(uint8_t value)
+{
+    fputc(value, demo_record_file);
+}
+
+static void DemoPutShort(uint16_t value)
+{
+    DemoPutByte(value & 0xFF);
+    DemoPutByte(value >> 8);
+}
+
+static void DemoPutInteger(uint32_t value)
+{
+    DemoPutShort(value & 0xFFFF);
+    DemoPutShort(value >> 16);
+}
+
+static void DemoPutString(const std::string &str)
+{
+    DemoPutShort((uint16_t)str.size());
+    fwrite(str.data(), 1, str.size(), demo_record_file);
+}
+
+static void DemoPutGameFlags(const GameFlags &flags)
+{
+    DemoPutByte(flags.no_monsters);
+    DemoPutByte(flags.fast_monsters);
+    DemoPutByte(flags.enemies_respawn);
+    DemoPutByte(flags.enemy_respawn_mode);
+    DemoPutByte(flags.items_respawn);
+    DemoPutByte(flags.true_3d_gameplay);
+    DemoPutByte(flags.menu_gravity_factor);
+    DemoPutByte(flags.more_blood);
+    DemoPutByte(flags.jump);
+    DemoPutByte(flags.crouch);
+    DemoPutByte(flags.mouselook);
+    DemoPutByte(flags.autoaim);
+    DemoPutByte(flags.cheats);
+    DemoPutByte(flags.have_extra);
+    DemoPutByte(flags.limit_zoom);
+    DemoPutByte(flags.kicking);
+    DemoPutByte(flags.weapon_switch);
+    DemoPutByte(flags.pass_missile);
+    DemoPutByte(flags.team_damage);
+}
+
+static void DemoPutTicCommand(const EventTicCommand *cmd)
+{
+    DemoPutShort(cmd->angle_turn);
+    DemoPutShort(cmd->mouselook_turn);
+    DemoPutByte(cmd->forward_move);
+    DemoPutByte(cmd->side_move);
+    DemoPutByte(cmd->upward_move);
+    DemoPutByte(cmd->buttons);
+    DemoPutShort(cmd->extended_buttons);
+    DemoPutByte(cmd->chat_character);
+}
+
+static void DemoPutFileList(void)
+{
+    std::vector<DataFile *> wads;
+
+    for (DataFile *df : data_files)
+    {
+        if (df->wad_)
+            wads.push_back(df);
+    }
+
+    DemoPutShort((uint16_t)wads.size());
+
+    for (DataFile *df : wads)
+    {
+        DemoPutString(epi::GetFilename(df->name_));
+        DemoPutString(GetWADFileMD5(df));
+    }
+}
+
+void DemoSetRecordName(const std::string &name)
+{
+    demo_record_name = name;
+}
+
+static void DemoBeginRecording(const NewGameParameters &params)
+{
+    std::string filename = DemoFilename(demo_record_name);
+
+    demo_record_name.clear();
+
+    demo_record_file = epi::FileOpenRaw(filename, epi::kFileAccessWrite | epi::kFileAccessBinary);
+
+    if (!demo_record_file)
+    {
+        LogWarning("Unable to create demo file: %s\n", filename.c_str());
+        return;
+    }
+
+    LogPrint("Recording demo: %s\n", filename.c_str());
+
+    fwrite(kDemoMagic, 1, strlen(kDemoMagic), demo_record_file);
+    DemoPutByte(kDemoVersion);
+
+    DemoPutByte(params.skill_);
+    DemoPutByte(params.deathmatch_);
+
+    for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+        DemoPutShort(params.players_[pnum]);
+
+    DemoPutInteger(params.random_seed_ & 0xFFFFFFFF);
+    DemoPutInteger(params.random_seed_ >> 32);
+
+    DemoPutGameFlags(global_flags);
+    DemoPutGameFlags(level_flags);
+
+    DemoPutString(params.map_->name_);
+
+    DemoPutFileList();
+
+    demo_recording = true;
+}
+
+void DemoStopRecording(void)
+{
+    if (!demo_recording)
+        return;
+
+    DemoPutByte(kDemoEndMarker);
+
+    fclose(demo_record_file);
+    demo_record_file = nullptr;
+
+    demo_recording = false;
+
+    LogPrint("Demo recording finished.\n");
+}
+
+//----------------------------------------------------------------------------
+//  READING
+//----------------------------------------------------------------------------
+
+static uint8_t DemoGetByte(void)
+{
+    if (demo_position >= demo_length)
+    {
+        demo_overrun = true;
+        return 0;
+    }
+
+    return demo_buffer[demo_position++];
+}
+
+static uint16_t DemoGetShort(void)
+{
+    uint16_t lo = DemoGetByte();
+    uint16_t hi = DemoGetByte();
+
+    return lo | (hi << 8);
+}
+
+static uint32_t DemoGetInteger(void)
+{
+    uint32_t lo = DemoGetShort();
+    uint32_t hi = DemoGetShort();
+
+    return lo | (hi << 16);
+}
+
+static std::string DemoGetString(void)
+{
+    int len = DemoGetShort();
+
+    if (demo_position + len > demo_length)
+    {
+        demo_overrun = true;
+        return "";
+    }
+
+    std::string str((const char *)demo_buffer + demo_position, len);
+
+    demo_position += len;
+
+    return str;
+}
+
+static void DemoGetGameFlags(GameFlags *flags)
+{
+    flags->no_monsters         = DemoGetByte() != 0;
+    flags->fast_monsters       = DemoGetByte() != 0;
+    flags->enemies_respawn     = DemoGetByte() != 0;
+    flags->enemy_respawn_mode  = DemoGetByte() != 0;
+    flags->items_respawn       = DemoGetByte() != 0;
+    flags->true_3d_gameplay    = DemoGetByte() != 0;
+    flags->menu_gravity_factor = DemoGetByte();
+    flags->more_blood          = DemoGetByte() != 0;
+    flags->jump                = DemoGetByte() != 0;
+    flags->crouch              = DemoGetByte() != 0;
+    flags->mouselook           = DemoGetByte() != 0;
+    flags->autoaim             = (AutoAimState)DemoGetByte();
+    flags->cheats              = DemoGetByte() != 0;
+    flags->have_extra          = DemoGetByte() != 0;
+    flags->limit_zoom          = DemoGetByte() != 0;
+    flags->kicking             = DemoGetByte() != 0;
+    flags->weapon_switch       = DemoGetByte() != 0;
+    flags->pass_missile        = DemoGetByte() != 0;
+    flags->team_damage         = DemoGetByte() != 0;
+}
+
+static void DemoGetTicCommand(EventTicCommand *cmd)
+{
+    cmd->angle_turn       = (int16_t)DemoGetShort();
+    cmd->mouselook_turn   = (int16_t)DemoGetShort();
+    cmd->forward_move     = (int8_t)DemoGetByte();
+    cmd->side_move        = (int8_t)DemoGetByte();
+    cmd->upward_move      = (int8_t)DemoGetByte();
+    cmd->buttons          = DemoGetByte();
+    cmd->extended_buttons = DemoGetShort();
+    cmd->chat_character   = DemoGetByte();
+}
+
+static void DemoCheckFileList(void)
+{
+    std::vector<DataFile *> wads;
+
+    for (DataFile *df : data_files)
+    {
+        if (df->wad_)
+            wads.push_back(df);
+    }
+
+    int  count    = DemoGetShort();
+    bool mismatch = (count != (int)wads.size());
+
+    for (int i = 0; i < count; i++)
+    {
+        std::string name = DemoGetString();
+        std::string md5  = DemoGetString();
+
+        if (i < (int)wads.size() && md5 != GetWADFileMD5(wads[i]))
+        {
+            LogWarning("Demo was recorded with %s (md5 %s)\n", name.c_str(), md5.c_str());
+            mismatch = true;
+        }
+    }
+
+    if (mismatch)
+        LogWarning("Demo was recorded with a different set of WADs, playback may desync.\n");
+}
+
+static void DemoFreeBuffer(void)
+{
+    delete[] demo_buffer;
+
+    demo_buffer   = nullptr;
+    demo_length   = 0;
+    demo_position = 0;
+}
+
+bool DemoStartPlayback(const std::string &name, bool timing, bool skip_render)
+{
+    std::string filename = DemoFilename(name);
+
+    epi::File *file = epi::FileOpen(filename, epi::kFileAccessRead | epi::kFileAccessBinary);
+
+    if (!file)
+    {
+        LogWarning("Unable to open demo file: %s\n", filename.c_str());
+        return false;
+    }
+
+    demo_length   = file->GetLength();
+    demo_buffer   = file->LoadIntoMemory();
+    demo_position = 0;
+    demo_overrun  = false;
+
+    delete file;
+
+    if (!demo_buffer || demo_length < (int)strlen(kDemoMagic) ||
+        memcmp(demo_buffer, kDemoMagic, strlen(kDemoMagic)) != 0)
+    {
+        LogWarning("Not an EDGE demo file: %s\n", filename.c_str());
+        DemoFreeBuffer();
+        return false;
+    }
+
+    demo_position = strlen(kDemoMagic);
+
+    int version = DemoGetByte();
+
+    if (version != kDemoVersion)
+    {
+        LogWarning("Demo %s has unsupported version %d\n", filename.c_str(), version);
+        DemoFreeBuffer();
+        return false;
+    }
+
+    NewGameParameters params;
+
+    params.skill_      = (SkillLevel)DemoGetByte();
+    params.deathmatch_ = DemoGetByte();
+
+    params.total_players_ = 0;
+
+    for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+    {
+        params.players_[pnum] = (PlayerFlag)DemoGetShort();
+
+        if (params.players_[pnum] != kPlayerFlagNoPlayer)
+            params.total_players_++;
+    }
+
+    uint64_t seed_lo    = DemoGetInteger();
+    uint64_t seed_hi    = DemoGetInteger();
+    params.random_seed_ = seed_lo | (seed_hi << 32);
+
+    GameFlags demo_global_flags;
+    GameFlags demo_level_flags;
+
+    DemoGetGameFlags(&demo_global_flags);
+    DemoGetGameFlags(&demo_level_flags);
+
+    std::string map_name = DemoGetString();
+
+    DemoCheckFileList();
+
+    if (demo_overrun)
+    {
+        LogWarning("Demo %s is truncated\n", filename.c_str());
+        DemoFreeBuffer();
+        return false;
+    }
+
+    params.map_ = LookupMap(map_name.c_str());
+
+    if (!params.map_)
+    {
+        LogWarning("Demo %s needs missing map %s\n", filename.c_str(), map_name.c_str());
+        DemoFreeBuffer();
+        return false;
+    }
+
+    params.CopyFlags(&demo_level_flags);
+    params.level_skip_ = true;
+
+    // LoadLevel_Bits() rebuilds level_flags from global_flags on each map
+    saved_global_flags = global_flags;
+    global_flags       = demo_global_flags;
+
+    LogPrint("Playing demo: %s\n", filename.c_str());
+
+    demo_playback    = true;
+    demo_timing      = timing;
+    demo_skip_render = skip_render;
+    demo_game_ready  = false;
+
+    demo_tics_run     = 0;
+    demo_elapsed_time = 0;
+    memset(demo_section_times, 0, sizeof(demo_section_times));
+    demo_frame_times.clear();
+
+    DeferredNewGame(params);
+
+    return true;
+}
+
+void DemoStopPlayback(void)
+{
+    if (!demo_playback)
+        return;
+
+    DemoFreeBuffer();
+
+    global_flags = saved_global_flags;
+
+    demo_playback    = false;
+    demo_timing      = false;
+    demo_skip_render = false;
+    demo_game_ready  = false;
+}
+
+void DemoNewGameStarted(const NewGameParameters &params)
+{
+    // a game started from the menu ends any recording or playback
+    if (demo_playback)
+    {
+        if (!demo_game_ready)
+        {
+            demo_game_ready = true;
+            return;
+        }
+
+        DemoStopPlayback();
+    }
+
+    DemoStopRecording();
+
+    if (!demo_record_name.empty())
+        DemoBeginRecording(params);
+}
+
+//----------------------------------------------------------------------------
+//  BENCHMARKING
+//----------------------------------------------------------------------------
+
+static double DemoFramePercentile(const std::vector<uint32_t> &sorted, int percent)
+{
+    size_t index = (sorted.size() - 1) * percent / 100;
+
+    return sorted[index] / 1000.0;
+}
+
+static void DemoPrintReport(void)
+{
+    double seconds = demo_elapsed_time / 1000000.0;
+
+    if (demo_tics_run == 0 || demo_frame_times.empty() || seconds <= 0)
+    {
+        LogPrint("Timedemo: no tics were run.\n");
+        return;
+    }
+
+    std::vector<uint32_t> sorted(demo_frame_times);
+    std::sort(sorted.begin(), sorted.end());
+
+    LogPrint("Timedemo: %d gametics in %d frames, %1.3f seconds\n", demo_tics_run, (int)sorted.size(), seconds);
+    LogPrint("Timedemo: %1.1f tics/sec, %1.1f frames/sec\n", demo_tics_run / seconds, sorted.size() / seconds);
+    LogPrint("Timedemo: frame ms: min %1.2f  50%% %1.2f  90%% %1.2f  99%% %1.2f  max %1.2f\n",
+             DemoFramePercentile(sorted, 0), DemoFramePercentile(sorted, 50), DemoFramePercentile(sorted, 90),
+             DemoFramePercentile(sorted, 99), DemoFramePercentile(sorted, 100));
+
+    for (int i = 0; i < kTotalDemoTimingSections; i++)
+    {
+        double total = demo_section_times[i] / 1000.0;
+
+        LogPrint("Timedemo: %-10s %9.1f ms total  %7.3f ms/tic  %5.1f%%\n", demo_section_names[i], total,
+                 total / demo_tics_run, 100.0 * demo_section_times[i] / demo_elapsed_time);
+    }
+}
+
+void DemoAddTiming(DemoTimingSection section, uint32_t start_microseconds)
+{
+    if (!demo_timing || demo_tics_run == 0)
+        return;
+
+    demo_section_times[section] += GetMicroseconds() - start_microseconds;
+}
+
+void DemoFrameFinished(uint32_t start_microseconds)
+{
+    if (!demo_timing || demo_tics_run == 0)
+        return;
+
+    uint32_t frame_time = GetMicroseconds() - start_microseconds;
+
+    demo_frame_times.push_back(frame_time);
+    demo_elapsed_time += frame_time;
+}
+
+static void DemoFinishPlayback(void)
+{
+    bool timing = demo_timing;
+
+    DemoStopPlayback();
+
+    LogPrint("Demo playback finished.\n");
+
+    if (timing)
+    {
+        DemoPrintReport();
+        app_state = kApplicationPendingQuit;
+    }
+    else
+    {
+        DeferredEndGame();
+    }
+}
+
+//----------------------------------------------------------------------------
+
+void DemoProcessTicCommands(void)
+{
+    if (demo_recording)
+    {
+        DemoPutByte(kDemoTicMarker);
+
+        for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+        {
+            if (players[pnum])
+                DemoPutTicCommand(&players[pnum]->command_);
+        }
+        return;
+    }
+
+    if (!demo_playback || !demo_game_ready)
+        return;
+
+    if (DemoGetByte() != kDemoTicMarker)
+    {
+        for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+        {
+            if (players[pnum])
+                memset(&players[pnum]->command_, 0, sizeof(EventTicCommand));
+        }
+
+        DemoFinishPlayback();
+        return;
+    }
+
+    for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+    {
+        Player *p = players[pnum];
+        if (!p)
+            continue;
+
+        DemoGetTicCommand(&p->command_);
+        p->command_.player_index = pnum;
+    }
+
+    demo_tics_run++;
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,78 @@
+//----------------------------------------------------------------------------
+//  EDGE Demo Recording and Playback
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+//  A demo is the list of ticcmds given to each player for every game tic,
+//  preceded by a header holding everything InitNew() needs to reproduce
+//  the same simulation (map, skill, players, gameflags and RNG seed).
+//
+//  -record  <name> : record the game started via -warp/-skill
+//  -playdemo <name> : play back at normal speed
+//  -timedemo <name> : play back as fast as possible, rendering every tic
+//  -fastdemo <name> : play back as fast as possible, without rendering
+//
+//  Both timing modes print a benchmark report and quit when the demo ends.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+class NewGameParameters;
+
+enum DemoTimingSection
+{
+    kDemoTimingSimulation = 0, // GameTicker
+    kDemoTimingRender,         // EdgeDisplay
+    kDemoTimingAudio,          // SoundTicker + MusicTicker
+    kTotalDemoTimingSections
+};
+
+extern bool demo_recording;
+extern bool demo_playback;
+
+// true for -timedemo and -fastdemo: run tics without waiting on the clock
+extern bool demo_timing;
+
+// true for -fastdemo: skip EdgeDisplay() entirely
+extern bool demo_skip_render;
+
+// Remember the -record filename; recording begins with the next new game.
+void DemoSetRecordName(const std::string &name);
+
+// Called by GameDoNewGame() once InitNew() has run.
+void DemoNewGameStarted(const NewGameParameters &params);
+
+// Reads the demo header and defers a new game using its parameters.
+// Returns false (after logging why) if the file is unusable.
+bool DemoStartPlayback(const std::string &name, bool timing, bool skip_render);
+
+void DemoStopRecording(void);
+void DemoStopPlayback(void);
+
+// Called by GrabTicCommands() after the players' ticcmds have been
+// fetched: records them, or replaces them with the demo's ticcmds.
+void DemoProcessTicCommands(void);
+
+// Benchmark accounting, only active while demo_timing is set.
+void DemoAddTiming(DemoTimingSection section, uint32_t start_microseconds);
+void DemoFrameFinished(uint32_t start_microseconds);
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -32,6 +32,7 @@
 #include "am_map.h"
 #include "bot_think.h"
 #include "con_main.h"
+#include "con_var.h"
 #include "dm_state.h"
 #include "dstrings.h"
 #include "e_input.h"
@@ -42,6 +43,7 @@
 #include "epi_str_util.h"
 #include "f_finale.h"
 #include "f_interm.h"
+#include "g_demo.h"
 #include "i_movie.h"
 #include "i_system.h"
 #include "m_cheat.h"
@@ -61,6 +63,7 @@
 #include "stb_sprintf.h"
 #include "sv_chunk.h"
 #include "sv_main.h"
+#include "sv_snapshot.h"
 #include "version.h"
 #include "vm_coal.h"
 #include "w_wad.h"
@@ -115,6 +118,16 @@ GameFlags level_flags;
 static int  defer_load_slot;
 static int  defer_save_slot;
 static char defer_save_description[32];
+static int  defer_rewind_steps;
+
+// The last game saved, kept in memory so that loading it again (e.g. a
+// quickload) needs no disk access.  Only valid while the "current"
+// directory still matches that slot.
+static std::vector<uint8_t> memory_save_image;
+static int                  memory_save_slot = -1;
+
+EDGE_DEFINE_CONSOLE_VARIABLE(rewind_snapshots, "0", kConsoleVariableFlagArchive)
+EDGE_DEFINE_CONSOLE_VARIABLE(rewind_interval, "35", kConsoleVariableFlagArchive)
 
 // deferred stuff...
 static NewGameParameters *defer_params = nullptr;
@@ -130,7 +143,17 @@ static void RespawnPlayer(Player *p);
 static void SpawnInitialPlayers(void);
 
 static bool GameLoadGameFromFile(const std::string &filename, bool is_hub = false);
-static bool GameSaveGameToFile(const std::string &filename, const char *description);
+static bool GameLoadGameFromMemory(const std::vector<uint8_t> &image);
+static bool GameSaveGameToFile(const std::string &filename, const char *description, int slot);
+static void GameSaveGameToMemory(std::vector<uint8_t> &image);
+static void GameDoRewind(void);
+
+static void ForgetMemorySave(void)
+{
+    memory_save_image.clear();
+    memory_save_image.shrink_to_fit();
+    memory_save_slot = -1;
+}
 
 static bool HandleLevelFlag(bool *special, MapFlag flag)
 {
@@ -328,7 +351,12 @@ void DoLoadLevel(void)
     HUDStart();
 
     if (current_hub_tag == 0)
+    {
         SaveClearSlot("current");
+        ForgetMemorySave();
+    }
+
+    SnapshotRingClear();
 
     if (current_hub_tag > 0)
     {
@@ -469,6 +497,8 @@ static void CheckPlayersReborn(void)
 
 void DoBigGameStuff(void)
 {
+    SaveWriterTicker();
+
     if (playing_movie)
         return;
 
@@ -496,6 +526,10 @@ void DoBigGameStuff(void)
             GameDoSaveGame();
             break;
 
+        case kGameActionRewind:
+            GameDoRewind();
+            break;
+
         case kGameActionIntermission:
             GameDoCompleted();
             break;
@@ -518,6 +552,26 @@ void DoBigGameStuff(void)
     }
 }
 
+static void TakeRewindSnapshot(void)
+{
+    // rewinding would break demos and net games
+    if (network_game || demo_recording || demo_playback)
+        return;
+
+    // e.g. the level is about to end
+    if (game_action != kGameActionNothing)
+        return;
+
+    if (level_time_elapsed % HMM_MAX(1, rewind_interval.d_) != 0)
+        return;
+
+    std::vector<uint8_t> image;
+
+    GameSaveGameToMemory(image);
+
+    SnapshotRingPush(image, level_time_elapsed, rewind_snapshots.d_);
+}
+
 void GameTicker(void)
 {
     if (playing_movie)
@@ -544,6 +598,9 @@ void GameTicker(void)
 
         // do player reborns if needed
         CheckPlayersReborn();
+
+        if (rewind_snapshots.d_ > 0)
+            TakeRewindSnapshot();
         break;
 
     case kGameStateIntermission:
@@ -732,7 +789,7 @@ static void GameDoCompleted(void)
 
                 std::string fn(SaveFilename("current", mapname));
 
-                if (!GameSaveGameToFile(fn, "__HUB_SAVE__"))
+                if (!GameSaveGameToFile(fn, "__HUB_SAVE__", -1))
                     FatalError("SAVE-HUB failed with filename: %s\n", fn.c_str());
 
                 if (!current_hub_first)
@@ -768,17 +825,15 @@ void DeferredLoadGame(int slot)
     game_action     = kGameActionLoadGame;
 }
 
-static bool GameLoadGameFromFile(const std::string &filename, bool is_hub)
+//
+// Loads the savegame opened by SaveFileOpenRead() or SaveMemoryOpenRead().
+// Snapshots in memory were made by us, so their CRC is not checked.
+//
+static bool GameLoadOpenedSave(bool is_hub, bool verify_contents)
 {
-    if (!SaveFileOpenRead(filename))
-    {
-        LogPrint("LOAD-GAME: cannot open %s\n", filename.c_str());
-        return false;
-    }
-
     int version;
 
-    if (!SaveFileVerifyHeader(&version) || !SaveFileVerifyContents())
+    if (!SaveFileVerifyHeader(&version) || (verify_contents && !SaveFileVerifyContents()))
     {
         LogPrint("LOAD-GAME: Savegame is corrupt !\n");
         SaveFileCloseRead();
@@ -879,6 +934,36 @@ static bool GameLoadGameFromFile(const std::string &filename, bool is_hub)
     return true; // OK
 }
 
+static bool GameLoadGameFromFile(const std::string &filename, bool is_hub)
+{
+    if (!SaveFileOpenRead(filename))
+    {
+        LogPrint("LOAD-GAME: cannot open %s\n", filename.c_str());
+        return false;
+    }
+
+    return GameLoadOpenedSave(is_hub, true);
+}
+
+static bool GameLoadGameFromMemory(const std::vector<uint8_t> &image)
+{
+    SaveMemoryOpenRead(image.data(), (int)image.size());
+
+    return GameLoadOpenedSave(false, false);
+}
+
+// common to loading a game and rewinding
+static void GameLoadFinished(void)
+{
+    HUDStart();
+
+    SetPalette(kPaletteNormal, 0);
+    if (LuaUseLuaHUD())
+        LuaLoadGame();
+    else
+        COALLoadGame();
+}
+
 //
 // REQUIRED STATE:
 //   (a) defer_load_slot
@@ -887,28 +972,74 @@ static bool GameLoadGameFromFile(const std::string &filename, bool is_hub)
 //
 static void GameDoLoadGame(void)
 {
+    DemoStopRecording();
+    DemoStopPlayback();
+
     ForceWipe();
 
     const char *dir_name = SaveSlotName(defer_load_slot);
     LogDebug("GameDoLoadGame : %s\n", dir_name);
 
-    SaveClearSlot("current");
-    SaveCopySlot(dir_name, "current");
+    SnapshotRingClear();
 
-    std::string fn(SaveFilename("current", "head"));
+    if (defer_load_slot == memory_save_slot && !memory_save_image.empty())
+    {
+        // "current" already holds this slot, and its head is in memory
+        if (!GameLoadGameFromMemory(memory_save_image))
+        {
+            // !!! FIXME: what to do?
+        }
+    }
+    else
+    {
+        ForgetMemorySave();
+
+        SaveClearSlot("current");
+        SaveCopySlot(dir_name, "current");
+
+        std::string fn(SaveFilename("current", "head"));
 
-    if (!GameLoadGameFromFile(fn))
+        if (!GameLoadGameFromFile(fn))
+        {
+            // !!! FIXME: what to do?
+        }
+    }
+
+    GameLoadFinished();
+}
+
+//
+// REQUIRED STATE:
+//   (a) defer_rewind_steps
+//
+static void GameDoRewind(void)
+{
+    if (game_state != kGameStateLevel || network_game || demo_recording || demo_playback)
+        return;
+
+    std::vector<uint8_t> image;
+    int                  level_time;
+
+    if (!SnapshotRingRestore(defer_rewind_steps, image, &level_time))
     {
-        // !!! FIXME: what to do?
+        ConsoleMessage(kConsoleOnly, "Cannot rewind %d step(s), %d snapshot(s) kept\n", defer_rewind_steps,
+                       SnapshotRingSize());
+        return;
     }
 
-    HUDStart();
+    if (!GameLoadGameFromMemory(image))
+        return;
 
-    SetPalette(kPaletteNormal, 0);
-    if (LuaUseLuaHUD())
-        LuaLoadGame();
-    else
-        COALLoadGame();
+    GameLoadFinished();
+
+    ConsoleMessage(kConsoleOnly, "Rewound to %d:%02d\n", level_time / (60 * kTicRate),
+                   (level_time / kTicRate) % 60);
+}
+
+void DeferredRewind(int steps)
+{
+    defer_rewind_steps = steps;
+    game_action        = kGameActionRewind;
 }
 
 //
@@ -925,13 +1056,18 @@ void DeferredSaveGame(int slot, const char *description)
     game_action = kGameActionSaveGame;
 }
 
-static bool GameSaveGameToFile(const std::string &filename, const char *description)
+//
+// The game state is captured here, while compressing and writing the file
+// happen in the background.  For a normal save, `slot_name` is the slot
+// which receives a copy of the "current" directory afterwards.  Hub saves
+// pass nullptr, and since the level cannot be entered again without them,
+// failing to write one is fatal.
+//
+static bool GameWriteSave(const std::string &filename, const char *description, bool snapshot)
 {
     time_t cur_time;
     char   timebuf[100];
 
-    epi::FileDelete(filename);
-
     if (!SaveFileOpenWrite(filename, 0xEC))
     {
         LogPrint("Unable to create savegame file: %s\n", filename.c_str());
@@ -977,7 +1113,7 @@ static bool GameSaveGameToFile(const std::string &filename, const char *descript
     globs->mapthing.count  = total_map_things;
     globs->mapthing.crc    = map_things_crc.GetCRC();
 
-    BeginSaveGameSave();
+    BeginSaveGameSave(snapshot);
 
     SaveGlobalsSave(globs);
     SaveAllSaveChunks();
@@ -985,13 +1121,75 @@ static bool GameSaveGameToFile(const std::string &filename, const char *descript
     SaveGlobalsFree(globs);
 
     FinishSaveGameSave();
-    SaveFileCloseWrite();
 
-    epi::SyncFilesystem();
+    return true; // OK
+}
+
+// a slot save in flight, which becomes the memory save once written
+struct PendingMemorySave
+{
+    int                  slot;
+    int                  generation;
+    std::vector<uint8_t> image;
+};
+
+// bumped for every save written into "current"
+static int current_save_generation = 0;
+
+static void MemorySaveWritten(bool ok, void *data)
+{
+    PendingMemorySave *pending = (PendingMemorySave *)data;
+
+    // unless a later save has been written into "current" since
+    if (ok && pending->generation == current_save_generation)
+    {
+        memory_save_image.swap(pending->image);
+        memory_save_slot = pending->slot;
+    }
+
+    delete pending;
+}
+
+static bool GameSaveGameToFile(const std::string &filename, const char *description, int slot)
+{
+    if (!GameWriteSave(filename, description, false))
+        return false;
+
+    SavePendingFile *file = SaveFileFinishWrite();
+
+    // "current" no longer matches the memory save
+    ForgetMemorySave();
+    current_save_generation++;
+
+    if (slot >= 0)
+    {
+        PendingMemorySave *pending = new PendingMemorySave;
+
+        pending->slot       = slot;
+        pending->generation = current_save_generation;
+
+        SavePendingFileImage(file, pending->image);
+
+        SaveQueueWrite(file, SaveSlotName(slot), language["GameSaved"], false, MemorySaveWritten, pending);
+    }
+    else
+        SaveQueueWrite(file, nullptr, nullptr, true);
 
     return true; // OK
 }
 
+// Rewind snapshots: no script hooks and no clearing of stale references,
+// so taking one does not change the game.
+static void GameSaveGameToMemory(std::vector<uint8_t> &image)
+{
+    GameWriteSave("", "__SNAPSHOT__", true);
+
+    SavePendingFile *file = SaveFileFinishWrite();
+
+    SavePendingFileImage(file, image);
+    SavePendingFileFree(file);
+}
+
 static void GameDoSaveGame(void)
 {
     if (LuaUseLuaHUD())
@@ -1001,16 +1199,8 @@ static void GameDoSaveGame(void)
 
     std::string fn(SaveFilename("current", "head"));
 
-    if (GameSaveGameToFile(fn, defer_save_description))
-    {
-        const char *dir_name = SaveSlotName(defer_save_slot);
-
-        SaveClearSlot(dir_name);
-        SaveCopySlot("current", dir_name);
-
-        ConsoleMessage(kConsoleOnly, "%s", language["GameSaved"]);
-    }
-    else
+    // the slot is filled, and "GameSaved" shown, once the file is written
+    if (!GameSaveGameToFile(fn, defer_save_description, defer_save_slot))
     {
         // !!! FIXME: what to do?
     }
@@ -1120,8 +1310,13 @@ static void GameDoNewGame(void)
     SaveClearSlot("current");
     quicksave_slot = -1;
 
+    ForgetMemorySave();
+    SnapshotRingClear();
+
     InitNew(*defer_params);
 
+    DemoNewGameStarted(*defer_params);
+
     bool skip_pre = defer_params->level_skip_;
 
     delete defer_params;
@@ -1233,10 +1428,16 @@ void DeferredEndGame(void)
 //
 static void GameDoEndGame(void)
 {
+    DemoStopRecording();
+    DemoStopPlayback();
+
     DestroyAllPlayers();
 
     SaveClearSlot("current");
 
+    ForgetMemorySave();
+    SnapshotRingClear();
+
     if (game_state == kGameStateLevel)
     {
         BotEndLevel();
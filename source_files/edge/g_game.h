@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "con_var.h"
 #include "dm_defs.h"
 #include "e_event.h"
 #include "e_player.h"
@@ -34,6 +35,10 @@ extern int  random_seed;
 extern int  exit_time; // for savegame code
 extern int  key_show_players;
 
+// number of snapshots kept for "rewind" (0 = off), and tics between them
+extern ConsoleVariable rewind_snapshots;
+extern ConsoleVariable rewind_interval;
+
 // -KM- 1998/11/25 Added support for finales before levels
 enum GameAction
 {
@@ -44,7 +49,8 @@ enum GameAction
     kGameActionSaveGame,
     kGameActionIntermission,
     kGameActionFinale,
-    kGameActionEndGame
+    kGameActionEndGame,
+    kGameActionRewind
 };
 
 extern GameAction game_action;
@@ -53,6 +59,7 @@ extern GameAction game_action;
 //    kGameActionNewGame     : defer_params
 //    kGameActionLoadGame    : defer_load_slot
 //    kGameActionSaveGame    : defer_save_slot, defer_save_description
+//    kGameActionRewind      : defer_rewind_steps
 //
 //    kGameActionLoadLevel   : current_map, players, game_skill+dm+level_flags
 //    ETC kGameActionIntermission: current_map, next_map, players,
@@ -106,6 +113,9 @@ void DeferredSaveGame(int slot, const char *description);
 void DeferredScreenShot(void);
 void DeferredEndGame(void);
 
+// Go back to the snapshot `steps` back (1 = newest), see "rewind_snapshots".
+void DeferredRewind(int steps);
+
 bool MapExists(const MapDefinition *map);
 
 // -KM- 1998/11/25 Added Time param
@@ -133,6 +133,7 @@ void HUDDrawer(void)
 {
     ConsoleShowFPS();
     ConsoleShowPosition();
+    ConsoleShowProfile();
 
     short y = 0;
     if (!queued_messages.empty())
@@ -145,6 +145,19 @@ void DeterminePixelAspect()
 
 void StartupGraphics(void)
 {
+#ifdef EDGE_HEADLESS
+    // No display at all; the requested resolution is simply accepted and
+    // the dummy Sokol backend discards everything drawn to it.
+    desktop_resolution_width  = current_screen_width;
+    desktop_resolution_height = current_screen_height;
+
+    borderless_mode.window_mode = kWindowModeBorderless;
+    borderless_mode.width       = current_screen_width;
+    borderless_mode.height      = current_screen_height;
+    borderless_mode.depth       = current_screen_depth;
+
+    LogPrint("StartupGraphics: headless, no video initialised\n");
+#else
     std::string driver = ArgumentValue("videodriver");
 
     if (driver.empty())
@@ -253,10 +266,14 @@ void StartupGraphics(void)
     borderless_mode.depth       = SDL_BITSPERPIXEL(info.format);
 
     LogPrint("StartupGraphics: initialisation OK\n");
+#endif
 }
 
 static bool InitializeWindow(DisplayMode *mode)
 {
+#ifdef EDGE_HEADLESS
+    EPI_UNUSED(mode);
+#else
     std::string temp_title = window_title.s_;
     temp_title.append(" ").append(edge_version.s_);
 
@@ -330,6 +347,7 @@ static bool InitializeWindow(DisplayMode *mode)
 
     if (SDL_GL_ExtensionSupported("GL_ARB_texture_non_power_of_two") != SDL_TRUE)
         FatalError("System GL implementation does not support non-power-of-two textures!\n");
+#endif
 #endif
 
     return true;
@@ -388,7 +406,7 @@ bool SetScreenSize(DisplayMode *mode)
     render_state->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 #endif
 
-#ifndef SOKOL_D3D11
+#if !defined(SOKOL_D3D11) && !defined(EDGE_HEADLESS)
     SDL_GL_SwapWindow(program_window);
 #endif
 
@@ -414,7 +432,7 @@ static void SwapBuffers(void)
 {
     render_backend->SwapBuffers();
 
-#ifndef SOKOL_D3D11
+#if !defined(SOKOL_D3D11) && !defined(EDGE_HEADLESS)
     // move me and other SDL_GL to backend
     SDL_GL_SwapWindow(program_window);
 #endif
@@ -471,7 +489,7 @@ void FinishFrame(void)
     {
         if (vsync.d_ == 2)
         {
-#ifndef SOKOL_D3D11
+#if !defined(SOKOL_D3D11) && !defined(EDGE_HEADLESS)
             // Fallback to normal VSync if Adaptive doesn't work
             if (SDL_GL_SetSwapInterval(-1) == -1)
             {
@@ -482,7 +500,7 @@ void FinishFrame(void)
         }
         else
         {
-#ifndef SOKOL_D3D11
+#if !defined(SOKOL_D3D11) && !defined(EDGE_HEADLESS)
             SDL_GL_SetSwapInterval(vsync.d_);
 #endif
         }
@@ -520,7 +538,9 @@ void ShutdownGraphics(void)
         delete mode;
     }
 
+#ifndef EDGE_HEADLESS
     SDL_QuitSubSystem(SDL_INIT_VIDEO);
+#endif
 }
 
 //--- editor settings ---
@@ -757,21 +757,16 @@ RGBAColor ImageData::DarkestColor(int from_x, int to_x, int from_y, int to_y)
     return epi::MakeRGBA(darkest_r, darkest_g, darkest_b);
 }
 
-void ImageData::Swirl(int leveltime, int thickness)
+void ImageData::Swirl(int frame)
 {
     const int swirlfactor  = 8192 / 64;
     const int swirlfactor2 = 8192 / 32;
     const int amp          = 2;
-    int       speed;
 
-    if (thickness == 1) // Thin liquid
-    {
-        speed = 40;
-    }
-    else
-    {
-        speed = 10;
-    }
+    // Each term advances by a whole multiple of (8192 / kSwirlCycleFrames)
+    // per frame, so the whole pattern is periodic over kSwirlCycleFrames.
+    // The multipliers are the nearest ones to SMMU's original speeds.
+    const int step = (8192 / kSwirlCycleFrames) * frame;
 
     uint8_t *new_pixels_ = new uint8_t[width_ * height_ * depth_];
 
@@ -785,12 +780,12 @@ void ImageData::Swirl(int leveltime, int thickness)
             int x1, y1;
             int sinvalue, sinvalue2;
 
-            sinvalue  = (y * swirlfactor + leveltime * speed * 5 + 900) & 8191;
-            sinvalue2 = (x * swirlfactor2 + leveltime * speed * 4 + 300) & 8191;
+            sinvalue  = (y * swirlfactor + step * 6 + 900) & 8191;
+            sinvalue2 = (x * swirlfactor2 + step * 5 + 300) & 8191;
             x1        = x + width_ + height_ + ((finesine[sinvalue] * amp) >> 16) + ((finesine[sinvalue2] * amp) >> 16);
 
-            sinvalue  = (x * swirlfactor + leveltime * speed * 3 + 700) & 8191;
-            sinvalue2 = (y * swirlfactor2 + leveltime * speed * 4 + 1200) & 8191;
+            sinvalue  = (x * swirlfactor + step * 4 + 700) & 8191;
+            sinvalue2 = (y * swirlfactor2 + step * 5 + 1200) & 8191;
             y1        = y + width_ + height_ + ((finesine[sinvalue] * amp) >> 16) + ((finesine[sinvalue2] * amp) >> 16);
 
             x1 &= width_ - 1;
@@ -22,6 +22,10 @@
 
 #include "epi_color.h"
 
+// The SMMU swirl repeats after this many frames, so every frame of it
+// only ever needs to be built once.
+constexpr int kSwirlCycleFrames = 128;
+
 class ImageData
 {
   public:
@@ -139,8 +143,8 @@ class ImageData
     // compute the darkest color in the RGB image
     RGBAColor DarkestColor(int from_x = -1, int to_x = 1000000, int from_y = -1, int to_y = 1000000);
 
-    // SMMU-style swirling
-    void Swirl(int level_time, int thickness);
+    // SMMU-style swirling, frame is 0 .. kSwirlCycleFrames-1
+    void Swirl(int frame);
 
     // Change various HSV color values if needed
     void SetHSV(int rotation, int saturation, int value);
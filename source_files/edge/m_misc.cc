@@ -65,6 +65,7 @@
 #include "s_blit.h"
 #include "s_sound.h"
 #include "stb_sprintf.h"
+#include "sv_main.h"
 #include "version.h"
 //
 // DEFAULTS
@@ -459,6 +460,9 @@ void CreateSaveScreenshot(void)
         std::string temp(epi::StringFormat("%s/%s.png", "current", "head"));
         std::string filename = epi::PathAppend(save_directory, temp);
 
+        // an earlier save may still be copying "current"
+        SaveWaitForWrites();
+
         epi::FileDelete(filename);
 
         ImageData *img = new ImageData(current_screen_width, current_screen_height, 4);
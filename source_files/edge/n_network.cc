@@ -22,7 +22,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "coal.h"
 #include "ddf_types.h"
 #include "dm_state.h"
 #include "e_input.h"
@@ -31,6 +30,7 @@
 #include "epi_endian.h"
 #include "epi_str_util.h"
 #include "epi_windows.h"
+#include "g_demo.h"
 #include "g_game.h"
 #include "i_system.h"
 #include "m_argv.h"
@@ -38,9 +38,6 @@
 #include "script/compat/lua_compat.h"
 #include "vm_coal.h"
 
-extern coal::VM *ui_vm;
-extern void      COALSetFloat(coal::VM *vm, const char *mod_name, const char *var_name, double value);
-
 // only true if packets are exchanged with a server
 bool network_game = false;
 
@@ -121,7 +118,8 @@ static bool NetworkBuildTicCommands(void)
     if (make_tic >= game_tic + kBackupTics)
         return false;
 
-    for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+    // demo playback supplies the ticcmds itself (in GrabTicCommands)
+    for (int pnum = 0; pnum < kMaximumPlayers && !demo_playback; pnum++)
     {
         Player *p = players[pnum];
         if (!p)
@@ -165,10 +163,12 @@ void GrabTicCommands(void)
         memcpy(&p->command_, p->input_commands_ + buf, sizeof(EventTicCommand));
     }
 
+    DemoProcessTicCommands();
+
     if (LuaUseLuaHUD())
         LuaSetFloat(LuaGetGlobalVM(), "sys", "gametic", game_tic);
     else
-        COALSetFloat(ui_vm, "sys", "gametic", game_tic);
+        COALSetFloat(kCOALVariableGameTic, game_tic);
 
     game_tic++;
 }
@@ -208,7 +208,8 @@ int NetworkUpdate()
 
 int TryRunTicCommands()
 {
-    if (single_tics)
+    // -timedemo and -fastdemo run one tic per frame, as fast as possible
+    if (single_tics || demo_timing)
     {
         PreInput();
         NetworkBuildTicCommands();
@@ -213,6 +213,7 @@ bool       SolidSectorMove(Sector *sec, bool is_ceiling, float dh, int crush = 1
 bool       CheckAbsolutePosition(MapObject *thing, float x, float y, float z);
 bool       CheckSight(MapObject *src, MapObject *dest);
 bool       CheckSightToPoint(MapObject *src, float x, float y, float z);
+void       CreateSightTable(int reject_lump);
 bool       QuickVerticalSightCheck(MapObject *src, MapObject *dest);
 void       RadiusAttack(MapObject *spot, MapObject *source, float radius, float damage, const DamageClass *damtype,
                         bool thrust_only);
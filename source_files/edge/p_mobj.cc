@@ -52,6 +52,7 @@
 #include "p_mobj.h"
 
 #include <list>
+#include <vector>
 
 #include "AlmostEquals.h"
 #include "con_main.h"
@@ -143,16 +144,76 @@ static void AddItemToQueue(const MapObject *mo)
     }
 }
 
+//
+// Map objects are carved out of large slabs instead of being malloc'd one
+// at a time, so that walking map_object_list_head mostly touches adjacent
+// memory.  Deleted objects go onto a free list and are reused first.
+// The slabs themselves are released once every object is gone (i.e. when
+// a level is unloaded).
+//
+union MapObjectSlot
+{
+    MapObjectSlot *next_free;
+    alignas(MapObject) uint8_t storage[sizeof(MapObject)];
+};
+
+static constexpr int kMapObjectSlabSize = 512;
+
+static std::vector<MapObjectSlot *> map_object_slabs;
+static MapObjectSlot               *map_object_free_list = nullptr;
+static int                          map_object_slab_used = 0;
+static int                          map_objects_live     = 0;
+
 MapObject *MapObject::Allocate()
 {
-    void *buffer = malloc(sizeof(MapObject));
-    return new (buffer) MapObject();
+    MapObjectSlot *slot = map_object_free_list;
+
+    if (slot != nullptr)
+    {
+        map_object_free_list = slot->next_free;
+    }
+    else
+    {
+        if (map_object_slabs.empty() || map_object_slab_used == kMapObjectSlabSize)
+        {
+            MapObjectSlot *slab = (MapObjectSlot *)malloc(sizeof(MapObjectSlot) * kMapObjectSlabSize);
+
+            if (slab == nullptr)
+                FatalError("MapObject::Allocate: out of memory\n");
+
+            map_object_slabs.push_back(slab);
+            map_object_slab_used = 0;
+        }
+
+        slot = &map_object_slabs.back()[map_object_slab_used++];
+    }
+
+    map_objects_live++;
+
+    return new (slot->storage) MapObject();
 }
 
 void MapObject::Delete()
 {
     this->~MapObject();
-    free(this);
+
+    MapObjectSlot *slot  = (MapObjectSlot *)this;
+    slot->next_free      = map_object_free_list;
+    map_object_free_list = slot;
+
+    map_objects_live--;
+}
+
+static void ReleaseMapObjectSlabs(void)
+{
+    EPI_ASSERT(map_objects_live == 0);
+
+    for (MapObjectSlot *slab : map_object_slabs)
+        free(slab);
+
+    map_object_slabs.clear();
+    map_object_free_list = nullptr;
+    map_object_slab_used = 0;
 }
 
 bool MapObject::IsRemoved() const
@@ -2151,6 +2212,9 @@ void RemoveAllMapObjects(bool loading)
     active_tagged_map_objects.clear();
     active_tids.clear();
     next_available_tid = 1;
+
+    if (map_objects_live == 0)
+        ReleaseMapObjectSlabs();
 }
 
 void ClearRespawnQueue(void)
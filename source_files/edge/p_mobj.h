@@ -191,11 +191,40 @@ struct Position
     float x, y, z;
 };
 
+// The fields touched by RunMapObjectThinkers() for every object on every
+// tic (list links, state, tics, flags, position and momentum) are kept
+// together at the start, so the walk over a slab of objects (see
+// MapObject::Allocate) stays within the first cache lines of each one.
 class MapObject : public Position
 {
   public:
+    // linked list (map_object_list_head)
+    MapObject *next_     = nullptr;
+    MapObject *previous_ = nullptr;
+
     const MapObjectDefinition *info_ = nullptr;
 
+    const struct State *state_      = nullptr;
+    const struct State *next_state_ = nullptr;
+
+    // state tic counter
+    int tics_     = 0;
+    int tic_skip_ = 0;
+
+    // flags (Old and New)
+    int flags_          = 0;
+    int extended_flags_ = 0;
+    int hyper_flags_    = 0;
+    int mbf21_flags_    = 0;
+
+    // Momentum, used to update position.
+    HMM_Vec3 momentum_ = {{0, 0, 0}};
+
+    // Additional info record for player avatars only.
+    class Player *player_ = nullptr;
+
+    int fuse_ = 0;
+
     BAMAngle angle_          = 0; // orientation
     BAMAngle vertical_angle_ = 0; // looking up or down
 
@@ -206,9 +235,6 @@ class MapObject : public Position
     float aspect_ = 1.0f;
     float alpha_  = 1.0f;
 
-    // Momentum, used to update position.
-    HMM_Vec3 momentum_ = {{0, 0, 0}};
-
     // Track hover phase for time stop shenanigans
     float phase_ = 0.0f;
 
@@ -237,7 +263,6 @@ class MapObject : public Position
     // This is the current speed of the object.
     // if fast_monsters, it is already calculated.
     float speed_ = 0;
-    int   fuse_  = 0;
 
     // When this times out we go to "MORPH" state
     int morph_timeout_ = 0;
@@ -246,19 +271,6 @@ class MapObject : public Position
     float health_       = 0;
     float spawn_health_ = 0;
 
-    // state tic counter
-    int tics_     = 0;
-    int tic_skip_ = 0;
-
-    const struct State *state_      = nullptr;
-    const struct State *next_state_ = nullptr;
-
-    // flags (Old and New)
-    int flags_          = 0;
-    int extended_flags_ = 0;
-    int hyper_flags_    = 0;
-    int mbf21_flags_    = 0;
-
     int   model_skin_       = 0;
     int   model_last_frame_ = 0;
     float model_scale_      = 1.0f;
@@ -283,9 +295,6 @@ class MapObject : public Position
     // no matter what (even if shot)
     int threshold_ = 0;
 
-    // Additional info record for player avatars only.
-    class Player *player_ = nullptr;
-
     // Player number last looked for.
     int last_look_ = 0;
 
@@ -369,10 +378,6 @@ class MapObject : public Position
     // touch list: sectors this thing is in or touches
     struct TouchNode *touch_sectors_ = nullptr;
 
-    // linked list (map_object_list_head)
-    MapObject *next_     = nullptr;
-    MapObject *previous_ = nullptr;
-
     // Interaction info, by BLOCKMAP.
     // Links in blocks (if needed).
     MapObject *blockmap_next_     = nullptr;
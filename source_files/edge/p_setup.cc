@@ -43,6 +43,7 @@
 #include "epi_str_compare.h"
 #include "epi_str_hash.h"
 #include "epi_str_util.h"
+#include "epi_udmf.h"
 #include "g_game.h"
 #include "i_system.h"
 #include "m_argv.h"
@@ -117,6 +118,9 @@ static bool        udmf_level;
 static int         udmf_lump_number;
 static std::string udmf_lump;
 
+// block table for udmf_lump, shared by all the LoadUDMFXXX functions
+static epi::UDMFTextMap udmf_textmap;
+
 // a place to store sidedef numbers of the loaded linedefs.
 // There is two values for every line: side0 and side1.
 static int *temp_line_sides;
@@ -312,7 +316,7 @@ static void LoadVertexes(int lump)
     level_vertexes = new Vertex[total_level_vertexes];
 
     // Load data into cache.
-    data = LoadLumpIntoMemory(lump);
+    data = LoadLumpView(lump);
 
     ml = (const RawVertex *)data;
     li = level_vertexes;
@@ -341,7 +345,7 @@ static void LoadVertexes(int lump)
     CreateThingBlockmap();
 
     // Free buffer memory.
-    delete[] data;
+    ReleaseLumpView(lump, data);
 }
 
 static void SegCommonStuff(Seg *seg, int linedef_in)
@@ -922,7 +926,7 @@ static void LoadLineDefs(int lump)
 
     temp_line_sides = new int[total_level_lines * 2];
 
-    const uint8_t *data = LoadLumpIntoMemory(lump);
+    const uint8_t *data = LoadLumpView(lump);
     map_lines_crc.AddBlock((const uint8_t *)data, GetLumpLength(lump));
 
     Line             *ld  = level_lines;
@@ -985,7 +989,7 @@ static void LoadLineDefs(int lump)
         BlockmapAddLine(ld);
     }
 
-    delete[] data;
+    ReleaseLumpView(lump, data);
 }
 
 static Sector *DetermineSubsectorSector(Subsector *ss, int pass)
@@ -1091,20 +1095,20 @@ static void AssignSubsectorsToSectors()
 static void LoadXGL3Nodes(int lumpnum)
 {
     int                  i, xglen = 0;
-    uint8_t             *xgldata = nullptr;
+    const uint8_t       *xgldata = nullptr;
     std::vector<uint8_t> zgldata;
-    uint8_t             *td = nullptr;
+    const uint8_t       *td = nullptr;
 
     LogDebug("LoadXGL3Nodes:\n");
 
     xglen   = GetLumpLength(lumpnum);
-    xgldata = (uint8_t *)LoadLumpIntoMemory(lumpnum);
+    xgldata = LoadLumpView(lumpnum);
     if (!xgldata)
         FatalError("LoadXGL3Nodes: Couldn't load lump\n");
 
     if (xglen < 12)
     {
-        delete[] xgldata;
+        ReleaseLumpView(lumpnum, xgldata);
         FatalError("LoadXGL3Nodes: Lump too short\n");
     }
 
@@ -1145,8 +1149,8 @@ static void LoadXGL3Nodes(int lumpnum)
     else
     {
         static char xgltemp[6];
-        epi::CStringCopyMax(xgltemp, (char *)xgldata, 4);
-        delete[] xgldata;
+        epi::CStringCopyMax(xgltemp, (const char *)xgldata, 4);
+        ReleaseLumpView(lumpnum, xgldata);
         FatalError("LoadXGL3Nodes: Unrecognized node type %s\n", xgltemp);
     }
 
@@ -1161,7 +1165,7 @@ static void LoadXGL3Nodes(int lumpnum)
     td += 4;
     if (oVerts > total_level_vertexes)
     {
-        delete[] xgldata;
+        ReleaseLumpView(lumpnum, xgldata);
         FatalError("LoadXGL3Nodes: Vertex/Node mismatch\n");
     }
 
@@ -1190,7 +1194,7 @@ static void LoadXGL3Nodes(int lumpnum)
     td += 4;
     if (total_level_subsectors <= 0)
     {
-        delete[] xgldata;
+        ReleaseLumpView(lumpnum, xgldata);
         FatalError("LoadXGL3Nodes: No subsectors\n");
     }
     LogDebug("LoadXGL3Nodes: Num SSECTORS = %d\n", total_level_subsectors);
@@ -1213,7 +1217,7 @@ static void LoadXGL3Nodes(int lumpnum)
     td += 4;
     if (total_level_segs != xglSegs)
     {
-        delete[] xgldata;
+        ReleaseLumpView(lumpnum, xgldata);
         FatalError("LoadXGL3Nodes: Incorrect number of segs in nodes\n");
     }
     LogDebug("LoadXGL3Nodes: Num SEGS = %d\n", total_level_segs);
@@ -1367,14 +1371,12 @@ static void LoadXGL3Nodes(int lumpnum)
     SetupRootNode();
 
     LogDebug("LoadXGL3Nodes: Finished\n");
-    delete[] xgldata;
+    ReleaseLumpView(lumpnum, xgldata);
     zgldata.clear();
 }
 
 static void LoadUDMFVertexes()
 {
-    epi::Scanner lex(udmf_lump);
-
     LogDebug("LoadUDMFVertexes: parsing TEXTMAP\n");
     int cur_vertex = 0;
     int min_x      = 0;
@@ -1382,96 +1384,42 @@ static void LoadUDMFVertexes()
     int max_x      = 0;
     int max_y      = 0;
 
-    while (lex.TokensLeft())
+    for (const epi::UDMFBlock &block : udmf_textmap.Blocks())
     {
-        std::string section;
-
-        if (!lex.GetNextToken())
-            break;
-
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
-
-        // check namespace
-        if (lex.CheckToken('='))
-        {
-            lex.GetNextToken();
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
+        if (block.name != udmf::kVertex)
             continue;
-        }
-
-        section = lex.state_.string;
-
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
 
-        if (section == "vertex")
-        {
-            float x = 0.0f, y = 0.0f;
-            float zf = -40000.0f, zc = 40000.0f;
-            for (;;)
-            {
-                if (lex.CheckToken('}'))
-                    break;
-
-                std::string key;
-                std::string value;
-
-                if (!lex.GetNextToken())
-                    FatalError("Malformed TEXTMAP lump: unclosed block\n");
-
-                if (lex.state_.token != epi::Scanner::kIdentifier)
-                    FatalError("Malformed TEXTMAP lump: missing key\n");
-
-                key = lex.state_.string;
-
-                if (!lex.CheckToken('='))
-                    FatalError("Malformed TEXTMAP lump: missing '='\n");
+        float x = 0.0f, y = 0.0f;
+        float zf = -40000.0f, zc = 40000.0f;
 
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    FatalError("Malformed TEXTMAP lump: missing value\n");
+        const epi::UDMFField *field = udmf_textmap.BlockFields(block);
 
-                value = lex.state_.string;
-
-                if (!lex.CheckToken(';'))
-                    FatalError("Malformed TEXTMAP lump: missing ';'\n");
-
-                epi::StringHash key_hash(key);
-
-                switch (key_hash.Value())
-                {
-                case udmf::kX:
-                    x     = lex.state_.decimal;
-                    min_x = HMM_MIN((int)x, min_x);
-                    max_x = HMM_MAX((int)x, max_x);
-                    break;
-                case udmf::kY:
-                    y     = lex.state_.decimal;
-                    min_y = HMM_MIN((int)y, min_y);
-                    max_y = HMM_MAX((int)y, max_y);
-                    break;
-                case udmf::kZFloor:
-                    zf = lex.state_.decimal;
-                    break;
-                case udmf::kZCeiling:
-                    zc = lex.state_.decimal;
-                    break;
-                default:
-                    break;
-                }
-            }
-            level_vertexes[cur_vertex] = {{{{{x, y, zf}}}, zc}};
-            cur_vertex++;
-        }
-        else // consume other blocks
+        for (uint32_t i = 0; i < block.total_fields; i++, field++)
         {
-            for (;;)
+            switch (field->key)
             {
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    break;
+            case udmf::kX:
+                x     = udmf_textmap.Decimal(*field);
+                min_x = HMM_MIN((int)x, min_x);
+                max_x = HMM_MAX((int)x, max_x);
+                break;
+            case udmf::kY:
+                y     = udmf_textmap.Decimal(*field);
+                min_y = HMM_MIN((int)y, min_y);
+                max_y = HMM_MAX((int)y, max_y);
+                break;
+            case udmf::kZFloor:
+                zf = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kZCeiling:
+                zc = udmf_textmap.Decimal(*field);
+                break;
+            default:
+                break;
             }
         }
+        level_vertexes[cur_vertex] = {{{{{x, y, zf}}}, zc}};
+        cur_vertex++;
     }
     EPI_ASSERT(cur_vertex == total_level_vertexes);
 
@@ -1484,316 +1432,260 @@ static void LoadUDMFVertexes()
 
 static void LoadUDMFSectors()
 {
-    epi::Scanner lex(udmf_lump);
-
     LogDebug("LoadUDMFSectors: parsing TEXTMAP\n");
     int cur_sector = 0;
 
-    while (lex.TokensLeft())
+    for (const epi::UDMFBlock &block : udmf_textmap.Blocks())
     {
-        std::string section;
-
-        if (!lex.GetNextToken())
-            break;
-
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
-
-        // check namespace
-        if (lex.CheckToken('='))
-        {
-            lex.GetNextToken();
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
+        if (block.name != udmf::kSector)
             continue;
-        }
-
-        section = lex.state_.string;
-
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
 
-        if (section == "sector")
+        int                    cz = 0, fz = 0;
+        float                  fx = 0.0f, fy = 0.0f, cx = 0.0f, cy = 0.0f;
+        float                  fx_sc = 1.0f, fy_sc = 1.0f, cx_sc = 1.0f, cy_sc = 1.0f;
+        float                  falph = 1.0f, calph = 1.0f;
+        float                  rf = 0.0f, rc = 0.0f;
+        float                  gravfactor = 1.0f;
+        int                    light = 160, type = 0, tag = 0;
+        RGBAColor              fog_color   = kRGBABlack;
+        RGBAColor              light_color = kRGBAWhite;
+        int                    fog_density = 0;
+        char                   floor_tex[10];
+        char                   ceil_tex[10];
+        ddf::ReverbDefinition *reverb = nullptr;
+        strcpy(floor_tex, "-");
+        strcpy(ceil_tex, "-");
+
+        const epi::UDMFField *field = udmf_textmap.BlockFields(block);
+
+        for (uint32_t i = 0; i < block.total_fields; i++, field++)
         {
-            int                    cz = 0, fz = 0;
-            float                  fx = 0.0f, fy = 0.0f, cx = 0.0f, cy = 0.0f;
-            float                  fx_sc = 1.0f, fy_sc = 1.0f, cx_sc = 1.0f, cy_sc = 1.0f;
-            float                  falph = 1.0f, calph = 1.0f;
-            float                  rf = 0.0f, rc = 0.0f;
-            float                  gravfactor = 1.0f;
-            int                    light = 160, type = 0, tag = 0;
-            RGBAColor              fog_color   = kRGBABlack;
-            RGBAColor              light_color = kRGBAWhite;
-            int                    fog_density = 0;
-            char                   floor_tex[10];
-            char                   ceil_tex[10];
-            ddf::ReverbDefinition *reverb = nullptr;
-            strcpy(floor_tex, "-");
-            strcpy(ceil_tex, "-");
-            for (;;)
+            switch (field->key)
             {
-                if (lex.CheckToken('}'))
-                    break;
-
-                std::string key;
-                std::string value;
-
-                if (!lex.GetNextToken())
-                    FatalError("Malformed TEXTMAP lump: unclosed block\n");
-
-                if (lex.state_.token != epi::Scanner::kIdentifier)
-                    FatalError("Malformed TEXTMAP lump: missing key\n");
-
-                key = lex.state_.string;
-
-                if (!lex.CheckToken('='))
-                    FatalError("Malformed TEXTMAP lump: missing '='\n");
-
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    FatalError("Malformed TEXTMAP lump: missing value\n");
-
-                value = lex.state_.string;
-
-                if (!lex.CheckToken(';'))
-                    FatalError("Malformed TEXTMAP lump: missing ';'\n");
-
-                epi::StringHash key_hash(key);
-
-                switch (key_hash.Value())
-                {
-                case udmf::kHeightFloor:
-                    fz = lex.state_.number;
-                    break;
-                case udmf::kHeightCeiling:
-                    cz = lex.state_.number;
-                    break;
-                case udmf::kTextureFloor:
-                    epi::CStringCopyMax(floor_tex, value.c_str(), 8);
-                    break;
-                case udmf::kTextureCeiling:
-                    epi::CStringCopyMax(ceil_tex, value.c_str(), 8);
-                    break;
-                case udmf::kLightLevel:
-                    light = lex.state_.number;
-                    break;
-                case udmf::kSpecial:
-                    type = lex.state_.number;
-                    break;
-                case udmf::kID:
-                    tag = lex.state_.number;
-                    break;
-                case udmf::kLightColor:
-                    light_color = ((uint32_t)lex.state_.number << 8 | 0xFF);
-                    break;
-                case udmf::kFadeColor:
-                    fog_color = ((uint32_t)lex.state_.number << 8 | 0xFF);
-                    break;
-                case udmf::kFogDensity:
-                    fog_density = HMM_Clamp(0, lex.state_.number, 1020);
-                    break;
-                case udmf::kXPanningFloor:
-                    fx = lex.state_.decimal;
-                    break;
-                case udmf::kYPanningFloor:
-                    fy = lex.state_.decimal;
-                    break;
-                case udmf::kXPanningCeiling:
-                    cx = lex.state_.decimal;
-                    break;
-                case udmf::kYPanningCeiling:
-                    cy = lex.state_.decimal;
-                    break;
-                case udmf::kXScaleFloor:
-                    fx_sc = lex.state_.decimal;
-                    break;
-                case udmf::kYScaleFloor:
-                    fy_sc = lex.state_.decimal;
-                    break;
-                case udmf::kXScaleCeiling:
-                    cx_sc = lex.state_.decimal;
-                    break;
-                case udmf::kYScaleCeiling:
-                    cy_sc = lex.state_.decimal;
-                    break;
-                case udmf::kAlphaFloor:
-                    falph = lex.state_.decimal;
-                    break;
-                case udmf::kAlphaCeiling:
-                    calph = lex.state_.decimal;
-                    break;
-                case udmf::kRotationFloor:
-                    rf = lex.state_.decimal;
-                    break;
-                case udmf::kRotationCeiling:
-                    rc = lex.state_.decimal;
-                    break;
-                case udmf::kGravity:
-                    gravfactor = lex.state_.decimal;
-                    break;
-                case udmf::kReverbPreset:
-                    reverb = ddf::ReverbDefinition::Lookup(value);
-                    break;
-                default:
-                    break;
-                }
+            case udmf::kHeightFloor:
+                fz = udmf_textmap.Number(*field);
+                break;
+            case udmf::kHeightCeiling:
+                cz = udmf_textmap.Number(*field);
+                break;
+            case udmf::kTextureFloor:
+                epi::CStringCopyMax(floor_tex, udmf_textmap.String(*field).c_str(), 8);
+                break;
+            case udmf::kTextureCeiling:
+                epi::CStringCopyMax(ceil_tex, udmf_textmap.String(*field).c_str(), 8);
+                break;
+            case udmf::kLightLevel:
+                light = udmf_textmap.Number(*field);
+                break;
+            case udmf::kSpecial:
+                type = udmf_textmap.Number(*field);
+                break;
+            case udmf::kID:
+                tag = udmf_textmap.Number(*field);
+                break;
+            case udmf::kLightColor:
+                light_color = ((uint32_t)udmf_textmap.Number(*field) << 8 | 0xFF);
+                break;
+            case udmf::kFadeColor:
+                fog_color = ((uint32_t)udmf_textmap.Number(*field) << 8 | 0xFF);
+                break;
+            case udmf::kFogDensity:
+                fog_density = HMM_Clamp(0, udmf_textmap.Number(*field), 1020);
+                break;
+            case udmf::kXPanningFloor:
+                fx = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kYPanningFloor:
+                fy = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kXPanningCeiling:
+                cx = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kYPanningCeiling:
+                cy = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kXScaleFloor:
+                fx_sc = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kYScaleFloor:
+                fy_sc = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kXScaleCeiling:
+                cx_sc = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kYScaleCeiling:
+                cy_sc = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kAlphaFloor:
+                falph = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kAlphaCeiling:
+                calph = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kRotationFloor:
+                rf = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kRotationCeiling:
+                rc = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kGravity:
+                gravfactor = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kReverbPreset:
+                reverb = ddf::ReverbDefinition::Lookup(udmf_textmap.String(*field));
+                break;
+            default:
+                break;
             }
-            Sector *ss         = level_sectors + cur_sector;
-            ss->floor_height   = fz;
-            ss->ceiling_height = cz;
+        }
+        Sector *ss         = level_sectors + cur_sector;
+        ss->floor_height   = fz;
+        ss->ceiling_height = cz;
 
-            ss->original_height = (ss->floor_height + ss->ceiling_height);
+        ss->original_height = (ss->floor_height + ss->ceiling_height);
 
-            ss->floor.translucency = falph;
-            ss->floor.x_matrix.X   = 1;
-            ss->floor.x_matrix.Y   = 0;
-            ss->floor.y_matrix.X   = 0;
-            ss->floor.y_matrix.Y   = 1;
+        ss->floor.translucency = falph;
+        ss->floor.x_matrix.X   = 1;
+        ss->floor.x_matrix.Y   = 0;
+        ss->floor.y_matrix.X   = 0;
+        ss->floor.y_matrix.Y   = 1;
 
-            ss->ceiling              = ss->floor;
-            ss->ceiling.translucency = calph;
+        ss->ceiling              = ss->floor;
+        ss->ceiling.translucency = calph;
 
-            // rotations
-            if (!AlmostEquals(rf, 0.0f))
-                ss->floor.rotation = epi::BAMFromDegrees(rf);
+        // rotations
+        if (!AlmostEquals(rf, 0.0f))
+            ss->floor.rotation = epi::BAMFromDegrees(rf);
 
-            if (!AlmostEquals(rc, 0.0f))
-                ss->ceiling.rotation = epi::BAMFromDegrees(rc);
+        if (!AlmostEquals(rc, 0.0f))
+            ss->ceiling.rotation = epi::BAMFromDegrees(rc);
 
-            // granular scaling
-            ss->floor.x_matrix.X   = fx_sc;
-            ss->floor.y_matrix.Y   = fy_sc;
-            ss->ceiling.x_matrix.X = cx_sc;
-            ss->ceiling.y_matrix.Y = cy_sc;
+        // granular scaling
+        ss->floor.x_matrix.X   = fx_sc;
+        ss->floor.y_matrix.Y   = fy_sc;
+        ss->ceiling.x_matrix.X = cx_sc;
+        ss->ceiling.y_matrix.Y = cy_sc;
 
-            // granular offsets
-            ss->floor.offset.X += (fx / fx_sc);
-            ss->floor.offset.Y -= (fy / fy_sc);
-            ss->floor.old_offset = ss->floor.offset;
-            ss->ceiling.offset.X += (cx / cx_sc);
-            ss->ceiling.offset.Y -= (cy / cy_sc);
-            ss->ceiling.old_offset = ss->ceiling.offset;
+        // granular offsets
+        ss->floor.offset.X += (fx / fx_sc);
+        ss->floor.offset.Y -= (fy / fy_sc);
+        ss->floor.old_offset = ss->floor.offset;
+        ss->ceiling.offset.X += (cx / cx_sc);
+        ss->ceiling.offset.Y -= (cy / cy_sc);
+        ss->ceiling.old_offset = ss->ceiling.offset;
 
-            ss->floor.image = ImageLookup(floor_tex, kImageNamespaceFlat);
+        ss->floor.image = ImageLookup(floor_tex, kImageNamespaceFlat);
 
-            if (ss->floor.image)
+        if (ss->floor.image)
+        {
+            FlatDefinition *current_flatdef = flatdefs.Find(ss->floor.image->name_.c_str());
+            if (current_flatdef)
             {
-                FlatDefinition *current_flatdef = flatdefs.Find(ss->floor.image->name_.c_str());
-                if (current_flatdef)
-                {
-                    ss->bob_depth  = current_flatdef->bob_depth_;
-                    ss->sink_depth = current_flatdef->sink_depth_;
-                }
+                ss->bob_depth  = current_flatdef->bob_depth_;
+                ss->sink_depth = current_flatdef->sink_depth_;
             }
+        }
 
-            ss->ceiling.image = ImageLookup(ceil_tex, kImageNamespaceFlat);
+        ss->ceiling.image = ImageLookup(ceil_tex, kImageNamespaceFlat);
 
-            if (!ss->floor.image)
-            {
-                LogWarning("Bad Level: sector #%d has missing floor texture.\n", cur_sector);
-                ss->floor.image = ImageLookup("FLAT1", kImageNamespaceFlat);
-            }
-            if (!ss->ceiling.image)
-            {
-                LogWarning("Bad Level: sector #%d has missing ceiling texture.\n", cur_sector);
-                ss->ceiling.image = ss->floor.image;
-            }
+        if (!ss->floor.image)
+        {
+            LogWarning("Bad Level: sector #%d has missing floor texture.\n", cur_sector);
+            ss->floor.image = ImageLookup("FLAT1", kImageNamespaceFlat);
+        }
+        if (!ss->ceiling.image)
+        {
+            LogWarning("Bad Level: sector #%d has missing ceiling texture.\n", cur_sector);
+            ss->ceiling.image = ss->floor.image;
+        }
 
-            // convert negative tags to zero
-            ss->tag = HMM_MAX(0, tag);
+        // convert negative tags to zero
+        ss->tag = HMM_MAX(0, tag);
 
-            ss->properties.light_level = light;
+        ss->properties.light_level = light;
 
-            // convert negative types to zero
-            ss->properties.type    = HMM_MAX(0, type);
-            ss->properties.special = LookupSectorType(ss->properties.type);
+        // convert negative types to zero
+        ss->properties.type    = HMM_MAX(0, type);
+        ss->properties.special = LookupSectorType(ss->properties.type);
 
-            ss->extrafloor_maximum = 0;
+        ss->extrafloor_maximum = 0;
 
-            ss->properties.colourmap = nullptr;
+        ss->properties.colourmap = nullptr;
 
-            ss->properties.gravity    = kGravityDefault * gravfactor;
-            ss->properties.friction   = kFrictionDefault;
-            ss->properties.movefactor = 1.0f;
-            ss->properties.viscosity  = kViscosityDefault;
-            ss->properties.drag       = kDragDefault;
+        ss->properties.gravity    = kGravityDefault * gravfactor;
+        ss->properties.friction   = kFrictionDefault;
+        ss->properties.movefactor = 1.0f;
+        ss->properties.viscosity  = kViscosityDefault;
+        ss->properties.drag       = kDragDefault;
 
-            // Allow UDMF sector light/fog information to override DDFSECT types
-            if (fog_color != kRGBABlack) // All black is the established
-                                         // UDMF "no fog" color
-            {
-                // Prevent UDMF-specified fog color from having our internal 'no
-                // value'...uh...value
-                if (fog_color == kRGBANoValue)
-                    fog_color ^= 0x00010100;
-                ss->properties.fog_color = fog_color;
-                // Best-effort match for GZDoom's fogdensity values so that UDB,
-                // etc give predictable results
-                if (fog_density < 2)
-                    ss->properties.fog_density = 0.002f;
-                else
-                    ss->properties.fog_density = 0.01f * ((float)fog_density / 1020.0f);
-            }
-            else if (ss->properties.special && ss->properties.special->fog_color_ != kRGBANoValue)
-            {
-                ss->properties.fog_color   = ss->properties.special->fog_color_;
-                ss->properties.fog_density = 0.01f * ss->properties.special->fog_density_;
-            }
+        // Allow UDMF sector light/fog information to override DDFSECT types
+        if (fog_color != kRGBABlack) // All black is the established
+                                     // UDMF "no fog" color
+        {
+            // Prevent UDMF-specified fog color from having our internal 'no
+            // value'...uh...value
+            if (fog_color == kRGBANoValue)
+                fog_color ^= 0x00010100;
+            ss->properties.fog_color = fog_color;
+            // Best-effort match for GZDoom's fogdensity values so that UDB,
+            // etc give predictable results
+            if (fog_density < 2)
+                ss->properties.fog_density = 0.002f;
             else
-            {
-                ss->properties.fog_color   = kRGBANoValue;
-                ss->properties.fog_density = 0;
-            }
+                ss->properties.fog_density = 0.01f * ((float)fog_density / 1020.0f);
+        }
+        else if (ss->properties.special && ss->properties.special->fog_color_ != kRGBANoValue)
+        {
+            ss->properties.fog_color   = ss->properties.special->fog_color_;
+            ss->properties.fog_density = 0.01f * ss->properties.special->fog_density_;
+        }
+        else
+        {
+            ss->properties.fog_color   = kRGBANoValue;
+            ss->properties.fog_density = 0;
+        }
 
-            // Allow UDMF sector reverb information to override DDFSECT types
-            if (reverb)
-                ss->sound_reverb = reverb;
-            else if (ss->properties.special && ss->properties.special->reverb_preset_)
-                ss->sound_reverb = ss->properties.special->reverb_preset_;
+        // Allow UDMF sector reverb information to override DDFSECT types
+        if (reverb)
+            ss->sound_reverb = reverb;
+        else if (ss->properties.special && ss->properties.special->reverb_preset_)
+            ss->sound_reverb = ss->properties.special->reverb_preset_;
 
-            if (light_color != kRGBAWhite)
+        if (light_color != kRGBAWhite)
+        {
+            if (light_color == kRGBANoValue)
+                light_color ^= 0x00010100;
+            // Make colormap if necessary
+            for (Colormap *cmap : colormaps)
             {
-                if (light_color == kRGBANoValue)
-                    light_color ^= 0x00010100;
-                // Make colormap if necessary
-                for (Colormap *cmap : colormaps)
-                {
-                    if (cmap->gl_color_ != kRGBANoValue && cmap->gl_color_ == light_color)
-                    {
-                        ss->properties.colourmap = cmap;
-                        break;
-                    }
-                }
-                if (!ss->properties.colourmap || ss->properties.colourmap->gl_color_ != light_color)
+                if (cmap->gl_color_ != kRGBANoValue && cmap->gl_color_ == light_color)
                 {
-                    Colormap *ad_hoc         = new Colormap;
-                    ad_hoc->name_            = epi::StringFormat("UDMF_%d", light_color); // Internal
-                    ad_hoc->gl_color_        = light_color;
-                    ss->properties.colourmap = ad_hoc;
-                    colormaps.push_back(ad_hoc);
+                    ss->properties.colourmap = cmap;
+                    break;
                 }
             }
+            if (!ss->properties.colourmap || ss->properties.colourmap->gl_color_ != light_color)
+            {
+                Colormap *ad_hoc         = new Colormap;
+                ad_hoc->name_            = epi::StringFormat("UDMF_%d", light_color); // Internal
+                ad_hoc->gl_color_        = light_color;
+                ss->properties.colourmap = ad_hoc;
+                colormaps.push_back(ad_hoc);
+            }
+        }
 
-            ss->active_properties = &ss->properties;
+        ss->active_properties = &ss->properties;
 
-            ss->sound_player = -1;
+        ss->sound_player = -1;
 
-            ss->old_floor_height            = ss->floor_height;
-            ss->interpolated_floor_height   = ss->floor_height;
-            ss->old_ceiling_height          = ss->ceiling_height;
-            ss->interpolated_ceiling_height = ss->ceiling_height;
+        ss->old_floor_height            = ss->floor_height;
+        ss->interpolated_floor_height   = ss->floor_height;
+        ss->old_ceiling_height          = ss->ceiling_height;
+        ss->interpolated_ceiling_height = ss->ceiling_height;
 
-            // -AJA- 1999/07/29: Keep sectors with same tag in a list.
-            GroupSectorTags(ss, level_sectors, cur_sector);
-            cur_sector++;
-        }
-        else // consume other blocks
-        {
-            for (;;)
-            {
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    break;
-            }
-        }
+        // -AJA- 1999/07/29: Keep sectors with same tag in a list.
+        GroupSectorTags(ss, level_sectors, cur_sector);
+        cur_sector++;
     }
     EPI_ASSERT(cur_sector == total_level_sectors);
 
@@ -1802,8 +1694,6 @@ static void LoadUDMFSectors()
 
 static void LoadUDMFSideDefs()
 {
-    epi::Scanner lex(udmf_lump);
-
     LogDebug("LoadUDMFSectors: parsing TEXTMAP\n");
 
     level_sides = new Side[total_level_sides];
@@ -1811,196 +1701,142 @@ static void LoadUDMFSideDefs()
 
     int nummapsides = 0;
 
-    for (;;)
+    for (const epi::UDMFBlock &block : udmf_textmap.Blocks())
     {
-        std::string section;
-
-        if (!lex.GetNextToken())
-            break;
-
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
+        if (block.name != udmf::kSidedef)
+            continue;
 
-        // check namespace
-        if (lex.CheckToken('='))
+        nummapsides++;
+        int   x = 0, y = 0;
+        float lowx = 0.0f, midx = 0.0f, highx = 0.0f;
+        float lowy = 0.0f, midy = 0.0f, highy = 0.0f;
+        float low_scx = 1.0f, mid_scx = 1.0f, high_scx = 1.0f;
+        float low_scy = 1.0f, mid_scy = 1.0f, high_scy = 1.0f;
+        int   sec_num = 0;
+        char  top_tex[10];
+        char  bottom_tex[10];
+        char  middle_tex[10];
+        strcpy(top_tex, "-");
+        strcpy(bottom_tex, "-");
+        strcpy(middle_tex, "-");
+
+        const epi::UDMFField *field = udmf_textmap.BlockFields(block);
+
+        for (uint32_t i = 0; i < block.total_fields; i++, field++)
         {
-            lex.GetNextToken();
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
-            continue;
+            switch (field->key)
+            {
+            case udmf::kOffsetX:
+                x = udmf_textmap.Number(*field);
+                break;
+            case udmf::kOffsetY:
+                y = udmf_textmap.Number(*field);
+                break;
+            case udmf::kOffsetX_Bottom:
+                lowx = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kOffsetX_Mid:
+                midx = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kOffsetX_Top:
+                highx = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kOffsetY_Bottom:
+                lowy = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kOffsetY_Mid:
+                midy = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kOffsetY_Top:
+                highy = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kScaleX_Bottom:
+                low_scx = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kScaleX_Mid:
+                mid_scx = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kScaleX_Top:
+                high_scx = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kScaleY_Bottom:
+                low_scy = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kScaleY_Mid:
+                mid_scy = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kScaleY_Top:
+                high_scy = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kTextureTop:
+                epi::CStringCopyMax(top_tex, udmf_textmap.String(*field).c_str(), 8);
+                break;
+            case udmf::kTextureBottom:
+                epi::CStringCopyMax(bottom_tex, udmf_textmap.String(*field).c_str(), 8);
+                break;
+            case udmf::kTextureMiddle:
+                epi::CStringCopyMax(middle_tex, udmf_textmap.String(*field).c_str(), 8);
+                break;
+            case udmf::kSector:
+                sec_num = udmf_textmap.Number(*field);
+                break;
+            default:
+                break;
+            }
         }
+        EPI_ASSERT(nummapsides <= total_level_sides); // sanity check
 
-        section = lex.state_.string;
+        Side *sd = level_sides + nummapsides - 1;
 
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
+        sd->top.translucency = 1.0f;
+        sd->top.offset.X     = x;
+        sd->top.offset.Y     = y;
+        sd->top.x_matrix.X   = 1;
+        sd->top.x_matrix.Y   = 0;
+        sd->top.y_matrix.X   = 0;
+        sd->top.y_matrix.Y   = 1;
 
-        if (section == "sidedef")
-        {
-            nummapsides++;
-            int   x = 0, y = 0;
-            float lowx = 0.0f, midx = 0.0f, highx = 0.0f;
-            float lowy = 0.0f, midy = 0.0f, highy = 0.0f;
-            float low_scx = 1.0f, mid_scx = 1.0f, high_scx = 1.0f;
-            float low_scy = 1.0f, mid_scy = 1.0f, high_scy = 1.0f;
-            int   sec_num = 0;
-            char  top_tex[10];
-            char  bottom_tex[10];
-            char  middle_tex[10];
-            strcpy(top_tex, "-");
-            strcpy(bottom_tex, "-");
-            strcpy(middle_tex, "-");
-            for (;;)
-            {
-                if (lex.CheckToken('}'))
-                    break;
+        sd->middle = sd->top;
+        sd->bottom = sd->top;
 
-                std::string key;
-                std::string value;
+        sd->sector = &level_sectors[sec_num];
 
-                if (!lex.GetNextToken())
-                    FatalError("Malformed TEXTMAP lump: unclosed block\n");
+        sd->top.image = ImageLookup(top_tex, kImageNamespaceTexture, kImageLookupNull);
 
-                if (lex.state_.token != epi::Scanner::kIdentifier)
-                    FatalError("Malformed TEXTMAP lump: missing key\n");
+        if (sd->top.image == nullptr)
+            sd->top.image = ImageLookup(top_tex, kImageNamespaceTexture);
 
-                key = lex.state_.string;
+        sd->middle.image = ImageLookup(middle_tex, kImageNamespaceTexture);
+        sd->bottom.image = ImageLookup(bottom_tex, kImageNamespaceTexture);
 
-                if (!lex.CheckToken('='))
-                    FatalError("Malformed TEXTMAP lump: missing '='\n");
+        // granular scaling
+        sd->bottom.x_matrix.X = low_scx;
+        sd->middle.x_matrix.X = mid_scx;
+        sd->top.x_matrix.X    = high_scx;
+        sd->bottom.y_matrix.Y = low_scy;
+        sd->middle.y_matrix.Y = mid_scy;
+        sd->top.y_matrix.Y    = high_scy;
 
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    FatalError("Malformed TEXTMAP lump: missing value\n");
+        // granular offsets
+        sd->bottom.offset.X += lowx / low_scx;
+        sd->middle.offset.X += midx / mid_scx;
+        sd->top.offset.X += highx / high_scx;
+        sd->bottom.offset.Y += lowy / low_scy;
+        sd->middle.offset.Y += midy / mid_scy;
+        sd->top.offset.Y += highy / high_scy;
+        sd->top.old_offset    = sd->top.offset;
+        sd->middle.old_offset = sd->middle.offset;
+        sd->bottom.old_offset = sd->bottom.offset;
 
-                value = lex.state_.string;
+        // handle BOOM colormaps with [242] linetype
+        sd->top.boom_colormap    = colormaps.Lookup(top_tex);
+        sd->middle.boom_colormap = colormaps.Lookup(middle_tex);
+        sd->bottom.boom_colormap = colormaps.Lookup(bottom_tex);
+    }
 
-                if (!lex.CheckToken(';'))
-                    FatalError("Malformed TEXTMAP lump: missing ';'\n");
+    LogDebug("LoadUDMFSideDefs: post-processing linedefs & sidedefs\n");
 
-                epi::StringHash key_hash(key);
-
-                switch (key_hash.Value())
-                {
-                case udmf::kOffsetX:
-                    x = lex.state_.number;
-                    break;
-                case udmf::kOffsetY:
-                    y = lex.state_.number;
-                    break;
-                case udmf::kOffsetX_Bottom:
-                    lowx = lex.state_.decimal;
-                    break;
-                case udmf::kOffsetX_Mid:
-                    midx = lex.state_.decimal;
-                    break;
-                case udmf::kOffsetX_Top:
-                    highx = lex.state_.decimal;
-                    break;
-                case udmf::kOffsetY_Bottom:
-                    lowy = lex.state_.decimal;
-                    break;
-                case udmf::kOffsetY_Mid:
-                    midy = lex.state_.decimal;
-                    break;
-                case udmf::kOffsetY_Top:
-                    highy = lex.state_.decimal;
-                    break;
-                case udmf::kScaleX_Bottom:
-                    low_scx = lex.state_.decimal;
-                    break;
-                case udmf::kScaleX_Mid:
-                    mid_scx = lex.state_.decimal;
-                    break;
-                case udmf::kScaleX_Top:
-                    high_scx = lex.state_.decimal;
-                    break;
-                case udmf::kScaleY_Bottom:
-                    low_scy = lex.state_.decimal;
-                    break;
-                case udmf::kScaleY_Mid:
-                    mid_scy = lex.state_.decimal;
-                    break;
-                case udmf::kScaleY_Top:
-                    high_scy = lex.state_.decimal;
-                    break;
-                case udmf::kTextureTop:
-                    epi::CStringCopyMax(top_tex, value.c_str(), 8);
-                    break;
-                case udmf::kTextureBottom:
-                    epi::CStringCopyMax(bottom_tex, value.c_str(), 8);
-                    break;
-                case udmf::kTextureMiddle:
-                    epi::CStringCopyMax(middle_tex, value.c_str(), 8);
-                    break;
-                case udmf::kSector:
-                    sec_num = lex.state_.number;
-                    break;
-                default:
-                    break;
-                }
-            }
-            EPI_ASSERT(nummapsides <= total_level_sides); // sanity check
-
-            Side *sd = level_sides + nummapsides - 1;
-
-            sd->top.translucency = 1.0f;
-            sd->top.offset.X     = x;
-            sd->top.offset.Y     = y;
-            sd->top.x_matrix.X   = 1;
-            sd->top.x_matrix.Y   = 0;
-            sd->top.y_matrix.X   = 0;
-            sd->top.y_matrix.Y   = 1;
-
-            sd->middle = sd->top;
-            sd->bottom = sd->top;
-
-            sd->sector = &level_sectors[sec_num];
-
-            sd->top.image = ImageLookup(top_tex, kImageNamespaceTexture, kImageLookupNull);
-
-            if (sd->top.image == nullptr)
-                sd->top.image = ImageLookup(top_tex, kImageNamespaceTexture);
-
-            sd->middle.image = ImageLookup(middle_tex, kImageNamespaceTexture);
-            sd->bottom.image = ImageLookup(bottom_tex, kImageNamespaceTexture);
-
-            // granular scaling
-            sd->bottom.x_matrix.X = low_scx;
-            sd->middle.x_matrix.X = mid_scx;
-            sd->top.x_matrix.X    = high_scx;
-            sd->bottom.y_matrix.Y = low_scy;
-            sd->middle.y_matrix.Y = mid_scy;
-            sd->top.y_matrix.Y    = high_scy;
-
-            // granular offsets
-            sd->bottom.offset.X += lowx / low_scx;
-            sd->middle.offset.X += midx / mid_scx;
-            sd->top.offset.X += highx / high_scx;
-            sd->bottom.offset.Y += lowy / low_scy;
-            sd->middle.offset.Y += midy / mid_scy;
-            sd->top.offset.Y += highy / high_scy;
-            sd->top.old_offset    = sd->top.offset;
-            sd->middle.old_offset = sd->middle.offset;
-            sd->bottom.old_offset = sd->bottom.offset;
-
-            // handle BOOM colormaps with [242] linetype
-            sd->top.boom_colormap    = colormaps.Lookup(top_tex);
-            sd->middle.boom_colormap = colormaps.Lookup(middle_tex);
-            sd->bottom.boom_colormap = colormaps.Lookup(bottom_tex);
-        }
-        else // consume other blocks
-        {
-            for (;;)
-            {
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    break;
-            }
-        }
-    }
-
-    LogDebug("LoadUDMFSideDefs: post-processing linedefs & sidedefs\n");
-
-    // post-process linedefs & sidedefs
+    // post-process linedefs & sidedefs
 
     EPI_ASSERT(temp_line_sides);
 
@@ -2069,197 +1905,141 @@ static void LoadUDMFSideDefs()
 
 static void LoadUDMFLineDefs()
 {
-    epi::Scanner lex(udmf_lump);
-
     LogDebug("LoadUDMFLineDefs: parsing TEXTMAP\n");
 
     int cur_line = 0;
 
-    for (;;)
+    for (const epi::UDMFBlock &block : udmf_textmap.Blocks())
     {
-        std::string section;
-
-        if (!lex.GetNextToken())
-            break;
-
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
-
-        // check namespace
-        if (lex.CheckToken('='))
-        {
-            lex.GetNextToken();
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
+        if (block.name != udmf::kLinedef)
             continue;
-        }
 
-        section = lex.state_.string;
+        int   flags = 0, v1 = 0, v2 = 0;
+        int   side0 = -1, side1 = -1, tag = -1, arg0 = -1;
+        float alpha   = 1.0f;
+        int   special = 0;
 
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
+        const epi::UDMFField *field = udmf_textmap.BlockFields(block);
 
-        if (section == "linedef")
+        for (uint32_t i = 0; i < block.total_fields; i++, field++)
         {
-            int   flags = 0, v1 = 0, v2 = 0;
-            int   side0 = -1, side1 = -1, tag = -1, arg0 = -1;
-            float alpha   = 1.0f;
-            int   special = 0;
-            for (;;)
+            switch (field->key)
             {
-                if (lex.CheckToken('}'))
-                    break;
-
-                std::string key;
-                std::string value;
-
-                if (!lex.GetNextToken())
-                    FatalError("Malformed TEXTMAP lump: unclosed block\n");
-
-                if (lex.state_.token != epi::Scanner::kIdentifier)
-                    FatalError("Malformed TEXTMAP lump: missing key\n");
-
-                key = lex.state_.string;
-
-                if (!lex.CheckToken('='))
-                    FatalError("Malformed TEXTMAP lump: missing '='\n");
-
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    FatalError("Malformed TEXTMAP lump: missing value\n");
-
-                value = lex.state_.string;
-
-                if (!lex.CheckToken(';'))
-                    FatalError("Malformed TEXTMAP lump: missing ';'\n");
-
-                epi::StringHash key_hash(key);
-
-                switch (key_hash.Value())
-                {
-                case udmf::kID:
-                    tag = lex.state_.number;
-                    break;
-                case udmf::kArg0:
-                    arg0 = lex.state_.number;
-                    break;
-                case udmf::kV1:
-                    v1 = lex.state_.number;
-                    break;
-                case udmf::kV2:
-                    v2 = lex.state_.number;
-                    break;
-                case udmf::kSpecial:
-                    special = lex.state_.number;
-                    break;
-                case udmf::kSideFront:
-                    side0 = lex.state_.number;
-                    break;
-                case udmf::kSideBack:
-                    side1 = lex.state_.number;
-                    break;
-                case udmf::kAlpha:
-                    alpha = lex.state_.decimal;
-                    break;
-                case udmf::kBlocking:
-                    flags |= (lex.state_.boolean ? kLineFlagBlocking : 0);
-                    break;
-                case udmf::kBlockMonsters:
-                    flags |= (lex.state_.boolean ? kLineFlagBlockMonsters : 0);
-                    break;
-                case udmf::kTwoSided:
-                    flags |= (lex.state_.boolean ? kLineFlagTwoSided : 0);
-                    break;
-                case udmf::kDontPegTop:
-                    flags |= (lex.state_.boolean ? kLineFlagUpperUnpegged : 0);
-                    break;
-                case udmf::kDontPegBottom:
-                    flags |= (lex.state_.boolean ? kLineFlagLowerUnpegged : 0);
-                    break;
-                case udmf::kSecret:
-                    flags |= (lex.state_.boolean ? kLineFlagSecret : 0);
-                    break;
-                case udmf::kBlockSound:
-                    flags |= (lex.state_.boolean ? kLineFlagSoundBlock : 0);
-                    break;
-                case udmf::kDontDraw:
-                    flags |= (lex.state_.boolean ? kLineFlagDontDraw : 0);
-                    break;
-                case udmf::kMapped:
-                    flags |= (lex.state_.boolean ? kLineFlagMapped : 0);
-                    break;
-                case udmf::kPassUse:
-                    flags |= (lex.state_.boolean ? kLineFlagBoomPassThrough : 0);
-                    break;
-                case udmf::kBlockPlayers:
-                    flags |= (lex.state_.boolean ? kLineFlagBlockPlayers : 0);
-                    break;
-                case udmf::kBlockSight:
-                    flags |= (lex.state_.boolean ? kLineFlagSightBlock : 0);
-                    break;
-                default:
-                    break;
-                }
+            case udmf::kID:
+                tag = udmf_textmap.Number(*field);
+                break;
+            case udmf::kArg0:
+                arg0 = udmf_textmap.Number(*field);
+                break;
+            case udmf::kV1:
+                v1 = udmf_textmap.Number(*field);
+                break;
+            case udmf::kV2:
+                v2 = udmf_textmap.Number(*field);
+                break;
+            case udmf::kSpecial:
+                special = udmf_textmap.Number(*field);
+                break;
+            case udmf::kSideFront:
+                side0 = udmf_textmap.Number(*field);
+                break;
+            case udmf::kSideBack:
+                side1 = udmf_textmap.Number(*field);
+                break;
+            case udmf::kAlpha:
+                alpha = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kBlocking:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagBlocking : 0);
+                break;
+            case udmf::kBlockMonsters:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagBlockMonsters : 0);
+                break;
+            case udmf::kTwoSided:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagTwoSided : 0);
+                break;
+            case udmf::kDontPegTop:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagUpperUnpegged : 0);
+                break;
+            case udmf::kDontPegBottom:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagLowerUnpegged : 0);
+                break;
+            case udmf::kSecret:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagSecret : 0);
+                break;
+            case udmf::kBlockSound:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagSoundBlock : 0);
+                break;
+            case udmf::kDontDraw:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagDontDraw : 0);
+                break;
+            case udmf::kMapped:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagMapped : 0);
+                break;
+            case udmf::kPassUse:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagBoomPassThrough : 0);
+                break;
+            case udmf::kBlockPlayers:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagBlockPlayers : 0);
+                break;
+            case udmf::kBlockSight:
+                flags |= (udmf_textmap.Boolean(*field) ? kLineFlagSightBlock : 0);
+                break;
+            default:
+                break;
             }
-            Line *ld = level_lines + cur_line;
+        }
+        Line *ld = level_lines + cur_line;
 
-            ld->flags = flags;
-            ld->tag   = HMM_MAX(0, tag);
-            if (id_arg0_split)
-                ld->arg0 = HMM_MAX(0, arg0);
-            else
-                ld->arg0 = ld->tag;
-            ld->vertex_1 = &level_vertexes[v1];
-            ld->vertex_2 = &level_vertexes[v2];
+        ld->flags = flags;
+        ld->tag   = HMM_MAX(0, tag);
+        if (id_arg0_split)
+            ld->arg0 = HMM_MAX(0, arg0);
+        else
+            ld->arg0 = ld->tag;
+        ld->vertex_1 = &level_vertexes[v1];
+        ld->vertex_2 = &level_vertexes[v2];
 
-            ld->special = LookupLineType(HMM_MAX(0, special));
+        ld->special = LookupLineType(HMM_MAX(0, special));
 
-            if (ld->special && ld->special->type_ == kLineTriggerWalkable)
-                ld->flags |= kLineFlagBoomPassThrough;
+        if (ld->special && ld->special->type_ == kLineTriggerWalkable)
+            ld->flags |= kLineFlagBoomPassThrough;
 
-            if (ld->special && ld->special->type_ == kLineTriggerNone &&
-                (ld->special->s_xspeed_ || ld->special->s_yspeed_ || ld->special->scroll_type_ > BoomScrollerTypeNone ||
-                 ld->special->line_effect_ == kLineEffectTypeVectorScroll ||
-                 ld->special->line_effect_ == kLineEffectTypeOffsetScroll ||
-                 ld->special->line_effect_ == kLineEffectTypeTaggedOffsetScroll))
-                ld->flags |= kLineFlagBoomPassThrough;
+        if (ld->special && ld->special->type_ == kLineTriggerNone &&
+            (ld->special->s_xspeed_ || ld->special->s_yspeed_ || ld->special->scroll_type_ > BoomScrollerTypeNone ||
+             ld->special->line_effect_ == kLineEffectTypeVectorScroll ||
+             ld->special->line_effect_ == kLineEffectTypeOffsetScroll ||
+             ld->special->line_effect_ == kLineEffectTypeTaggedOffsetScroll))
+            ld->flags |= kLineFlagBoomPassThrough;
 
-            if (ld->special && ld->special->slope_type_ & kSlopeTypeDetailFloor)
-                ld->flags |= kLineFlagBoomPassThrough;
+        if (ld->special && ld->special->slope_type_ & kSlopeTypeDetailFloor)
+            ld->flags |= kLineFlagBoomPassThrough;
 
-            if (ld->special && ld->special->slope_type_ & kSlopeTypeDetailCeiling)
-                ld->flags |= kLineFlagBoomPassThrough;
+        if (ld->special && ld->special->slope_type_ & kSlopeTypeDetailCeiling)
+            ld->flags |= kLineFlagBoomPassThrough;
 
-            if (ld->special && ld->special == linetypes.Lookup(0)) // Add passthru to unknown/templated
-                ld->flags |= kLineFlagBoomPassThrough;
+        if (ld->special && ld->special == linetypes.Lookup(0)) // Add passthru to unknown/templated
+            ld->flags |= kLineFlagBoomPassThrough;
 
-            ComputeLinedefData(ld, side0, side1);
+        ComputeLinedefData(ld, side0, side1);
 
-            if (ld->tag && ld->special && ld->special->ef_.type_)
+        if (ld->tag && ld->special && ld->special->ef_.type_)
+        {
+            for (int j = 0; j < total_level_sectors; j++)
             {
-                for (int j = 0; j < total_level_sectors; j++)
-                {
-                    if (level_sectors[j].tag != ld->tag)
-                        continue;
+                if (level_sectors[j].tag != ld->tag)
+                    continue;
 
-                    level_sectors[j].extrafloor_maximum++;
-                    total_level_extrafloors++;
-                }
+                level_sectors[j].extrafloor_maximum++;
+                total_level_extrafloors++;
             }
+        }
 
-            BlockmapAddLine(ld);
+        BlockmapAddLine(ld);
 
-            level_line_alphas[ld - level_lines] = alpha;
+        level_line_alphas[ld - level_lines] = alpha;
 
-            cur_line++;
-        }
-        else // consume other blocks
-        {
-            for (;;)
-            {
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    break;
-            }
-        }
+        cur_line++;
     }
     EPI_ASSERT(cur_line == total_level_lines);
 
@@ -2268,240 +2048,184 @@ static void LoadUDMFLineDefs()
 
 static void LoadUDMFThings()
 {
-    epi::Scanner lex(udmf_lump);
-
     LogDebug("LoadUDMFThings: parsing TEXTMAP\n");
-    while (lex.TokensLeft())
+    for (const epi::UDMFBlock &block : udmf_textmap.Blocks())
     {
-        std::string section;
+        if (block.name != udmf::kThing)
+            continue;
 
-        if (!lex.GetNextToken())
-            break;
+        float                      x = 0.0f, y = 0.0f, z = 0.0f;
+        BAMAngle                   angle     = kBAMAngle0;
+        int                        options   = kThingNotSinglePlayer | kThingNotDeathmatch | kThingNotCooperative;
+        int                        typenum   = -1;
+        int                        tag       = 0;
+        float                      healthfac = 1.0f;
+        float                      alpha     = 1.0f;
+        float                      scale = 0.0f, scalex = 0.0f, scaley = 0.0f;
+        const MapObjectDefinition *objtype;
 
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
+        const epi::UDMFField *field = udmf_textmap.BlockFields(block);
 
-        // check namespace
-        if (lex.CheckToken('='))
+        for (uint32_t i = 0; i < block.total_fields; i++, field++)
         {
-            lex.GetNextToken();
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
-            continue;
+            switch (field->key)
+            {
+            case udmf::kID:
+                tag = udmf_textmap.Number(*field);
+                break;
+            case udmf::kX:
+                x = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kY:
+                y = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kHeight:
+                z = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kAngle:
+                angle = epi::BAMFromDegrees(udmf_textmap.Number(*field));
+                break;
+            case udmf::kType:
+                typenum = udmf_textmap.Number(*field);
+                break;
+            case udmf::kSkill1:
+                options |= (udmf_textmap.Boolean(*field) ? kThingEasy : 0);
+                break;
+            case udmf::kSkill2:
+                options |= (udmf_textmap.Boolean(*field) ? kThingEasy : 0);
+                break;
+            case udmf::kSkill3:
+                options |= (udmf_textmap.Boolean(*field) ? kThingMedium : 0);
+                break;
+            case udmf::kSkill4:
+                options |= (udmf_textmap.Boolean(*field) ? kThingHard : 0);
+                break;
+            case udmf::kSkill5:
+                options |= (udmf_textmap.Boolean(*field) ? kThingHard : 0);
+                break;
+            case udmf::kAmbush:
+                options |= (udmf_textmap.Boolean(*field) ? kThingAmbush : 0);
+                break;
+            case udmf::kSingle:
+                options &= (udmf_textmap.Boolean(*field) ? ~kThingNotSinglePlayer : options);
+                break;
+            case udmf::kDM:
+                options &= (udmf_textmap.Boolean(*field) ? ~kThingNotDeathmatch : options);
+                break;
+            case udmf::kCoop:
+                options &= (udmf_textmap.Boolean(*field) ? ~kThingNotCooperative : options);
+                break;
+            case udmf::kFriend:
+                options |= (udmf_textmap.Boolean(*field) ? kThingFriend : 0);
+                break;
+            case udmf::kHealth:
+                healthfac = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kAlpha:
+                alpha = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kScale:
+                scale = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kScaleX:
+                scalex = udmf_textmap.Decimal(*field);
+                break;
+            case udmf::kScaleY:
+                scaley = udmf_textmap.Decimal(*field);
+                break;
+            default:
+                break;
+            }
         }
+        objtype = mobjtypes.Lookup(typenum);
 
-        section = lex.state_.string;
+        // MOBJTYPE not found, don't crash out: JDS Compliance.
+        // -ACB- 1998/07/21
+        if (objtype == nullptr)
+        {
+            UnknownThingWarning(typenum, x, y);
+            continue;
+        }
 
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
+        Sector *sec = PointInSubsector(x, y)->sector;
 
-        if (section == "thing")
+        if ((objtype->hyper_flags_ & kHyperFlagMusicChanger) && !musinfo_tracks[current_map->name_].processed)
         {
-            float                      x = 0.0f, y = 0.0f, z = 0.0f;
-            BAMAngle                   angle     = kBAMAngle0;
-            int                        options   = kThingNotSinglePlayer | kThingNotDeathmatch | kThingNotCooperative;
-            int                        typenum   = -1;
-            int                        tag       = 0;
-            float                      healthfac = 1.0f;
-            float                      alpha     = 1.0f;
-            float                      scale = 0.0f, scalex = 0.0f, scaley = 0.0f;
-            const MapObjectDefinition *objtype;
-            for (;;)
+            // This really should only be used with the original DoomEd
+            // number range
+            if (objtype->number_ >= 14100 && objtype->number_ < 14165)
             {
-                if (lex.CheckToken('}'))
-                    break;
-
-                std::string key;
-                std::string value;
-
-                if (!lex.GetNextToken())
-                    FatalError("Malformed TEXTMAP lump: unclosed block\n");
-
-                if (lex.state_.token != epi::Scanner::kIdentifier)
-                    FatalError("Malformed TEXTMAP lump: missing key\n");
-
-                key = lex.state_.string;
-
-                if (!lex.CheckToken('='))
-                    FatalError("Malformed TEXTMAP lump: missing '='\n");
-
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    FatalError("Malformed TEXTMAP lump: missing value\n");
-
-                value = lex.state_.string;
-
-                if (!lex.CheckToken(';'))
-                    FatalError("Malformed TEXTMAP lump: missing ';'\n");
-
-                epi::StringHash key_hash(key);
+                int mus_number = -1;
 
-                switch (key_hash.Value())
+                if (objtype->number_ == 14100) // Default for level
+                    mus_number = current_map->music_;
+                else if (musinfo_tracks[current_map->name_].mappings.count(objtype->number_ - 14100))
                 {
-                case udmf::kID:
-                    tag = lex.state_.number;
-                    break;
-                case udmf::kX:
-                    x = lex.state_.decimal;
-                    break;
-                case udmf::kY:
-                    y = lex.state_.decimal;
-                    break;
-                case udmf::kHeight:
-                    z = lex.state_.decimal;
-                    break;
-                case udmf::kAngle:
-                    angle = epi::BAMFromDegrees(lex.state_.number);
-                    break;
-                case udmf::kType:
-                    typenum = lex.state_.number;
-                    break;
-                case udmf::kSkill1:
-                    options |= (lex.state_.boolean ? kThingEasy : 0);
-                    break;
-                case udmf::kSkill2:
-                    options |= (lex.state_.boolean ? kThingEasy : 0);
-                    break;
-                case udmf::kSkill3:
-                    options |= (lex.state_.boolean ? kThingMedium : 0);
-                    break;
-                case udmf::kSkill4:
-                    options |= (lex.state_.boolean ? kThingHard : 0);
-                    break;
-                case udmf::kSkill5:
-                    options |= (lex.state_.boolean ? kThingHard : 0);
-                    break;
-                case udmf::kAmbush:
-                    options |= (lex.state_.boolean ? kThingAmbush : 0);
-                    break;
-                case udmf::kSingle:
-                    options &= (lex.state_.boolean ? ~kThingNotSinglePlayer : options);
-                    break;
-                case udmf::kDM:
-                    options &= (lex.state_.boolean ? ~kThingNotDeathmatch : options);
-                    break;
-                case udmf::kCoop:
-                    options &= (lex.state_.boolean ? ~kThingNotCooperative : options);
-                    break;
-                case udmf::kFriend:
-                    options |= (lex.state_.boolean ? kThingFriend : 0);
-                    break;
-                case udmf::kHealth:
-                    healthfac = lex.state_.decimal;
-                    break;
-                case udmf::kAlpha:
-                    alpha = lex.state_.decimal;
-                    break;
-                case udmf::kScale:
-                    scale = lex.state_.decimal;
-                    break;
-                case udmf::kScaleX:
-                    scalex = lex.state_.decimal;
-                    break;
-                case udmf::kScaleY:
-                    scaley = lex.state_.decimal;
-                    break;
-                default:
-                    break;
+                    mus_number = musinfo_tracks[current_map->name_].mappings[objtype->number_ - 14100];
                 }
-            }
-            objtype = mobjtypes.Lookup(typenum);
-
-            // MOBJTYPE not found, don't crash out: JDS Compliance.
-            // -ACB- 1998/07/21
-            if (objtype == nullptr)
-            {
-                UnknownThingWarning(typenum, x, y);
-                continue;
-            }
-
-            Sector *sec = PointInSubsector(x, y)->sector;
-
-            if ((objtype->hyper_flags_ & kHyperFlagMusicChanger) && !musinfo_tracks[current_map->name_].processed)
-            {
-                // This really should only be used with the original DoomEd
-                // number range
-                if (objtype->number_ >= 14100 && objtype->number_ < 14165)
+                // Track found; make ad-hoc RTS script for music changing
+                if (mus_number != -1)
                 {
-                    int mus_number = -1;
-
-                    if (objtype->number_ == 14100) // Default for level
-                        mus_number = current_map->music_;
-                    else if (musinfo_tracks[current_map->name_].mappings.count(objtype->number_ - 14100))
-                    {
-                        mus_number = musinfo_tracks[current_map->name_].mappings[objtype->number_ - 14100];
-                    }
-                    // Track found; make ad-hoc RTS script for music changing
-                    if (mus_number != -1)
-                    {
-                        std::string mus_rts = "// MUSINFO SCRIPTS\n\n";
-                        mus_rts.append(epi::StringFormat("START_MAP %s\n", current_map->name_.c_str()));
-                        mus_rts.append(epi::StringFormat("  SECTOR_TRIGGER_INDEX %td\n", sec - level_sectors));
-                        mus_rts.append("    TAGGED_INDEPENDENT\n");
-                        mus_rts.append("    TAGGED_REPEATABLE\n");
-                        mus_rts.append("    WAIT 30T\n");
-                        mus_rts.append(epi::StringFormat("    CHANGE_MUSIC %d\n", mus_number));
-                        mus_rts.append("    RETRIGGER\n");
-                        mus_rts.append("  END_SECTOR_TRIGGER\n");
-                        mus_rts.append("END_MAP\n\n");
-                        ReadRADScript(mus_rts, "MUSINFO");
-                    }
+                    std::string mus_rts = "// MUSINFO SCRIPTS\n\n";
+                    mus_rts.append(epi::StringFormat("START_MAP %s\n", current_map->name_.c_str()));
+                    mus_rts.append(epi::StringFormat("  SECTOR_TRIGGER_INDEX %td\n", sec - level_sectors));
+                    mus_rts.append("    TAGGED_INDEPENDENT\n");
+                    mus_rts.append("    TAGGED_REPEATABLE\n");
+                    mus_rts.append("    WAIT 30T\n");
+                    mus_rts.append(epi::StringFormat("    CHANGE_MUSIC %d\n", mus_number));
+                    mus_rts.append("    RETRIGGER\n");
+                    mus_rts.append("  END_SECTOR_TRIGGER\n");
+                    mus_rts.append("END_MAP\n\n");
+                    ReadRADScript(mus_rts, "MUSINFO");
                 }
             }
+        }
 
-            if (objtype->flags_ & kMapObjectFlagSpawnCeiling)
-                z += sec->ceiling_height - objtype->height_;
-            else
-                z += sec->floor_height;
+        if (objtype->flags_ & kMapObjectFlagSpawnCeiling)
+            z += sec->ceiling_height - objtype->height_;
+        else
+            z += sec->floor_height;
 
-            MapObject *udmf_thing = SpawnMapThing(objtype, x, y, z, sec, angle, options, tag);
+        MapObject *udmf_thing = SpawnMapThing(objtype, x, y, z, sec, angle, options, tag);
 
-            // check for UDMF-specific thing stuff
-            if (udmf_thing)
+        // check for UDMF-specific thing stuff
+        if (udmf_thing)
+        {
+            udmf_thing->target_visibility_ = alpha;
+            udmf_thing->alpha_             = alpha;
+            if (!AlmostEquals(healthfac, 1.0f))
             {
-                udmf_thing->target_visibility_ = alpha;
-                udmf_thing->alpha_             = alpha;
-                if (!AlmostEquals(healthfac, 1.0f))
-                {
-                    if (healthfac < 0)
-                    {
-                        udmf_thing->spawn_health_ = fabs(healthfac);
-                        udmf_thing->health_       = fabs(healthfac);
-                    }
-                    else
-                    {
-                        udmf_thing->spawn_health_ *= healthfac;
-                        udmf_thing->health_ *= healthfac;
-                    }
-                }
-                // Treat 'scale' and 'scalex/scaley' as one or the other; don't
-                // try to juggle both
-                if (!AlmostEquals(scale, 0.0f))
+                if (healthfac < 0)
                 {
-                    udmf_thing->scale_ = udmf_thing->model_scale_ = scale;
-                    udmf_thing->height_ *= scale;
-                    udmf_thing->radius_ *= scale;
+                    udmf_thing->spawn_health_ = fabs(healthfac);
+                    udmf_thing->health_       = fabs(healthfac);
                 }
-                else if (!AlmostEquals(scalex, 0.0f) || !AlmostEquals(scaley, 0.0f))
+                else
                 {
-                    float sx           = AlmostEquals(scalex, 0.0f) ? 1.0f : scalex;
-                    float sy           = AlmostEquals(scaley, 0.0f) ? 1.0f : scaley;
-                    udmf_thing->scale_ = udmf_thing->model_scale_ = sy;
-                    udmf_thing->aspect_ = udmf_thing->model_aspect_ = (sx / sy);
-                    udmf_thing->height_ *= sy;
-                    udmf_thing->radius_ *= sx;
+                    udmf_thing->spawn_health_ *= healthfac;
+                    udmf_thing->health_ *= healthfac;
                 }
             }
-
-            total_map_things++;
-        }
-        else // consume other blocks
-        {
-            for (;;)
+            // Treat 'scale' and 'scalex/scaley' as one or the other; don't
+            // try to juggle both
+            if (!AlmostEquals(scale, 0.0f))
             {
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    break;
+                udmf_thing->scale_ = udmf_thing->model_scale_ = scale;
+                udmf_thing->height_ *= scale;
+                udmf_thing->radius_ *= scale;
+            }
+            else if (!AlmostEquals(scalex, 0.0f) || !AlmostEquals(scaley, 0.0f))
+            {
+                float sx           = AlmostEquals(scalex, 0.0f) ? 1.0f : scalex;
+                float sy           = AlmostEquals(scaley, 0.0f) ? 1.0f : scaley;
+                udmf_thing->scale_ = udmf_thing->model_scale_ = sy;
+                udmf_thing->aspect_ = udmf_thing->model_aspect_ = (sx / sy);
+                udmf_thing->height_ *= sy;
+                udmf_thing->radius_ *= sx;
             }
         }
+
+        total_map_things++;
     }
 
     // Mark MUSINFO for this level as done processing, even if it was empty,
@@ -2513,79 +2237,32 @@ static void LoadUDMFThings()
 
 static void LoadUDMFCounts()
 {
-    epi::Scanner lex(udmf_lump);
+    std::string name_space = udmf_textmap.GetNamespace();
 
-    while (lex.TokensLeft())
+    if (!name_space.empty())
     {
-        std::string section;
-
-        if (!lex.GetNextToken())
-            break;
-
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
-
-        section = lex.state_.string;
-
-        // check namespace
-        if (lex.CheckToken('='))
+        if (udmf_strict_namespace.d_)
         {
-            lex.GetNextToken();
-
-            section = lex.state_.string;
-
-            if (udmf_strict_namespace.d_)
+            if (name_space != "doom" && name_space != "heretic" && name_space != "edge-classic" &&
+                name_space != "zdoomtranslated" && name_space != "woof")
             {
-                if (section != "doom" && section != "heretic" && section != "edge-classic" &&
-                    section != "zdoomtranslated" && section != "woof")
-                {
-                    LogWarning("UDMF: %s uses unsupported namespace "
-                               "\"%s\"!\nSupported namespaces are \"doom\", "
-                               "\"heretic\", \"edge-classic\", \"woof\" or "
-                               "\"zdoomtranslated\"!\n",
-                               current_map->lump_.c_str(), section.c_str());
-                }
+                LogWarning("UDMF: %s uses unsupported namespace "
+                           "\"%s\"!\nSupported namespaces are \"doom\", "
+                           "\"heretic\", \"edge-classic\", \"woof\" or "
+                           "\"zdoomtranslated\"!\n",
+                           current_map->lump_.c_str(), name_space.c_str());
             }
-
-            id_arg0_split = (section != "edge-classic");
-
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
-            continue;
-        }
-
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
-
-        epi::StringHash section_hash(section);
-
-        // side counts are computed during linedef loading
-        switch (section_hash.Value())
-        {
-        case udmf::kThing:
-            total_map_things++;
-            break;
-        case udmf::kVertex:
-            total_level_vertexes++;
-            break;
-        case udmf::kSector:
-            total_level_sectors++;
-            break;
-        case udmf::kLinedef:
-            total_level_lines++;
-            break;
-        default:
-            break;
         }
 
-        // ignore block contents
-        for (;;)
-        {
-            if (!lex.GetNextToken() || lex.state_.token == '}')
-                break;
-        }
+        id_arg0_split = (name_space != "edge-classic");
     }
 
+    // side counts are computed during linedef loading
+    total_map_things     = udmf_textmap.CountBlocks(udmf::kThing);
+    total_level_vertexes = udmf_textmap.CountBlocks(udmf::kVertex);
+    total_level_sectors  = udmf_textmap.CountBlocks(udmf::kSector);
+    total_level_lines    = udmf_textmap.CountBlocks(udmf::kLinedef);
+
     // initialize arrays
     level_vertexes = new Vertex[total_level_vertexes];
     level_sectors  = new Sector[total_level_sectors];
@@ -2669,7 +2346,7 @@ static void LoadSideDefs(int lump)
 
     EPI_CLEAR_MEMORY(level_sides, Side, total_level_sides);
 
-    data = LoadLumpIntoMemory(lump);
+    data = LoadLumpView(lump);
     msd  = (const RawSidedef *)data;
 
     sd = level_sides;
@@ -2715,7 +2392,7 @@ static void LoadSideDefs(int lump)
 
     EPI_ASSERT(sd == level_sides + total_level_sides);
 
-    delete[] data;
+    ReleaseLumpView(lump, data);
 }
 
 //
@@ -3478,6 +3155,9 @@ void LevelSetup(void)
         if (udmf_lump.empty())
             FatalError("Internal error: can't load UDMF lump.\n");
         delete[] raw_udmf;
+
+        if (!udmf_textmap.Parse(udmf_lump))
+            FatalError("Bad Level: %s: %s\n", current_map->lump_.c_str(), udmf_textmap.GetError().c_str());
     }
     else
     {
@@ -3534,6 +3214,8 @@ void LevelSetup(void)
 
     GroupLines();
 
+    CreateSightTable(udmf_level ? -1 : lumpnum + kLumpReject);
+
     DetectDeepWaterTrick();
 
     ComputeSkyHeights();
@@ -3561,8 +3243,15 @@ void LevelSetup(void)
     if (!udmf_level)
         LoadThings(lumpnum + kLumpThings);
     else
+    {
         LoadUDMFThings();
 
+        // the text and its table are not needed once the level is built
+        udmf_textmap.Clear();
+        udmf_lump.clear();
+        udmf_lump.shrink_to_fit();
+    }
+
         // OK, CRC values have now been computed
 #ifdef DEVELOPERS
     LogDebug("MAP CRCS: S=%08x L=%08x T=%08x\n", map_sectors_crc.crc, map_lines_crc.crc, map_things_crc.crc);
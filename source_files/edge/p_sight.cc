@@ -37,9 +37,11 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "AlmostEquals.h"
+#include "con_var.h"
 #include "dm_defs.h"
 #include "epi.h"
 #include "epi_doomdefs.h"
@@ -47,10 +49,13 @@
 #include "p_local.h"
 #include "r_misc.h"
 #include "r_state.h"
+#include "w_wad.h"
 
 #define EDGE_DEBUG_SIGHT 0
 
 extern unsigned int root_node;
+extern int          total_level_segs;
+extern Seg         *level_segs;
 
 struct LineOfSight
 {
@@ -418,6 +423,409 @@ static bool CheckSightSameSubsector(MapObject *src, MapObject *dest)
     return false;
 }
 
+//
+// Sector visibility table
+//
+// Built once per level as a bit matrix laid out like the REJECT lump,
+// where a set bit means the two sectors can never see each other.  A
+// REJECT lump of the right size is used as-is.  Otherwise (UDMF maps, or
+// a missing or short lump) the table is computed by flooding out of each
+// sector through the portals between subsectors (two-sided segs and
+// minisegs), keeping only the part of each portal that a straight line
+// through the first portal can still reach.  Heights and blocking flags
+// are ignored, so the computed table never rejects a pair that the full
+// check below could find a line of sight between.  The one exception is
+// a line grazing a corner where nothing but walls meet.
+//
+
+EDGE_DEFINE_CONSOLE_VARIABLE(sight_use_reject, "1", kConsoleVariableFlagArchive)
+
+// beyond this many sectors the table would take too much memory
+static constexpr int kSightTableMaximumSectors = 8192;
+
+// portal visits allowed when flooding out of one sector, and for the
+// whole level.  Past either limit a sector is assumed to see everything
+// it is connected to.
+static constexpr int kSightFloodSectorBudget = 4096;
+static constexpr int kSightFloodLevelBudget  = 4000000;
+
+static constexpr double kSightFloodEpsilon = 0.01;
+
+static std::vector<uint8_t> sight_reject;
+
+struct SightPortal
+{
+    // subsector indices, the portal is crossed from right to left
+    int from;
+    int to;
+
+    // portal going the other way, or -1
+    int reverse;
+
+    double x1, y1;
+    double x2, y2;
+};
+
+// part of a portal reached by the current flood, as a range along it
+struct SightPortalRange
+{
+    int    stamp;
+    double low;
+    double high;
+};
+
+static std::vector<SightPortal>      sight_portals;
+static std::vector<int>              sight_portal_first; // per subsector, plus one
+static std::vector<SightPortalRange> sight_portal_ranges;
+
+static inline bool RejectBitSet(int s1, int s2)
+{
+    size_t bit = (size_t)s1 * (size_t)total_level_sectors + (size_t)s2;
+
+    return (sight_reject[bit >> 3] & (1 << (bit & 7))) != 0;
+}
+
+static inline void SetSightBit(int s1, int s2)
+{
+    size_t bit = (size_t)s1 * (size_t)total_level_sectors + (size_t)s2;
+
+    sight_reject[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+}
+
+static bool LoadSightReject(int lump)
+{
+    if (lump < 0 || !IsLumpIndexValid(lump) || !VerifyLump(lump, "REJECT"))
+        return false;
+
+    size_t need   = ((size_t)total_level_sectors * (size_t)total_level_sectors + 7) / 8;
+    int    length = GetLumpLength(lump);
+
+    if (length <= 0 || (size_t)length < need)
+    {
+        LogDebug("REJECT lump is too short, computing sight table instead.\n");
+        return false;
+    }
+
+    const uint8_t *data = LoadLumpView(lump);
+
+    sight_reject.assign(data, data + need);
+
+    ReleaseLumpView(lump, data);
+
+    return true;
+}
+
+static void CreateSightPortals()
+{
+    sight_portals.clear();
+    sight_portal_first.assign(total_level_subsectors + 1, 0);
+
+    std::vector<int> seg_portals(total_level_segs, -1);
+
+    for (int i = 0; i < total_level_subsectors; i++)
+    {
+        sight_portal_first[i] = (int)sight_portals.size();
+
+        for (Seg *seg = level_subsectors[i].segs; seg; seg = seg->subsector_next)
+        {
+            if (!seg->partner || !seg->partner->front_subsector)
+                continue;
+
+            SightPortal portal;
+
+            portal.from    = i;
+            portal.to      = seg->partner->front_subsector - level_subsectors;
+            portal.reverse = -1;
+            portal.x1      = seg->vertex_1->X;
+            portal.y1      = seg->vertex_1->Y;
+            portal.x2      = seg->vertex_2->X;
+            portal.y2      = seg->vertex_2->Y;
+
+            seg_portals[seg - level_segs] = (int)sight_portals.size();
+            sight_portals.push_back(portal);
+        }
+    }
+
+    sight_portal_first[total_level_subsectors] = (int)sight_portals.size();
+
+    for (int i = 0; i < total_level_segs; i++)
+    {
+        if (seg_portals[i] >= 0)
+            sight_portals[seg_portals[i]].reverse = seg_portals[level_segs[i].partner - level_segs];
+    }
+
+    sight_portal_ranges.assign(sight_portals.size(), SightPortalRange{-1, 0, 0});
+}
+
+//
+// Narrows [low, high] along the portal to the part left of the line
+// through (x, y) going along (dx, dy).  Returns false when nothing is
+// left.
+//
+static bool ClipSightRange(const SightPortal &portal, double x, double y, double dx, double dy, double &low,
+                           double &high)
+{
+    double len = sqrt(dx * dx + dy * dy);
+
+    if (len < kSightFloodEpsilon)
+        return low <= high;
+
+    double d1 = (dx * (portal.y1 - y) - dy * (portal.x1 - x)) / len + kSightFloodEpsilon;
+    double d2 = (dx * (portal.y2 - y) - dy * (portal.x2 - x)) / len + kSightFloodEpsilon;
+
+    if (d1 < 0 && d2 < 0)
+        return false;
+
+    if (d1 < 0)
+        low = HMM_MAX(low, d1 / (d1 - d2));
+    else if (d2 < 0)
+        high = HMM_MIN(high, d1 / (d1 - d2));
+
+    return low <= high;
+}
+
+//
+// Clips by the line through (ax, ay) and (px, py) if it separates the
+// first portal (ax..bx) from the portal just passed (px..qx), keeping
+// the side the passed portal is on.
+//
+static bool ClipSightSeparator(const SightPortal &portal, double ax, double ay, double bx, double by, double px,
+                               double py, double qx, double qy, double &low, double &high)
+{
+    double dx  = px - ax;
+    double dy  = py - ay;
+    double len = sqrt(dx * dx + dy * dy);
+
+    if (len < kSightFloodEpsilon)
+        return low <= high;
+
+    double side_a = (dx * (by - ay) - dy * (bx - ax)) / len;
+    double side_p = (dx * (qy - ay) - dy * (qx - ax)) / len;
+
+    bool left  = side_a <= kSightFloodEpsilon && side_p >= -kSightFloodEpsilon;
+    bool right = side_a >= -kSightFloodEpsilon && side_p <= kSightFloodEpsilon;
+
+    if (left == right)
+        return low <= high;
+
+    if (left)
+        return ClipSightRange(portal, ax, ay, dx, dy, low, high);
+
+    return ClipSightRange(portal, ax, ay, -dx, -dy, low, high);
+}
+
+//
+// Marks in "seen" every sector reachable by a straight line crossing
+// the given portal.  Returns false if it ran out of budget.
+//
+static bool FloodSightPortal(int first, int stamp, std::vector<uint8_t> &seen, int &budget)
+{
+    const SightPortal &start = sight_portals[first];
+
+    std::vector<int> pending;
+
+    sight_portal_ranges[first] = SightPortalRange{stamp, 0, 1};
+    pending.push_back(first);
+
+    seen[level_subsectors[start.to].sector - level_sectors] = 1;
+
+    while (!pending.empty())
+    {
+        if (--budget < 0)
+            return false;
+
+        int index = pending.back();
+        pending.pop_back();
+
+        const SightPortal      &pass  = sight_portals[index];
+        const SightPortalRange &range = sight_portal_ranges[index];
+
+        double px = pass.x1 + (pass.x2 - pass.x1) * range.low;
+        double py = pass.y1 + (pass.y2 - pass.y1) * range.low;
+        double qx = pass.x1 + (pass.x2 - pass.x1) * range.high;
+        double qy = pass.y1 + (pass.y2 - pass.y1) * range.high;
+
+        for (int k = sight_portal_first[pass.to]; k < sight_portal_first[pass.to + 1]; k++)
+        {
+            if (k == pass.reverse)
+                continue;
+
+            const SightPortal &portal = sight_portals[k];
+
+            double low  = 0;
+            double high = 1;
+
+            if (!ClipSightRange(portal, pass.x1, pass.y1, pass.x2 - pass.x1, pass.y2 - pass.y1, low, high))
+                continue;
+
+            if (index != first)
+            {
+                if (!ClipSightRange(portal, start.x1, start.y1, start.x2 - start.x1, start.y2 - start.y1, low, high))
+                    continue;
+
+                if (!ClipSightSeparator(portal, start.x1, start.y1, start.x2, start.y2, px, py, qx, qy, low, high) ||
+                    !ClipSightSeparator(portal, start.x1, start.y1, start.x2, start.y2, qx, qy, px, py, low, high) ||
+                    !ClipSightSeparator(portal, start.x2, start.y2, start.x1, start.y1, px, py, qx, qy, low, high) ||
+                    !ClipSightSeparator(portal, start.x2, start.y2, start.x1, start.y1, qx, qy, px, py, low, high))
+                    continue;
+            }
+
+            seen[level_subsectors[portal.to].sector - level_sectors] = 1;
+
+            SightPortalRange &reached = sight_portal_ranges[k];
+
+            if (reached.stamp == stamp)
+            {
+                if (low >= reached.low && high <= reached.high)
+                    continue;
+
+                low  = HMM_MIN(low, reached.low);
+                high = HMM_MAX(high, reached.high);
+            }
+
+            reached = SightPortalRange{stamp, low, high};
+            pending.push_back(k);
+        }
+    }
+
+    return true;
+}
+
+static int FindSightGroup(std::vector<int> &groups, int i)
+{
+    while (groups[i] != i)
+    {
+        groups[i] = groups[groups[i]];
+        i         = groups[i];
+    }
+
+    return i;
+}
+
+static void ComputeSightReject()
+{
+    int total = total_level_sectors;
+
+    CreateSightPortals();
+
+    // subsectors joined by portals, for sectors that run out of budget
+    std::vector<int> groups(total_level_subsectors);
+
+    for (int i = 0; i < total_level_subsectors; i++)
+        groups[i] = i;
+
+    for (const SightPortal &portal : sight_portals)
+    {
+        int g1 = FindSightGroup(groups, portal.from);
+        int g2 = FindSightGroup(groups, portal.to);
+
+        if (g1 != g2)
+            groups[HMM_MAX(g1, g2)] = HMM_MIN(g1, g2);
+    }
+
+    for (int i = 0; i < total_level_subsectors; i++)
+        groups[i] = FindSightGroup(groups, i);
+
+    // sight_reject holds which sectors each sector sees until it is flipped below
+    sight_reject.assign(((size_t)total * (size_t)total + 7) / 8, 0);
+
+    std::vector<uint8_t> seen(total);
+    std::vector<uint8_t> group_seen(total_level_subsectors);
+
+    int stamp        = 0;
+    int level_budget = kSightFloodLevelBudget;
+
+    for (int s = 0; s < total; s++)
+    {
+        const Sector *sec = &level_sectors[s];
+
+        std::fill(seen.begin(), seen.end(), 0);
+        seen[s] = 1;
+
+        int  budget   = HMM_MIN(kSightFloodSectorBudget, level_budget);
+        bool complete = true;
+
+        for (const Subsector *sub = sec->subsectors; sub && complete; sub = sub->sector_next)
+        {
+            int i = sub - level_subsectors;
+
+            for (int k = sight_portal_first[i]; k < sight_portal_first[i + 1] && complete; k++)
+            {
+                if (level_subsectors[sight_portals[k].to].sector == sec)
+                    continue;
+
+                complete = FloodSightPortal(k, stamp++, seen, budget);
+            }
+        }
+
+        level_budget -= HMM_MIN(kSightFloodSectorBudget, level_budget) - HMM_MAX(budget, 0);
+
+        if (!complete)
+        {
+            std::fill(group_seen.begin(), group_seen.end(), 0);
+
+            for (const Subsector *sub = sec->subsectors; sub; sub = sub->sector_next)
+                group_seen[groups[sub - level_subsectors]] = 1;
+
+            for (int i = 0; i < total_level_subsectors; i++)
+            {
+                if (group_seen[groups[i]])
+                    seen[level_subsectors[i].sector - level_sectors] = 1;
+            }
+        }
+
+        for (int s2 = 0; s2 < total; s2++)
+        {
+            if (seen[s2])
+                SetSightBit(s, s2);
+        }
+    }
+
+    // a pair is rejected only when neither sector saw the other
+    for (int s1 = 0; s1 < total; s1++)
+    {
+        for (int s2 = s1 + 1; s2 < total; s2++)
+        {
+            if (RejectBitSet(s1, s2) || RejectBitSet(s2, s1))
+            {
+                SetSightBit(s1, s2);
+                SetSightBit(s2, s1);
+            }
+        }
+    }
+
+    for (uint8_t &bits : sight_reject)
+        bits = (uint8_t)~bits;
+
+    sight_portals.clear();
+    sight_portal_first.clear();
+    sight_portal_ranges.clear();
+}
+
+void CreateSightTable(int reject_lump)
+{
+    sight_reject.clear();
+
+    if (sight_use_reject.d_ && LoadSightReject(reject_lump))
+        return;
+
+    if (total_level_sectors > kSightTableMaximumSectors)
+    {
+        LogDebug("Too many sectors for a sight table.\n");
+        return;
+    }
+
+    ComputeSightReject();
+}
+
+static inline bool SectorsMaySee(const Sector *src, const Sector *dest)
+{
+    if (sight_reject.empty())
+        return true;
+
+    return !RejectBitSet(src - level_sectors, dest - level_sectors);
+}
+
 bool CheckSight(MapObject *src, MapObject *dest)
 {
     if (!dest)
@@ -437,6 +845,9 @@ bool CheckSight(MapObject *src, MapObject *dest)
     EPI_ASSERT(src->subsector_);
     EPI_ASSERT(dest->subsector_);
 
+    if (!SectorsMaySee(src->subsector_->sector, dest->subsector_->sector))
+        return false;
+
     // An unobstructed LOS is possible.
     // Now look from eyes of t1 to any part of t2.
 
@@ -586,6 +997,9 @@ bool CheckSightToPoint(MapObject *src, float x, float y, float z)
     if (dest_sub == src->subsector_)
         return true;
 
+    if (!SectorsMaySee(src->subsector_->sector, dest_sub->sector))
+        return false;
+
     valid_count++;
 
     sight_check.source.x         = src->x;
@@ -33,6 +33,7 @@
 
 #include "AlmostEquals.h"
 #include "dm_state.h"
+#include "e_profile.h"
 #include "g_game.h"
 #include "n_network.h"
 #include "p_local.h"
@@ -64,38 +65,58 @@ void MapObjectTicker()
 
     erraticism_active = false;
 
-    if (erraticism.d_)
     {
-        bool keep_thinking = PlayerThink(players[console_player]);
+        ProfileScope profile_players(kProfileZonePlayerThink);
 
-        if (!keep_thinking)
+        if (erraticism.d_)
         {
-            erraticism_active = true;
-            return;
+            bool keep_thinking = PlayerThink(players[console_player]);
+
+            if (!keep_thinking)
+            {
+                erraticism_active = true;
+                return;
+            }
+
+            for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+            {
+                if (players[pnum] && players[pnum] != players[console_player])
+                    PlayerThink(players[pnum]);
+            }
         }
-
-        for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+        else
         {
-            if (players[pnum] && players[pnum] != players[console_player])
-                PlayerThink(players[pnum]);
+            for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+                if (players[pnum])
+                    PlayerThink(players[pnum]);
         }
     }
-    else
+
     {
-        for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
-            if (players[pnum])
-                PlayerThink(players[pnum]);
+        ProfileScope profile_scripts(kProfileZoneScriptTriggers);
+        RunScriptTriggers();
     }
 
-    RunScriptTriggers();
+    {
+        ProfileScope profile_forces(kProfileZoneForces);
+        RunForces();
+    }
 
-    RunForces();
-    RunMapObjectThinkers();
+    {
+        ProfileScope profile_thinkers(kProfileZoneThinkers);
+        RunMapObjectThinkers();
+    }
 
-    RunLights();
+    {
+        ProfileScope profile_lights(kProfileZoneLights);
+        RunLights();
+    }
 
-    RunActivePlanes();
-    RunActiveSliders();
+    {
+        ProfileScope profile_planes(kProfileZonePlanes);
+        RunActivePlanes();
+        RunActiveSliders();
+    }
 
     RunAmbientSounds();
 
@@ -28,7 +28,6 @@
 
 #include "AlmostEquals.h"
 #include "bot_think.h"
-#include "coal.h"
 #include "ddf_colormap.h"
 #include "ddf_reverb.h"
 #include "dm_state.h"
@@ -49,10 +48,6 @@
 #include "stb_sprintf.h"
 #include "vm_coal.h"
 
-extern coal::VM *ui_vm;
-extern void      COALSetVector(coal::VM *vm, const char *mod_name, const char *var_name, double val_1, double val_2,
-                               double val_3);
-
 EDGE_DEFINE_CONSOLE_VARIABLE(erraticism, "0", kConsoleVariableFlagArchive)
 
 EDGE_DEFINE_CONSOLE_VARIABLE(view_bobbing, "0", kConsoleVariableFlagArchive)
@@ -921,7 +916,7 @@ bool PlayerThink(Player *player)
                                 cmd->extended_buttons & kExtendedButtonCodeInventoryUse ? 1.0f : 0.0f,
                                 cmd->extended_buttons & kExtendedButtonCodeInventoryNext ? 1.0f : 0.0f}});
     else
-        COALSetVector(ui_vm, "player", "inventory_event_handler",
+        COALSetVector(kCOALVariableInventoryEventHandler,
                       cmd->extended_buttons & kExtendedButtonCodeInventoryPrevious ? 1 : 0,
                       cmd->extended_buttons & kExtendedButtonCodeInventoryUse ? 1 : 0,
                       cmd->extended_buttons & kExtendedButtonCodeInventoryNext ? 1 : 0);
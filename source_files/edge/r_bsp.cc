@@ -27,13 +27,16 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "AlmostEquals.h"
 #include "dm_defs.h"
 #include "dm_state.h"
+#include "e_profile.h"
 #include "epi.h"
 #include "epi_doomdefs.h"
 #include "g_game.h"
+#include "i_system.h"
 #include "i_defs_gl.h"
 #include "m_bbox.h"
 #include "n_network.h" // NetworkUpdate
@@ -58,23 +61,22 @@
 #if defined(EDGE_SOKOL)
 #if !defined(EDGE_WEB) || defined(EDGE_WEB_MULTITHREADED)
 #define BSP_MULTITHREAD
-static void BSPQueueRenderBatch(RenderBatch *batch);
 #endif
 static void         BSPQueueDrawSubsector(DrawSubsector *subsector);
 static void         BSPQueueSkyWall(Seg *seg, float h1, float h2);
 static void         BSPQueueSkyPlane(Subsector *sub, float h);
-static RenderBatch *current_batch = nullptr;
+static thread_local RenderBatch *current_batch = nullptr;
 #endif
 
 #ifdef BSP_MULTITHREAD
 #ifdef __APPLE__
+#include <SDL_cpuinfo.h>
 #include <SDL_thread.h>
 #else
+#include <SDL2/SDL_cpuinfo.h>
 #include <SDL2/SDL_thread.h>
 #endif
 
-constexpr int32_t kMaxRenderBatch = 65536 / 4;
-
 struct BSPSignal
 {
     SDL_mutex *mutex;
@@ -123,76 +125,159 @@ static int BSPSignalWait(BSPSignal *sig, int timeout_ms)
     return !timed_out;
 }
 
-struct BSPQueue
+// Batches travel from the traversal thread to the renderer through a
+// bounded single-producer/single-consumer ring.  Each side only ever
+// advances its own index; when the ring is full (or empty) that side
+// sleeps on a condition variable and is woken by the other.  The mutex
+// is only touched on those slow paths.
+constexpr int32_t kBSPQueueSize = 256; // must be a power of two
+
+class BSPRenderQueue
 {
-    BSPSignal    data_ready;
-    BSPSignal    space_open;
-    SDL_atomic_t count;
-    SDL_atomic_t head;
-    SDL_atomic_t tail;
-    void       **values;
-    int          size;
+  public:
+    RenderBatch *slots_[kBSPQueueSize];
+
+    SDL_atomic_t head_; // next slot to read, only written by the consumer
+    SDL_atomic_t tail_; // next slot to write, only written by the producer
+
+    SDL_mutex *mutex_;
+    SDL_cond  *wake_;
+
+    // set (under the mutex) by a side that is about to sleep
+    SDL_atomic_t consumer_waiting_;
+    SDL_atomic_t producer_waiting_;
+
+    // traversal thread time spent blocked on a full ring (microseconds)
+    SDL_atomic_t producer_stall_;
 };
 
-static void BSPQueueInit(BSPQueue *q, int size, void **values, int count)
+struct BSPThread
 {
-    q->values = values;
-    q->size   = size;
-    BSPSignalInit(&q->data_ready);
-    BSPSignalInit(&q->space_open);
-    SDL_AtomicSet(&q->head, 0);
-    SDL_AtomicSet(&q->tail, count > size ? size : count);
-    SDL_AtomicSet(&q->count, count > size ? size : count);
-}
+    SDL_Thread    *thread_;
+    BSPSignal      signal_start_;
+    SDL_atomic_t   traverse_finished_;
+    SDL_atomic_t   exit_flag_;
+    BSPRenderQueue queue_;
+};
+
+static struct BSPThread bsp_thread;
 
-static int BSPQueueProduce(BSPQueue *q, void *value, int timeout_ms)
+// The read-modify-write atomics below are full barriers, so a sleeper
+// that raised its flag either sees the other side's update or gets woken.
+static void BSPQueueWake(SDL_atomic_t *waiting)
 {
-    while (SDL_AtomicGet(&q->count) == q->size)
+    if (SDL_AtomicCAS(waiting, 1, 0))
     {
-        if (timeout_ms == 0)
-            return 0;
-        if (BSPSignalWait(&q->space_open, timeout_ms) == 0)
-            return 0;
+        SDL_LockMutex(bsp_thread.queue_.mutex_);
+        SDL_CondBroadcast(bsp_thread.queue_.wake_);
+        SDL_UnlockMutex(bsp_thread.queue_.mutex_);
     }
-    int tail                  = SDL_AtomicAdd(&q->tail, 1);
-    q->values[tail % q->size] = value;
-    if (SDL_AtomicAdd(&q->count, 1) == 0)
-        BSPSignalRaise(&q->data_ready);
-    return 1;
 }
 
-static void *BSPQueueConsume(BSPQueue *q, int timeout_ms)
+static void BSPQueueInit(void)
 {
-    while (SDL_AtomicGet(&q->count) == 0)
+    BSPRenderQueue *q = &bsp_thread.queue_;
+
+    q->mutex_ = SDL_CreateMutex();
+    q->wake_  = SDL_CreateCond();
+
+    SDL_AtomicSet(&q->head_, 0);
+    SDL_AtomicSet(&q->tail_, 0);
+    SDL_AtomicSet(&q->consumer_waiting_, 0);
+    SDL_AtomicSet(&q->producer_waiting_, 0);
+    SDL_AtomicSet(&q->producer_stall_, 0);
+}
+
+static void BSPQueueTerm(void)
+{
+    SDL_DestroyCond(bsp_thread.queue_.wake_);
+    SDL_DestroyMutex(bsp_thread.queue_.mutex_);
+}
+
+// traversal thread only, blocks while the ring is full
+static void BSPQueueProduce(RenderBatch *batch)
+{
+    BSPRenderQueue *q = &bsp_thread.queue_;
+
+    int tail = SDL_AtomicGet(&q->tail_);
+
+    if (tail - SDL_AtomicGet(&q->head_) == kBSPQueueSize)
     {
-        if (timeout_ms == 0)
-            return nullptr;
-        if (BSPSignalWait(&q->data_ready, timeout_ms) == 0)
-            return nullptr;
+        uint32_t start = GetMicroseconds();
+
+        SDL_LockMutex(q->mutex_);
+
+        for (;;)
+        {
+            SDL_AtomicCAS(&q->producer_waiting_, 0, 1);
+
+            if (tail - SDL_AtomicGet(&q->head_) < kBSPQueueSize)
+                break;
+
+            SDL_CondWait(q->wake_, q->mutex_);
+        }
+
+        SDL_AtomicSet(&q->producer_waiting_, 0);
+
+        SDL_UnlockMutex(q->mutex_);
+
+        SDL_AtomicAdd(&q->producer_stall_, (int)(GetMicroseconds() - start));
     }
-    int   head               = SDL_AtomicAdd(&q->head, 1);
-    void *retval             = q->values[head % q->size];
-    if (SDL_AtomicAdd(&q->count, -1) == q->size)
-        BSPSignalRaise(&q->space_open);
-    return retval;
+
+    q->slots_[tail & (kBSPQueueSize - 1)] = batch;
+
+    SDL_AtomicAdd(&q->tail_, 1);
+
+    BSPQueueWake(&q->consumer_waiting_);
 }
 
-static int BSPQueueCount(BSPQueue *q)
+// main thread only, blocks until a batch is available or the
+// traversal has finished.  Returns false once everything is consumed.
+static bool BSPQueueWait(void)
 {
-    return SDL_AtomicGet(&q->count);
+    BSPRenderQueue *q = &bsp_thread.queue_;
+
+    int head = SDL_AtomicGet(&q->head_);
+
+    if (head != SDL_AtomicGet(&q->tail_))
+        return true;
+
+    ProfileScope profile_wait(kProfileZoneBSPWait);
+
+    SDL_LockMutex(q->mutex_);
+
+    for (;;)
+    {
+        SDL_AtomicCAS(&q->consumer_waiting_, 0, 1);
+
+        if (head != SDL_AtomicGet(&q->tail_) || SDL_AtomicGet(&bsp_thread.traverse_finished_))
+            break;
+
+        SDL_CondWait(q->wake_, q->mutex_);
+    }
+
+    SDL_AtomicSet(&q->consumer_waiting_, 0);
+
+    SDL_UnlockMutex(q->mutex_);
+
+    // the producer publishes its last batch before flagging completion
+    return head != SDL_AtomicGet(&q->tail_);
 }
 
-struct BSPThread
+static RenderBatch *BSPQueueConsume(void)
 {
-    SDL_Thread  *thread_;
-    BSPSignal    signal_start_;
-    SDL_atomic_t traverse_finished_;
-    BSPQueue queue_;
-    RenderBatch *render_queue_[kMaxRenderBatch];
-    SDL_atomic_t exit_flag_;
-};
+    BSPRenderQueue *q = &bsp_thread.queue_;
 
-static struct BSPThread bsp_thread;
+    int head = SDL_AtomicGet(&q->head_);
+
+    RenderBatch *batch = q->slots_[head & (kBSPQueueSize - 1)];
+
+    SDL_AtomicAdd(&q->head_, 1);
+
+    BSPQueueWake(&q->producer_waiting_);
+
+    return batch;
+}
 
 #else
 
@@ -200,7 +285,73 @@ std::list<DrawSubsector *> draw_subsector_list;
 
 #endif
 
-MirrorSet bsp_mirror_set(kMirrorSetBSP);
+#ifdef EDGE_SOKOL
+
+// Storage for the batches of the current traversal, one pool per BSP
+// walking thread.  Blocks are never freed or moved, so the renderer may
+// hold on to item pointers until the next BSPTraverse() resets the pools,
+// however large the view.
+constexpr int32_t kRenderBatchBlockSize = 256;
+
+class RenderBatchPool
+{
+  public:
+    std::vector<RenderBatch *> blocks_;
+    int32_t                    used_ = 0;
+
+    RenderBatch *Get()
+    {
+        size_t block = used_ / kRenderBatchBlockSize;
+
+        if (block == blocks_.size())
+            blocks_.push_back(new RenderBatch[kRenderBatchBlockSize]);
+
+        RenderBatch *batch = &blocks_[block][used_ % kRenderBatchBlockSize];
+
+        used_++;
+
+        EPI_CLEAR_MEMORY(batch, RenderBatch, 1);
+        return batch;
+    }
+
+    RenderBatch *At(int32_t index)
+    {
+        return &blocks_[index / kRenderBatchBlockSize][index % kRenderBatchBlockSize];
+    }
+
+    void Free()
+    {
+        for (size_t i = 0; i < blocks_.size(); i++)
+            delete[] blocks_[i];
+
+        blocks_.clear();
+        used_ = 0;
+    }
+};
+
+#ifdef BSP_MULTITHREAD
+constexpr int kBSPMaximumWalkers = 8; // including the traversal thread
+#else
+constexpr int kBSPMaximumWalkers = 1;
+#endif
+
+static RenderBatchPool               render_batch_pools[kBSPMaximumWalkers];
+static thread_local RenderBatchPool *render_batch_pool = &render_batch_pools[0];
+
+static RenderBatch *GetRenderBatch()
+{
+    return render_batch_pool->Get();
+}
+
+static void FreeRenderBatches()
+{
+    for (int i = 0; i < kBSPMaximumWalkers; i++)
+        render_batch_pools[i].Free();
+}
+
+#endif
+
+thread_local MirrorSet bsp_mirror_set(kMirrorSetBSP);
 
 EDGE_DEFINE_CONSOLE_VARIABLE(debug_hall_of_mirrors, "0", kConsoleVariableFlagCheat)
 
@@ -209,8 +360,8 @@ extern ConsoleVariable draw_culling;
 unsigned int root_node;
 
 // -ES- 1999/03/20 Different right & left side clip angles, for asymmetric FOVs.
-BAMAngle clip_left, clip_right;
-BAMAngle clip_scope;
+thread_local BAMAngle clip_left, clip_right;
+thread_local BAMAngle clip_scope;
 
 MapObject *view_camera_map_object;
 
@@ -230,7 +381,7 @@ ViewHeightZone view_height_zone;
 
 // common stuff
 
-static Subsector *bsp_current_subsector;
+static thread_local Subsector *bsp_current_subsector;
 
 static void BSPWalkMirror(DrawSubsector *dsub, Seg *seg, BAMAngle left, BAMAngle right, bool is_portal)
 {
@@ -570,12 +721,13 @@ static void BSPWalkSeg(DrawSubsector *dsub, Seg *seg)
 //
 static bool BSPCheckBBox(const float *bspcoord)
 {
+    // not static, this may run on several threads at once
+    float new_bbox[4];
+
     if (bsp_mirror_set.TotalActive() > 0)
     {
         // a flipped bbox may no longer be axis aligned, hence we
         // need to find the bounding area of the transformed box.
-        static float new_bbox[4];
-
         BoundingBoxClear(new_bbox);
 
         for (int p = 0; p < 4; p++)
@@ -973,27 +1125,12 @@ static void BSPWalkSubsector(int num)
 }
 
 //
-// BSPWalkNode
+// BSPNodeSide
 //
-// Walks all subsectors below a given node, traversing subtree
-// recursively, collecting information.  Just call with BSP root.
+// Decide which side of the node's partition the view point is on.
 //
-void BSPWalkNode(unsigned int bspnum)
+static int BSPNodeSide(const BSPNode *node)
 {
-    BSPNode *node;
-    int      side;
-
-    // Found a subsector?
-    if (bspnum & kLeafSubsector)
-    {
-        BSPWalkSubsector(bspnum & (~kLeafSubsector));
-        return;
-    }
-
-    node = &level_nodes[bspnum];
-
-    // Decide which side the view point is on.
-
     DividingLine nd_div;
 
     nd_div.x       = node->divider.x;
@@ -1017,7 +1154,27 @@ void BSPWalkNode(unsigned int bspnum)
     nd_div.delta_x -= nd_div.x;
     nd_div.delta_y -= nd_div.y;
 
-    side = PointOnDividingLineSide(view_x, view_y, &nd_div);
+    return PointOnDividingLineSide(view_x, view_y, &nd_div);
+}
+
+//
+// BSPWalkNode
+//
+// Walks all subsectors below a given node, traversing subtree
+// recursively, collecting information.  Just call with BSP root.
+//
+void BSPWalkNode(unsigned int bspnum)
+{
+    // Found a subsector?
+    if (bspnum & kLeafSubsector)
+    {
+        BSPWalkSubsector(bspnum & (~kLeafSubsector));
+        return;
+    }
+
+    BSPNode *node = &level_nodes[bspnum];
+
+    int side = BSPNodeSide(node);
 
     // Recursively divide front space.
     if (BSPCheckBBox(node->bounding_boxes[side]))
@@ -1031,62 +1188,29 @@ void BSPWalkNode(unsigned int bspnum)
 #ifdef EDGE_SOKOL
 
 #ifdef BSP_MULTITHREAD
+// where full batches go: the batch list of a subtree that cannot be
+// passed on yet, or (when null) straight to the render queue
+static thread_local std::vector<RenderBatch *> *walk_output = nullptr;
 
-static int32_t BSPTraverseProc(void *thread_data)
+static void BSPFlushRenderBatch(RenderBatch *batch)
 {
-    EPI_UNUSED(thread_data);
-
-    while (SDL_AtomicGet(&bsp_thread.exit_flag_) == 0)
-    {
-        if (BSPSignalWait(&bsp_thread.signal_start_, -1))
-        {
-            if (SDL_AtomicGet(&bsp_thread.exit_flag_))
-            {
-                break;
-            }
-
-            current_batch = nullptr;
-
-            // walk the bsp tree
-            BSPWalkNode(root_node);
-
-            if (current_batch && current_batch->num_items_)
-            {
-                BSPQueueRenderBatch(current_batch);
-            }
-
-            SDL_AtomicSet(&bsp_thread.traverse_finished_, 1);
-        }
-    }
-
-    return 0;
-}
-
-static RenderBatch render_batches[kMaxRenderBatch];
-static uint32_t    render_batch_counter = 0;
-
-void BSPQueueRenderBatch(RenderBatch *batch)
-{
-    BSPQueueProduce(&bsp_thread.queue_, batch, 100);
-}
-
-// TODO: This isn't really a ring buffer
-static RenderBatch *GetRenderBatch()
-{
-    RenderBatch *batch = &render_batches[render_batch_counter++];
-    EPI_CLEAR_MEMORY(batch, RenderBatch, 1);
-    render_batch_counter %= kMaxRenderBatch;
-    return batch;
+    if (walk_output)
+        walk_output->push_back(batch);
+    else
+        BSPQueueProduce(batch);
 }
+#endif
 
 static RenderItem *GetRenderItem()
 {
     if (!current_batch || current_batch->num_items_ == kRenderItemBatchSize)
     {
+#ifdef BSP_MULTITHREAD
         if (current_batch)
         {
-            BSPQueueRenderBatch(current_batch);
+            BSPFlushRenderBatch(current_batch);
         }
+#endif
 
         current_batch = GetRenderBatch();
     }
@@ -1121,130 +1245,401 @@ void BSPQueueDrawSubsector(DrawSubsector *subsector)
     item->subsector_ = subsector;
 }
 
-RenderBatch *BSPReadRenderBatch()
+#ifdef BSP_MULTITHREAD
+
+//
+// Parallel walk
+//
+// On large maps the tree is split near the root into subtrees, listed in
+// front to back order, which the traversal thread and a pool of walker
+// threads claim in that order.  Each subtree starts out with the
+// occlusion of all the subtrees in front of it that have finished.  That
+// is a subset of what a serial walk would know at that point, so culling
+// can only be more conservative, never wrong.  The traversal thread passes
+// the batches on to the renderer strictly in subtree order.
+//
+
+// 0 = one walker per spare CPU core, 1 = serial walk
+EDGE_DEFINE_CONSOLE_VARIABLE(renderer_bsp_threads, "0", kConsoleVariableFlagArchive)
+
+static constexpr int kBSPParallelMinimumNodes = 4096;
+static constexpr int kBSPJobsPerWalker        = 4;
+
+class BSPWalkJob
 {
-    RenderBatch *batch = (RenderBatch *)BSPQueueConsume(&bsp_thread.queue_, 0);
-    return batch;
-}
+  public:
+    unsigned int               node_;
+    std::vector<RenderBatch *> batches_;
+    std::vector<BAMAngle>      occlusion_; // buffer at the end of the walk
+    bool                       done_;      // guarded by bsp_walk_mutex
+};
 
-static bool traverse_stop_signalled;
+struct BSPWalker
+{
+    SDL_Thread *thread_;
+    BSPSignal   signal_start_;
+};
 
-void BSPTraverse()
+// [0] is the traversal thread itself
+static BSPWalker bsp_walkers[kBSPMaximumWalkers];
+static int       bsp_total_walkers  = 1;
+static int       bsp_active_walkers = 1;
+
+static std::vector<BSPWalkJob> bsp_walk_jobs;
+static int                     bsp_total_walk_jobs = 0;
+static SDL_atomic_t            bsp_next_walk_job;
+
+static SDL_mutex            *bsp_walk_mutex      = nullptr;
+static SDL_cond             *bsp_walk_cond       = nullptr;
+static int                   bsp_walkers_busy    = 0; // guarded by bsp_walk_mutex
+static std::vector<BAMAngle> bsp_front_occlusion;     // ditto
+static int                   bsp_front_walk_jobs = 0; // ditto
+
+// clipping of the view being walked, copied by each walking thread
+static BAMAngle bsp_view_clip_left;
+static BAMAngle bsp_view_clip_right;
+static BAMAngle bsp_view_clip_scope;
+
+static void BSPBeginWalk(void)
 {
-    traverse_stop_signalled = false;
-    SDL_AtomicSet(&bsp_thread.traverse_finished_, 0);
-    BSPSignalRaise(&bsp_thread.signal_start_);
+    clip_left  = bsp_view_clip_left;
+    clip_right = bsp_view_clip_right;
+    clip_scope = bsp_view_clip_scope;
 }
 
-bool BSPTraversing()
+static void BSPRunWalkJob(int index, bool stream)
 {
-    if (!traverse_stop_signalled)
+    BSPWalkJob &job = bsp_walk_jobs[index];
+
+    SDL_LockMutex(bsp_walk_mutex);
+    OcclusionClear();
+    OcclusionMerge(bsp_front_occlusion);
+    SDL_UnlockMutex(bsp_walk_mutex);
+
+    job.batches_.clear();
+
+    walk_output   = stream ? nullptr : &job.batches_;
+    current_batch = nullptr;
+
+    BSPWalkNode(job.node_);
+
+    if (current_batch && current_batch->num_items_)
     {
-        traverse_stop_signalled = !!SDL_AtomicGet(&bsp_thread.traverse_finished_);
+        BSPFlushRenderBatch(current_batch);
     }
 
-    if (!BSPQueueCount(&bsp_thread.queue_) && traverse_stop_signalled)
+    walk_output   = nullptr;
+    current_batch = nullptr;
+
+    OcclusionSave(job.occlusion_);
+
+    SDL_LockMutex(bsp_walk_mutex);
+
+    job.done_ = true;
+
+    // extend the finished front (using our buffer as scratch space)
+    if (bsp_front_walk_jobs == index)
     {
-        return false;
+        OcclusionClear();
+        OcclusionMerge(bsp_front_occlusion);
+
+        while (bsp_front_walk_jobs < bsp_total_walk_jobs && bsp_walk_jobs[bsp_front_walk_jobs].done_)
+        {
+            OcclusionMerge(bsp_walk_jobs[bsp_front_walk_jobs].occlusion_);
+            bsp_front_walk_jobs++;
+        }
+
+        OcclusionSave(bsp_front_occlusion);
     }
 
-    return true;
+    SDL_CondBroadcast(bsp_walk_cond);
+    SDL_UnlockMutex(bsp_walk_mutex);
 }
 
-void BSPStartThread()
+static bool BSPWalkJobDone(int index)
 {
-    SDL_AtomicSet(&bsp_thread.exit_flag_, 0);
-    SDL_AtomicSet(&bsp_thread.traverse_finished_, 1);
-    BSPSignalInit(&bsp_thread.signal_start_);
-    BSPQueueInit(&bsp_thread.queue_, kMaxRenderBatch, (void **)bsp_thread.render_queue_, 0);
-    bsp_thread.thread_ = SDL_CreateThread((SDL_ThreadFunction)BSPTraverseProc, "BSPTraverse", nullptr);
+    SDL_LockMutex(bsp_walk_mutex);
+    bool done = bsp_walk_jobs[index].done_;
+    SDL_UnlockMutex(bsp_walk_mutex);
+
+    return done;
 }
-void BSPStopThread()
+
+static int32_t BSPWalkerProc(void *thread_data)
 {
-    SDL_AtomicSet(&bsp_thread.exit_flag_, 1);
-    BSPSignalRaise(&bsp_thread.signal_start_);
-    SDL_WaitThread(bsp_thread.thread_, nullptr);
-    BSPSignalTerm(&bsp_thread.signal_start_);
-}
+    BSPWalker *walker = (BSPWalker *)thread_data;
 
-#else
+    render_batch_pool = &render_batch_pools[walker - bsp_walkers];
 
-constexpr uint32_t  kRenderBatchMax      = 65536 * 2;
-static uint32_t     render_batch_counter = 0;
-static uint32_t     render_batch_travese = 0;
-static RenderBatch *render_batches       = nullptr;
+    while (SDL_AtomicGet(&bsp_thread.exit_flag_) == 0)
+    {
+        if (BSPSignalWait(&walker->signal_start_, -1))
+        {
+            if (SDL_AtomicGet(&bsp_thread.exit_flag_))
+            {
+                break;
+            }
 
-static RenderBatch *GetRenderBatch()
+            BSPBeginWalk();
+
+            for (;;)
+            {
+                int claim = SDL_AtomicAdd(&bsp_next_walk_job, 1);
+
+                if (claim >= bsp_total_walk_jobs)
+                    break;
+
+                BSPRunWalkJob(claim, false);
+            }
+
+            SDL_LockMutex(bsp_walk_mutex);
+            bsp_walkers_busy--;
+            SDL_CondBroadcast(bsp_walk_cond);
+            SDL_UnlockMutex(bsp_walk_mutex);
+        }
+    }
+
+    return 0;
+}
+
+static void BSPSplitNode(unsigned int bspnum, int depth)
 {
-    if (render_batch_counter >= kRenderBatchMax)
+    if (depth == 0 || (bspnum & kLeafSubsector))
     {
-        FatalError("GetRenderBatch: Exceeded max render batches");
+        if (bsp_total_walk_jobs == (int)bsp_walk_jobs.size())
+            bsp_walk_jobs.resize(bsp_total_walk_jobs + 1);
+
+        BSPWalkJob &job = bsp_walk_jobs[bsp_total_walk_jobs++];
+
+        job.node_ = bspnum;
+        job.done_ = false;
+        return;
     }
 
-    return &render_batches[render_batch_counter++];
+    BSPNode *node = &level_nodes[bspnum];
+
+    int side = BSPNodeSide(node);
+
+    if (BSPCheckBBox(node->bounding_boxes[side]))
+        BSPSplitNode(node->children[side], depth - 1);
+
+    if (BSPCheckBBox(node->bounding_boxes[side ^ 1]))
+        BSPSplitNode(node->children[side ^ 1], depth - 1);
 }
 
-static RenderItem *GetRenderItem()
+static void BSPWalkParallel(void)
 {
-    if (!current_batch || current_batch->num_items_ == kRenderItemBatchSize)
+    int depth = 0;
+
+    while ((1 << depth) < bsp_active_walkers * kBSPJobsPerWalker)
+        depth++;
+
+    // the other walkers are idle, no need for the lock here
+    bsp_total_walk_jobs = 0;
+    BSPSplitNode(root_node, depth);
+
+    bsp_front_occlusion.clear();
+    bsp_front_walk_jobs = 0;
+    bsp_walkers_busy    = bsp_active_walkers - 1;
+
+    SDL_AtomicSet(&bsp_next_walk_job, 0);
+
+    SetDrawPoolsShared(true);
+
+    for (int i = 1; i < bsp_active_walkers; i++)
+        BSPSignalRaise(&bsp_walkers[i].signal_start_);
+
+    int emit = 0;
+
+    while (emit < bsp_total_walk_jobs)
     {
-        current_batch = GetRenderBatch();
+        int claim = SDL_AtomicAdd(&bsp_next_walk_job, 1);
+
+        if (claim < bsp_total_walk_jobs)
+        {
+            // nothing in front of it is pending, so it can go straight out
+            bool stream = (claim == emit);
+
+            BSPRunWalkJob(claim, stream);
+
+            if (stream)
+                emit++;
+        }
+        else
+        {
+            SDL_LockMutex(bsp_walk_mutex);
+            while (!bsp_walk_jobs[emit].done_)
+                SDL_CondWait(bsp_walk_cond, bsp_walk_mutex);
+            SDL_UnlockMutex(bsp_walk_mutex);
+        }
+
+        // pass on finished subtrees, in order
+        for (; emit < bsp_total_walk_jobs && BSPWalkJobDone(emit); emit++)
+        {
+            std::vector<RenderBatch *> &batches = bsp_walk_jobs[emit].batches_;
+
+            for (size_t i = 0; i < batches.size(); i++)
+                BSPQueueProduce(batches[i]);
+        }
     }
 
-    return &current_batch->items_[current_batch->num_items_++];
+    // nothing may be reused until every walker is idle again
+    SDL_LockMutex(bsp_walk_mutex);
+    while (bsp_walkers_busy > 0)
+        SDL_CondWait(bsp_walk_cond, bsp_walk_mutex);
+    SDL_UnlockMutex(bsp_walk_mutex);
+
+    SetDrawPoolsShared(false);
 }
 
-void BSPQueueSkyWall(Seg *seg, float h1, float h2)
+static int32_t BSPTraverseProc(void *thread_data)
 {
-    RenderItem *item = GetRenderItem();
+    EPI_UNUSED(thread_data);
 
-    item->type_    = kRenderSkyWall;
-    item->height1_ = h1;
-    item->height2_ = h2;
-    item->wallSeg_ = seg;
+    while (SDL_AtomicGet(&bsp_thread.exit_flag_) == 0)
+    {
+        if (BSPSignalWait(&bsp_thread.signal_start_, -1))
+        {
+            if (SDL_AtomicGet(&bsp_thread.exit_flag_))
+            {
+                break;
+            }
+
+            BSPBeginWalk();
+            OcclusionClear();
+
+            if (bsp_active_walkers > 1)
+            {
+                BSPWalkParallel();
+            }
+            else
+            {
+                current_batch = nullptr;
+
+                // walk the bsp tree
+                BSPWalkNode(root_node);
+
+                if (current_batch && current_batch->num_items_)
+                {
+                    BSPQueueProduce(current_batch);
+                }
+            }
+
+            SDL_AtomicSet(&bsp_thread.traverse_finished_, 1);
+            BSPQueueWake(&bsp_thread.queue_.consumer_waiting_);
+        }
+    }
+
+    return 0;
 }
 
-void BSPQueueSkyPlane(Subsector *sub, float h)
+RenderBatch *BSPReadRenderBatch()
 {
-    RenderItem *item = GetRenderItem();
+    return BSPQueueConsume();
+}
 
-    item->type_      = kRenderSkyPlane;
-    item->height1_   = h;
-    item->wallPlane_ = sub;
+void BSPTraverse()
+{
+    // the walking threads are idle, so the pools can be reused
+    for (int i = 0; i < kBSPMaximumWalkers; i++)
+        render_batch_pools[i].used_ = 0;
+
+    bsp_view_clip_left  = clip_left;
+    bsp_view_clip_right = clip_right;
+    bsp_view_clip_scope = clip_scope;
+
+    bsp_active_walkers = bsp_total_walkers;
+
+    if (renderer_bsp_threads.d_ > 0)
+        bsp_active_walkers = HMM_MIN(bsp_active_walkers, renderer_bsp_threads.d_);
+
+    if (total_level_nodes < kBSPParallelMinimumNodes)
+        bsp_active_walkers = 1;
+
+    SDL_AtomicSet(&bsp_thread.traverse_finished_, 0);
+    BSPSignalRaise(&bsp_thread.signal_start_);
 }
 
-void BSPQueueDrawSubsector(DrawSubsector *subsector)
+bool BSPTraversing()
 {
-    subsector->solid = true;
-    RenderItem *item = GetRenderItem();
-    item->type_      = kRenderSubsector;
-    item->subsector_ = subsector;
+    if (BSPQueueWait())
+    {
+        return true;
+    }
+
+    uint32_t stall = (uint32_t)SDL_AtomicSet(&bsp_thread.queue_.producer_stall_, 0);
+
+    if (profile_active)
+    {
+        ProfileAddTime(kProfileZoneBSPStall, stall);
+    }
+
+    return false;
 }
 
 void BSPStartThread()
 {
-    if (render_batches)
+    // the main thread renders, the traversal thread and walkers share the rest
+    bsp_total_walkers = HMM_MIN(SDL_GetCPUCount() - 1, kBSPMaximumWalkers);
+
+    if (bsp_total_walkers < 1)
+        bsp_total_walkers = 1;
+
+    SDL_AtomicSet(&bsp_thread.exit_flag_, 0);
+    SDL_AtomicSet(&bsp_thread.traverse_finished_, 1);
+    BSPSignalInit(&bsp_thread.signal_start_);
+    BSPQueueInit();
+
+    bsp_walk_mutex = SDL_CreateMutex();
+    bsp_walk_cond  = SDL_CreateCond();
+
+    for (int i = 1; i < bsp_total_walkers; i++)
     {
-        FatalError("BSPStartThread: Render Batches is not null");
+        BSPSignalInit(&bsp_walkers[i].signal_start_);
+        bsp_walkers[i].thread_ =
+            SDL_CreateThread((SDL_ThreadFunction)BSPWalkerProc, "BSPWalker", &bsp_walkers[i]);
     }
 
-    render_batches = (RenderBatch *)malloc(sizeof(RenderBatch) * kRenderBatchMax);
+    bsp_thread.thread_ = SDL_CreateThread((SDL_ThreadFunction)BSPTraverseProc, "BSPTraverse", nullptr);
 }
 void BSPStopThread()
 {
-    if (render_batches)
+    SDL_AtomicSet(&bsp_thread.exit_flag_, 1);
+    BSPSignalRaise(&bsp_thread.signal_start_);
+    SDL_WaitThread(bsp_thread.thread_, nullptr);
+    BSPSignalTerm(&bsp_thread.signal_start_);
+
+    for (int i = 1; i < bsp_total_walkers; i++)
     {
-        free(render_batches);
-        render_batches = nullptr;
+        BSPSignalRaise(&bsp_walkers[i].signal_start_);
+        SDL_WaitThread(bsp_walkers[i].thread_, nullptr);
+        BSPSignalTerm(&bsp_walkers[i].signal_start_);
     }
+
+    SDL_DestroyCond(bsp_walk_cond);
+    SDL_DestroyMutex(bsp_walk_mutex);
+
+    BSPQueueTerm();
+    FreeRenderBatches();
+}
+
+#else
+
+static int32_t render_batch_travese = 0;
+
+void BSPStartThread()
+{
+}
+void BSPStopThread()
+{
+    FreeRenderBatches();
 }
 
 void BSPTraverse()
 {
-    current_batch        = nullptr;
-    render_batch_counter = 0;
-    render_batch_travese = 0;
-    EPI_CLEAR_MEMORY(render_batches, RenderBatch, kRenderBatchMax);
+    current_batch               = nullptr;
+    render_batch_pools[0].used_ = 0;
+    render_batch_travese        = 0;
 
     // walk the bsp tree
     BSPWalkNode(root_node);
@@ -1252,7 +1647,7 @@ void BSPTraverse()
 
 bool BSPTraversing()
 {
-    if (render_batch_counter == render_batch_travese)
+    if (render_batch_pools[0].used_ == render_batch_travese)
     {
         return false;
     }
@@ -1262,7 +1657,7 @@ bool BSPTraversing()
 
 RenderBatch *BSPReadRenderBatch()
 {
-    return &render_batches[render_batch_travese++];
+    return render_batch_pools[0].At(render_batch_travese++);
 }
 
 #endif
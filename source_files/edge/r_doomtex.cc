@@ -170,7 +170,7 @@ static ImageData *ReadFlatAsEpiBlock(Image *rim)
         delete f;
     }
     else
-        src = (const uint8_t *)LoadLumpIntoMemory(rim->source_.flat.lump);
+        src = LoadLumpView(rim->source_.flat.lump);
 
     if (!src)
         FatalError("ReadFlatAsEpiBlock: Failed to load %s!\n", rim->name_.c_str());
@@ -190,7 +190,10 @@ static ImageData *ReadFlatAsEpiBlock(Image *rim)
                 dest_pix[0] = src_pix;
         }
 
-    delete[] src;
+    if (rim->source_.graphic.packfile_name)
+        delete[] src;
+    else
+        ReleaseLumpView(rim->source_.flat.lump, src);
 
     return img;
 }
@@ -234,7 +237,7 @@ static ImageData *ReadTextureAsEpiBlock(Image *rim)
     // Composite the columns into the block.
     for (i = 0, patch = tdef->patches; i < tdef->patch_count; i++, patch++)
     {
-        const Patch *realpatch = (const Patch *)LoadLumpIntoMemory(patch->patch);
+        const Patch *realpatch = (const Patch *)LoadLumpView(patch->patch);
 
         int realsize = GetLumpLength(patch->patch);
 
@@ -261,7 +264,7 @@ static ImageData *ReadTextureAsEpiBlock(Image *rim)
             DrawColumnIntoEpiBlock(rim, img, patchcol, x, y1);
         }
 
-        delete[] realpatch;
+        ReleaseLumpView(patch->patch, (const uint8_t *)realpatch);
     }
 
     return img;
@@ -341,7 +344,7 @@ static ImageData *ReadPatchAsEpiBlock(Image *rim)
     }
     else
     {
-        realpatch = (const Patch *)LoadLumpIntoMemory(lump);
+        realpatch = (const Patch *)LoadLumpView(lump);
         realsize  = GetLumpLength(lump);
     }
 
@@ -367,7 +370,10 @@ static ImageData *ReadPatchAsEpiBlock(Image *rim)
         DrawColumnIntoEpiBlock(rim, img, patchcol, x, 0);
     }
 
-    delete[] realpatch;
+    if (packfile_name)
+        delete[] realpatch;
+    else
+        ReleaseLumpView(lump, (const uint8_t *)realpatch);
 
     return img;
 }
@@ -189,5 +189,8 @@ DrawSeg       *GetDrawSeg();
 DrawSubsector *GetDrawSub();
 DrawMirror    *GetDrawMirror();
 
+// Set while more than one thread may call the above.
+void SetDrawPoolsShared(bool shared);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -37,6 +37,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include "ddf_flat.h"
 #include "ddf_font.h"
@@ -77,6 +78,20 @@
 
 LiquidSwirl swirling_flats = kLiquidSwirlVanilla;
 
+// game tics per frame of the swirl cycle; thick liquids move at a
+// quarter of the speed of thin ones
+static constexpr int kSwirlThinFrameTics  = 2;
+static constexpr int kSwirlThickFrameTics = 8;
+
+// pre-baking every frame of the swirl cycle costs kSwirlCycleFrames
+// textures per cached image (and per colormap), so it is limited to
+// smallish flats and to a total amount of (approximate) texture memory.
+// Anything above that regenerates its texture whenever the frame changes.
+static constexpr size_t kSwirlBakeImageLimit = 8 * 1024 * 1024;
+static constexpr size_t kSwirlBakeTotalLimit = 64 * 1024 * 1024;
+
+static size_t swirl_baked_bytes = 0;
+
 extern ImageData *ReadAsEpiBlock(Image *rim);
 
 extern epi::File *OpenUserFileOrLump(ImageDefinition *def);
@@ -110,6 +125,14 @@ struct CachedImage
     GLuint texture_id;
 
     bool is_whitened;
+
+    // SMMU swirled liquids: one texture per frame of the swirl cycle,
+    // built on first use.  texture_id is the current one of these.
+    std::vector<GLuint> swirl_frames;
+    size_t              swirl_bytes;
+
+    // when not pre-baked: the swirl frame in texture_id, or -1
+    int swirl_frame;
 };
 
 // total set of images
@@ -300,7 +323,7 @@ static Image *NewImage(int width, int height, int opacity = kOpacityUnknown)
 
     rim->liquid_type_ = kLiquidImageNone;
 
-    rim->swirled_game_tic_ = 0;
+    rim->swirl_frame_ = 0;
 
     return rim;
 }
@@ -1317,10 +1340,7 @@ static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
     if (rim->liquid_type_ > kLiquidImageNone &&
         (swirling_flats == kLiquidSwirlSmmu || swirling_flats == kLiquidSwirlSmmuSlosh))
     {
-        rim->swirled_game_tic_ = hud_tic;
-        tmp_img->Swirl(rim->swirled_game_tic_,
-                       rim->liquid_type_); // Using leveltime disabled swirl
-                                           // for intermission screens
+        tmp_img->Swirl(rim->swirl_frame_);
     }
 
     if (rim->opacity_ == kOpacityUnknown)
@@ -1790,6 +1810,44 @@ void ImageMakeSaveString(const Image *image, char *type, char *namebuf)
 //  IMAGE USAGE
 //
 
+// rough texture memory for one frame of a swirled image (ignoring mipmaps)
+static size_t SwirlFrameBytes(const Image *rim)
+{
+    size_t bytes = (size_t)rim->width_ * (size_t)rim->height_ * 4;
+
+    if (IM_ShouldHQ2X(rim))
+        bytes *= 4;
+
+    return bytes;
+}
+
+static void FreeSwirlFrames(CachedImage *rc)
+{
+    if (!rc->swirl_frames.empty())
+    {
+        for (GLuint &frame_id : rc->swirl_frames)
+        {
+            if (frame_id != 0)
+                render_state->DeleteTexture(&frame_id);
+        }
+
+        rc->swirl_frames.clear();
+        rc->swirl_frames.shrink_to_fit();
+
+        // texture_id was one of the frames
+        rc->texture_id = 0;
+    }
+    else if (rc->swirl_frame >= 0 && rc->texture_id != 0)
+    {
+        render_state->DeleteTexture(&rc->texture_id);
+    }
+
+    swirl_baked_bytes -= rc->swirl_bytes;
+
+    rc->swirl_bytes = 0;
+    rc->swirl_frame = -1;
+}
+
 static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whiten)
 {
     // check if image + translation is already cached
@@ -1835,6 +1893,8 @@ static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whi
         rc->hue             = kRGBANoValue;
         rc->texture_id      = 0;
         rc->is_whitened     = do_whiten ? true : false;
+        rc->swirl_bytes     = 0;
+        rc->swirl_frame     = -1;
 
         image_cache.push_back(rc);
 
@@ -1849,16 +1909,61 @@ static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whi
     if (rim->liquid_type_ > kLiquidImageNone &&
         (swirling_flats == kLiquidSwirlSmmu || swirling_flats == kLiquidSwirlSmmuSlosh))
     {
-        if (!erraticism_active && !time_stop_active && rim->swirled_game_tic_ != hud_tic)
+        // Using hud_tic rather than leveltime keeps the swirl going
+        // on intermission screens
+        if (!erraticism_active && !time_stop_active)
         {
+            int frame_tics = (rim->liquid_type_ == kLiquidImageThin) ? kSwirlThinFrameTics : kSwirlThickFrameTics;
+
+            rim->swirl_frame_ = (hud_tic / frame_tics) % kSwirlCycleFrames;
+        }
+
+        if (rc->swirl_frames.empty() && rc->swirl_frame < 0)
+        {
+            // drop any unswirled texture from before the mode was changed
             if (rc->texture_id != 0)
-            {
                 render_state->DeleteTexture(&rc->texture_id);
-                rc->texture_id = 0;
+
+            size_t cycle_bytes = SwirlFrameBytes(rim) * kSwirlCycleFrames;
+
+            if (cycle_bytes <= kSwirlBakeImageLimit && swirl_baked_bytes + cycle_bytes <= kSwirlBakeTotalLimit)
+            {
+                rc->swirl_frames.resize(kSwirlCycleFrames, 0);
+                rc->swirl_bytes = cycle_bytes;
+
+                swirl_baked_bytes += cycle_bytes;
             }
         }
+
+        if (!rc->swirl_frames.empty())
+        {
+            GLuint &frame_id = rc->swirl_frames[rim->swirl_frame_];
+
+            if (frame_id == 0)
+                frame_id = LoadImageOGL(rim, trans, do_whiten);
+
+            rc->texture_id = frame_id;
+
+            return rc;
+        }
+
+        // too big to pre-bake: rebuild the single texture on frame changes
+        if (rc->texture_id != 0 && rc->swirl_frame != rim->swirl_frame_)
+            render_state->DeleteTexture(&rc->texture_id);
+
+        if (rc->texture_id == 0)
+        {
+            rc->texture_id  = LoadImageOGL(rim, trans, do_whiten);
+            rc->swirl_frame = rim->swirl_frame_;
+        }
+
+        return rc;
     }
 
+    // the swirl mode was turned off, so rebuild the texture unswirled
+    if (!rc->swirl_frames.empty() || rc->swirl_frame >= 0)
+        FreeSwirlFrames(rc);
+
     if (rc->texture_id == 0)
     {
         // load image into cache
@@ -1986,6 +2091,8 @@ void DeleteAllImages(bool shutdown)
         CachedImage *rc = *CI;
         EPI_ASSERT(rc);
 
+        FreeSwirlFrames(rc);
+
         if (rc->texture_id != 0)
         {
             render_state->DeleteTexture(&rc->texture_id);
@@ -84,7 +84,8 @@ class Image
 
     LiquidImageType liquid_type_;
 
-    int swirled_game_tic_;
+    // current frame of the SMMU swirl cycle
+    int swirl_frame_;
 
     bool is_font_;
 
@@ -376,4 +376,4 @@ class MirrorSet
 };
 
 extern MirrorSet render_mirror_set;
-extern MirrorSet bsp_mirror_set;
+extern thread_local MirrorSet bsp_mirror_set;
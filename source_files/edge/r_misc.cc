@@ -37,6 +37,7 @@
 #include "e_main.h"
 #include "epi.h"
 #include "epi_doomdefs.h"
+#include "epi_sdl.h"
 #include "i_defs_gl.h"
 #include "m_misc.h"
 #include "n_network.h"
@@ -312,6 +313,69 @@ static size_t draw_mirror_position;
 
 static void *draw_memory_buffer = nullptr;
 
+// While several threads walk the BSP tree they take entries from the
+// pools in chunks, so that only taking a chunk needs the lock.  ClearBSP()
+// bumps the generation, which throws away what is left of old chunks.
+static constexpr int kDrawPoolChunk = 64;
+
+template <typename T> class DrawPoolChunk
+{
+  public:
+    T       *items_[kDrawPoolChunk];
+    int      position_   = kDrawPoolChunk;
+    uint32_t generation_ = 0;
+};
+
+static bool       draw_pools_shared    = false;
+static SDL_mutex *draw_pool_mutex      = nullptr;
+static uint32_t   draw_pool_generation = 1;
+
+static thread_local DrawPoolChunk<DrawThing>     draw_thing_chunk;
+static thread_local DrawPoolChunk<DrawFloor>     draw_floor_chunk;
+static thread_local DrawPoolChunk<DrawSeg>       draw_seg_chunk;
+static thread_local DrawPoolChunk<DrawSubsector> draw_subsector_chunk;
+static thread_local DrawPoolChunk<DrawMirror>    draw_mirror_chunk;
+
+template <typename T>
+static T *GetDrawItem(std::vector<T *> &pool, size_t &position, DrawPoolChunk<T> &chunk)
+{
+    if (!draw_pools_shared)
+    {
+        if (position == pool.size())
+            pool.push_back(new T());
+
+        return pool[position++];
+    }
+
+    if (chunk.position_ == kDrawPoolChunk || chunk.generation_ != draw_pool_generation)
+    {
+        SDL_LockMutex(draw_pool_mutex);
+
+        for (int i = 0; i < kDrawPoolChunk; i++)
+        {
+            if (position == pool.size())
+                pool.push_back(new T());
+
+            chunk.items_[i] = pool[position++];
+        }
+
+        SDL_UnlockMutex(draw_pool_mutex);
+
+        chunk.position_   = 0;
+        chunk.generation_ = draw_pool_generation;
+    }
+
+    return chunk.items_[chunk.position_++];
+}
+
+void SetDrawPoolsShared(bool shared)
+{
+    if (shared && !draw_pool_mutex)
+        draw_pool_mutex = SDL_CreateMutex();
+
+    draw_pools_shared = shared;
+}
+
 //
 // AllocateDrawStructs
 //
@@ -379,6 +443,8 @@ void ClearBSP(void)
     draw_seg_position       = 0;
     draw_subsector_position = 0;
     draw_mirror_position    = 0;
+
+    draw_pool_generation++;
 }
 
 void FreeBSP(void)
@@ -450,42 +516,27 @@ void FreeBSP(void)
 
 DrawThing *GetDrawThing()
 {
-    if (draw_thing_position == draw_things.size())
-        draw_things.push_back(new DrawThing());
-
-    return draw_things[draw_thing_position++];
+    return GetDrawItem(draw_things, draw_thing_position, draw_thing_chunk);
 }
 
 DrawFloor *GetDrawFloor()
 {
-    if (draw_floor_position == draw_floors.size())
-        draw_floors.push_back(new DrawFloor());
-
-    return draw_floors[draw_floor_position++];
+    return GetDrawItem(draw_floors, draw_floor_position, draw_floor_chunk);
 }
 
 DrawSeg *GetDrawSeg()
 {
-    if (draw_seg_position == draw_segs.size())
-        draw_segs.push_back(new DrawSeg());
-
-    return draw_segs[draw_seg_position++];
+    return GetDrawItem(draw_segs, draw_seg_position, draw_seg_chunk);
 }
 
 DrawSubsector *GetDrawSub()
 {
-    if (draw_subsector_position == draw_subsectors.size())
-        draw_subsectors.push_back(new DrawSubsector());
-
-    return draw_subsectors[draw_subsector_position++];
+    return GetDrawItem(draw_subsectors, draw_subsector_position, draw_subsector_chunk);
 }
 
 DrawMirror *GetDrawMirror()
 {
-    if (draw_mirror_position == draw_mirrors.size())
-        draw_mirrors.push_back(new DrawMirror());
-
-    return draw_mirrors[draw_mirror_position++];
+    return GetDrawItem(draw_mirrors, draw_mirror_position, draw_mirror_chunk);
 }
 
 //--- editor settings ---
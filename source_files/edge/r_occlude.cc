@@ -32,10 +32,11 @@ struct AngleRange
     AngleRange *previous;
 };
 
-static AngleRange *occlusion_buffer_head = nullptr;
-static AngleRange *occlusion_buffer_tail = nullptr;
+// per thread, so the BSP walk can be split between threads
+static thread_local AngleRange *occlusion_buffer_head = nullptr;
+static thread_local AngleRange *occlusion_buffer_tail = nullptr;
 
-static AngleRange *free_occlusion_range = nullptr;
+static thread_local AngleRange *free_occlusion_range = nullptr;
 
 #ifdef EDGE_DEBUG_OCCLUSION
 static void ValidateBuffer(void)
@@ -159,14 +160,17 @@ static inline void RemoveRange(AngleRange *R)
     free_occlusion_range = R;
 }
 
-static void DoSet(BAMAngle low, BAMAngle high)
+// Sets one range, starting the search at `start` (the head, or a range
+// known not to lie above this one).  Returns the range that now holds it.
+static AngleRange *DoSet(BAMAngle low, BAMAngle high, AngleRange *start)
 {
-    for (AngleRange *AR = occlusion_buffer_head; AR; AR = AR->next)
+    for (AngleRange *AR = start; AR; AR = AR->next)
     {
         if (high < AR->low)
         {
-            LinkBefore(AR, GetNewRange(low, high));
-            return;
+            AngleRange *N = GetNewRange(low, high);
+            LinkBefore(AR, N);
+            return N;
         }
 
         if (low > AR->high)
@@ -197,12 +201,14 @@ static void DoSet(BAMAngle low, BAMAngle high)
             RemoveRange(AR->next);
         }
 
-        return;
+        return AR;
     }
 
     // the new range is greater than all existing ranges
 
-    LinkInTail(GetNewRange(low, high));
+    AngleRange *N = GetNewRange(low, high);
+    LinkInTail(N);
+    return N;
 }
 
 void OcclusionSet(BAMAngle low, BAMAngle high)
@@ -213,11 +219,11 @@ void OcclusionSet(BAMAngle low, BAMAngle high)
     EPI_ASSERT((BAMAngle)(high - low) < kBAMAngle180);
 
     if (low <= high)
-        DoSet(low, high);
+        DoSet(low, high, occlusion_buffer_head);
     else
     {
-        DoSet(low, kBAMAngle360);
-        DoSet(0, high);
+        DoSet(low, kBAMAngle360, occlusion_buffer_head);
+        DoSet(0, high, occlusion_buffer_head);
     }
 
 #ifdef EDGE_DEBUG_OCCLUSION
@@ -253,5 +259,30 @@ bool OcclusionTest(BAMAngle low, BAMAngle high)
         return DoTest(low, kBAMAngle360) && DoTest(0, high);
 }
 
+void OcclusionSave(std::vector<BAMAngle> &ranges)
+{
+    ranges.clear();
+
+    for (AngleRange *AR = occlusion_buffer_head; AR; AR = AR->next)
+    {
+        ranges.push_back(AR->low);
+        ranges.push_back(AR->high);
+    }
+}
+
+void OcclusionMerge(const std::vector<BAMAngle> &ranges)
+{
+    // the pairs are sorted and never wrap around, so each search can
+    // carry on from where the previous one ended
+    AngleRange *AR = occlusion_buffer_head;
+
+    for (size_t i = 0; i + 1 < ranges.size(); i += 2)
+        AR = DoSet(ranges[i], ranges[i + 1], AR);
+
+#ifdef EDGE_DEBUG_OCCLUSION
+    ValidateBuffer();
+#endif
+}
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
\ No newline at end of file
@@ -18,11 +18,20 @@
 
 #pragma once
 
+#include <vector>
+
 #include "epi_bam.h"
 
+// Each thread has its own occlusion buffer.
+
 void OcclusionClear(void);
 void OcclusionSet(BAMAngle low, BAMAngle high);
 bool OcclusionTest(BAMAngle low, BAMAngle high);
 
+// Copy the blocked ranges out as (low, high) pairs, and set ranges
+// previously copied out (possibly by another thread).
+void OcclusionSave(std::vector<BAMAngle> &ranges);
+void OcclusionMerge(const std::vector<BAMAngle> &ranges);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -29,10 +29,12 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "AlmostEquals.h"
 #include "dm_defs.h"
 #include "dm_state.h"
+#include "e_profile.h"
 #include "epi.h"
 #include "epi_doomdefs.h"
 #include "g_game.h"
@@ -110,7 +112,8 @@ MirrorSet render_mirror_set(kMirrorSetRender);
 extern std::list<DrawSubsector *> draw_subsector_list;
 #else
 // Sky items from previous frame, delayed a frame so can render the BSP as we traverse it
-static std::list<RenderItem *> deferred_sky_items;
+// kept by value: the batches they came from are reused by the next traversal
+static std::vector<RenderItem> deferred_sky_items;
 #endif
 
 static void EmulateFloodPlane(const DrawFloor *dfloor, const Sector *flood_ref, int face_dir, float h1, float h2);
@@ -302,6 +305,8 @@ struct PlaneCoordinateData
     SlopePlane *slope;
 
     BAMAngle rotation = 0;
+    float    rotation_sin;
+    float    rotation_cos;
 };
 
 static void PlaneCoordFunc(void *d, int v_idx, HMM_Vec3 *pos, RGBAColor *rgb, HMM_Vec2 *texc, HMM_Vec3 *normal,
@@ -328,7 +333,8 @@ static void PlaneCoordFunc(void *d, int v_idx, HMM_Vec3 *pos, RGBAColor *rgb, HM
     HMM_Vec2 rxy = {{(data->tx0 + pos->X), (data->ty0 + pos->Y)}};
 
     if (data->rotation)
-        rxy = HMM_RotateV2(rxy, epi::RadiansFromBAM(data->rotation));
+        rxy = {{rxy.X * data->rotation_cos - rxy.Y * data->rotation_sin,
+                rxy.X * data->rotation_sin + rxy.Y * data->rotation_cos}};
 
     rxy.X /= data->image_w;
     rxy.Y /= data->image_h;
@@ -1697,6 +1703,13 @@ static void RenderPlane(DrawFloor *dfloor, float h, MapSurface *surf, int face_d
     data.slope    = slope;
     data.rotation = surf->rotation;
 
+    if (surf->rotation)
+    {
+        float radians     = epi::RadiansFromBAM(surf->rotation);
+        data.rotation_sin = HMM_SinF(radians);
+        data.rotation_cos = HMM_CosF(radians);
+    }
+
     if (current_subsector->sector->properties.special)
     {
         if (face_dir > 0)
@@ -2030,6 +2043,8 @@ void UpdateSectorInterpolation(Sector *sector)
 //
 void RenderTrueBSP(void)
 {
+    ProfileScope profile_render(kProfileZoneRenderTrueBSP);
+
     FuzzUpdate();
 
     ClearBSP();
@@ -2064,10 +2079,9 @@ void RenderTrueBSP(void)
             render_backend->SetRenderLayer(kRenderLayerSkyDeferred, true);
 
             // Render deferred sky walls and planes from previous frame
-            std::list<RenderItem *>::iterator I;
-            for (I = deferred_sky_items.begin(); I != deferred_sky_items.end(); I++)
+            for (size_t i = 0; i < deferred_sky_items.size(); i++)
             {
-                RenderItem *item = (*I);
+                const RenderItem *item = &deferred_sky_items[i];
 
                 if (item->type_ == kRenderSkyWall)
                 {
@@ -2103,40 +2117,42 @@ void RenderTrueBSP(void)
     render_backend->SetRenderLayer(kRenderLayerSolid, false);
     StartUnitBatch(solid_mode);
 
-    BSPTraverse();
-
     std::list<RenderItem *> items;
-    while (BSPTraversing())
+
     {
-        RenderBatch *batch = BSPReadRenderBatch();
-        if (!batch)
-        {
-            continue;
-        }
+        ProfileScope profile_bsp(kProfileZoneBSPTraverse);
+
+        BSPTraverse();
 
-        for (int32_t i = 0; i < batch->num_items_; i++)
+        while (BSPTraversing())
         {
-            RenderItem *item = &batch->items_[i];
+            RenderBatch *batch = BSPReadRenderBatch();
 
-            switch (item->type_)
+            for (int32_t i = 0; i < batch->num_items_; i++)
             {
-            case kRenderSubsector:
-                items.push_back(item);
-                RenderSubsector(item->subsector_, false);
-                break;
-            case kRenderSkyWall:
-                // Save off item for next frame
-                if (!render_world_index)
-                    deferred_sky_items.push_back(item);
-                break;
-            case kRenderSkyPlane:
-                // Save off item for next frame
-                if (!render_world_index)
-                    deferred_sky_items.push_back(item);
-                break;
+                RenderItem *item = &batch->items_[i];
+
+                switch (item->type_)
+                {
+                case kRenderSubsector:
+                    items.push_back(item);
+                    RenderSubsector(item->subsector_, false);
+                    break;
+                case kRenderSkyWall:
+                    // Save off item for next frame
+                    if (!render_world_index)
+                        deferred_sky_items.push_back(*item);
+                    break;
+                case kRenderSkyPlane:
+                    // Save off item for next frame
+                    if (!render_world_index)
+                        deferred_sky_items.push_back(*item);
+                    break;
+                }
             }
         }
     }
+
     FinishUnitBatch();
 
     // draw all sprites and masked/translucent walls/planes
@@ -2174,7 +2190,10 @@ void RenderTrueBSP(void)
     BeginSky();
 
     // walk the bsp tree
-    BSPWalkNode(root_node);
+    {
+        ProfileScope profile_bsp(kProfileZoneBSPTraverse);
+        BSPWalkNode(root_node);
+    }
 
     FlushSky();
     FinishSky(true);
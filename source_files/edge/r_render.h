@@ -42,6 +42,9 @@ struct RenderBatch
     int32_t    num_items_;
 };
 
+// Starts walking the BSP tree.  BSPTraversing() waits until another batch
+// is ready and returns false once the walk is done and all batches have
+// been read.  Batches stay valid until the next BSPTraverse().
 void         BSPTraverse();
 bool         BSPTraversing();
 RenderBatch *BSPReadRenderBatch();
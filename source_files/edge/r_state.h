@@ -80,11 +80,12 @@ extern BAMAngle view_angle;
 // view_angletox lookups, and converted to BAM format.
 
 // angles used for clipping
-extern BAMAngle clip_left, clip_right;
+// (per thread, the BSP walk narrows them for mirrors)
+extern thread_local BAMAngle clip_left, clip_right;
 
 // the scope of the clipped area (clip_left-clip_right).
 // kBAMAngle180 disables polar clipping
-extern BAMAngle clip_scope;
+extern thread_local BAMAngle clip_scope;
 
 // the most extreme angles of the view
 extern float view_x_slope, view_y_slope;
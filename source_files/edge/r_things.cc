@@ -28,7 +28,6 @@
 #include <map>
 
 #include "AlmostEquals.h"
-#include "coal.h"
 #include "dm_defs.h"
 #include "dm_state.h"
 #include "epi_color.h"
@@ -63,8 +62,6 @@
 #include "w_model.h"
 #include "w_sprite.h"
 
-extern coal::VM *ui_vm;
-extern double    COALGetFloat(coal::VM *vm, const char *mod_name, const char *var_name);
 extern bool erraticism_active;
 
 EDGE_DEFINE_CONSOLE_VARIABLE(crosshair_image, "None", kConsoleVariableFlagArchive)
@@ -404,7 +401,7 @@ static void RenderPSprite(PlayerSprite *psp, int which, Player *player, RegionPr
     {
         // Lobo 2022: Apply sprite Y offset, mainly for Heretic weapons.
         if ((state->flags & kStateFrameFlagWeapon) && (player->ready_weapon_ >= 0))
-            ty1 += COALGetFloat(ui_vm, "hud", "universal_y_adjust") +
+            ty1 += COALGetFloat(kCOALVariableUniversalYAdjust) +
                    player->weapons_[player->ready_weapon_].info->y_adjust_;
     }
 
@@ -811,7 +808,7 @@ void RenderWeaponModel(Player *p)
     }
     else
     {
-        bias = COALGetFloat(ui_vm, "hud", "universal_y_adjust") + p->weapons_[p->ready_weapon_].info->y_adjust_;
+        bias = COALGetFloat(kCOALVariableUniversalYAdjust) + p->weapons_[p->ready_weapon_].info->y_adjust_;
     }
 
     bias /= 5;
@@ -1026,9 +1023,12 @@ void BSPWalkThing(DrawSubsector *dsub, MapObject *mo)
     }
     else
     {
-        ModelDefinition *md = GetModel(mo->state_->sprite);
-        EPI_ASSERT(md);
-        if (clip_scope != kBAMAngle180 && tz < -(md->radius_ * mo->scale_))
+        // this runs on the BSP threads, which must not load models.  A model
+        // which is not loaded yet is simply not culled here, the main thread
+        // loads it when the thing is drawn.
+        ModelDefinition *md = GetLoadedModel(mo->state_->sprite);
+
+        if (md && clip_scope != kBAMAngle180 && tz < -(md->radius_ * mo->scale_))
         {
             return;
         }
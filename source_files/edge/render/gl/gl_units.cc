@@ -26,6 +26,7 @@
 #include "AlmostEquals.h"
 #include "dm_state.h"
 #include "e_player.h"
+#include "e_profile.h"
 #include "epi.h"
 #include "i_defs_gl.h"
 #include "im_data.h"
@@ -275,6 +276,8 @@ void RenderCurrentUnits(void)
     if (current_render_unit == 0)
         return;
 
+    ProfileScope profile_units(kProfileZoneRenderUnits);
+
     RenderState *state = render_state;
 
     GLuint active_tex[2] = {0, 0};
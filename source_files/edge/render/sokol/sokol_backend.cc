@@ -254,6 +254,13 @@ class SokolRenderBackend : public RenderBackend
 #ifdef SOKOL_D3D11
         sapp_d3d11_capture_screen(width, height, stride, dest);
 #endif
+
+#ifdef SOKOL_DUMMY_BACKEND
+        EPI_UNUSED(width);
+        EPI_UNUSED(height);
+        EPI_UNUSED(stride);
+        EPI_UNUSED(dest);
+#endif
     }
 
     void Init()
@@ -262,6 +269,8 @@ class SokolRenderBackend : public RenderBackend
         LogPrint("Sokol GLES3: Initialising...\n");
 #elif SOKOL_GLCORE
         LogPrint("Sokol GL: Initialising...\n");
+#elif defined(SOKOL_DUMMY_BACKEND)
+        LogPrint("Sokol Headless: Initialising...\n");
 #else
         LogPrint("Sokol D3D11: Initialising...\n");
 #endif
@@ -3928,8 +3928,14 @@ static void _sgl_setup_common(void)
     SOKOL_ASSERT(SG_INVALID_ID != _sgl.def_smp.id);
 
     // one shader for all contexts
+    // the dummy (headless) backend has no shader of its own, but any well formed
+    // description will do as nothing is ever compiled
+    const sg_shader_desc *world_shd_desc = sgl_shader_desc(sg_query_backend());
+    if (!world_shd_desc)
+        world_shd_desc = sgl_shader_desc(SG_BACKEND_GLCORE);
+
     sg_shader_desc shd_desc;
-    memcpy(&shd_desc, sgl_shader_desc(sg_query_backend()), sizeof(sg_shader_desc));
+    memcpy(&shd_desc, world_shd_desc, sizeof(sg_shader_desc));
 
     /*
     _sgl_clear(&shd_desc, sizeof(shd_desc));
@@ -4117,6 +4123,10 @@ static void _sgl_draw(_sgl_context_t *ctx, int layer_id)
 #ifdef SOKOL_D3D11
                 sg_d3d11_clear_depth(args->value);
 #endif
+
+#ifdef SOKOL_DUMMY_BACKEND
+                (void)args;
+#endif
             }
             break;
             case SGL_COMMAND_DRAW: {
@@ -26,6 +26,7 @@
 #include "AlmostEquals.h"
 #include "dm_state.h"
 #include "e_player.h"
+#include "e_profile.h"
 #include "epi.h"
 #include "i_defs_gl.h"
 #include "im_data.h"
@@ -290,6 +291,8 @@ void RenderCurrentUnits(void)
     if (current_render_unit == 0)
         return;
 
+    ProfileScope profile_units(kProfileZoneRenderUnits);
+
     for (int i = 0; i < current_render_unit; i++)
         local_unit_map[i] = &local_units[i];
 
@@ -35,6 +35,7 @@
 #include "i_sound.h"
 #include "i_system.h"
 #include "m_misc.h"
+#include "n_network.h"
 #include "p_blockmap.h"
 #include "p_local.h" // ApproximateDistance
 #include "r_misc.h"  // PointToAngle
@@ -62,7 +63,9 @@ BAMAngle listen_angle;
 
 extern int sound_device_frequency;
 
-SoundChannel::SoundChannel() : state_(kChannelEmpty), data_(nullptr), definition_(nullptr), position_(nullptr)
+SoundChannel::SoundChannel()
+    : state_(kChannelEmpty), data_(nullptr), definition_(nullptr), position_(nullptr), occlusion_tic_(-1),
+      occluded_(false), clip_distance_(kMinimumSoundClipDistance)
 {
     EPI_CLEAR_MEMORY(&channel_sound_, ma_sound, 1);
     EPI_CLEAR_MEMORY(&ref_config_, ma_audio_buffer_config, 1);
@@ -91,6 +94,8 @@ void FreeSoundChannels(void)
 
         if (chan && chan->data_)
         {
+            SoundCacheStopPlaying(chan->data_);
+
             chan->data_       = nullptr;
             chan->definition_ = nullptr;
             chan->position_   = nullptr;
@@ -110,6 +115,9 @@ void KillSoundChannel(int k)
 
     if (chan->state_ != kChannelEmpty)
     {
+        if (chan->data_)
+            SoundCacheStopPlaying(chan->data_);
+
         chan->data_       = nullptr;
         chan->definition_ = nullptr;
         chan->position_   = nullptr;
@@ -157,10 +165,7 @@ void UpdateSounds(MapObject *listener, BAMAngle angle)
                 if (listener &&
                     ma_sound_get_attenuation_model(&chan->channel_sound_) == ma_attenuation_model_exponential)
                 {
-                    if (CheckSightToPoint(listener, chan->position_->x, chan->position_->y, chan->position_->z))
-                        ma_sound_set_min_distance(&chan->channel_sound_, kMinimumSoundClipDistance);
-                    else
-                        ma_sound_set_min_distance(&chan->channel_sound_, kMinimumOccludedSoundClipDistance);
+                    UpdateSoundOcclusion(chan, listener, false);
                 }
             }
         }
@@ -170,6 +175,54 @@ void UpdateSounds(MapObject *listener, BAMAngle angle)
     }
 }
 
+// how far the clip distance moves per tic, between the open and occluded
+// values that is four tics (~115ms)
+static constexpr float kOcclusionFadeStep = (kMinimumSoundClipDistance - kMinimumOccludedSoundClipDistance) / 4.0f;
+
+void UpdateSoundOcclusion(SoundChannel *chan, MapObject *listener, bool snap)
+{
+    if (chan->occlusion_tic_ == game_tic && !snap)
+        return;
+
+    const Position *pos = chan->position_;
+
+    // another channel playing from the same emitter may have checked already
+    int k;
+
+    for (k = 0; k < total_channels; k++)
+    {
+        const SoundChannel *other = mix_channels[k];
+
+        if (other != chan && other->state_ == kChannelPlaying && other->position_ == pos &&
+            other->occlusion_tic_ == game_tic)
+        {
+            chan->occluded_ = other->occluded_;
+            break;
+        }
+    }
+
+    if (k == total_channels)
+        chan->occluded_ = !CheckSightToPoint(listener, pos->x, pos->y, pos->z);
+
+    chan->occlusion_tic_ = game_tic;
+
+    float target = chan->occluded_ ? kMinimumOccludedSoundClipDistance : kMinimumSoundClipDistance;
+    float clip   = chan->clip_distance_;
+
+    if (snap)
+        clip = target;
+    else if (clip < target)
+        clip = HMM_MIN(target, clip + kOcclusionFadeStep);
+    else if (clip > target)
+        clip = HMM_MAX(target, clip - kOcclusionFadeStep);
+
+    if (snap || !AlmostEquals(clip, chan->clip_distance_))
+    {
+        chan->clip_distance_ = clip;
+        ma_sound_set_min_distance(&chan->channel_sound_, clip);
+    }
+}
+
 void PauseSound(void)
 {
     sound_effects_paused = true;
@@ -56,6 +56,11 @@ class SoundChannel
 
     bool boss_;
 
+    // occlusion state, see UpdateSoundOcclusion()
+    int   occlusion_tic_;
+    bool  occluded_;
+    float clip_distance_;
+
     ma_audio_buffer_config ref_config_;
     ma_audio_buffer        ref_;
     ma_sound               channel_sound_;
@@ -83,5 +88,11 @@ void KillSoundChannel(int k);
 
 void UpdateSounds(MapObject *listener, BAMAngle angle);
 
+// Checks whether the listener can see the channel's emitter, at most once
+// per game tic (channels sharing an emitter share the result), and eases
+// the minimum clip distance towards the open/occluded value.  `snap`
+// skips the easing, for channels which have just started.
+void UpdateSoundOcclusion(SoundChannel *chan, MapObject *listener, bool snap);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -25,14 +25,20 @@
 
 #include "s_cache.h"
 
+#include <stdarg.h>
+
+#include <deque>
+#include <unordered_map>
 #include <vector>
 
+#include "con_var.h"
 #include "ddf_main.h"
 #include "ddf_sfx.h"
 #include "dm_state.h" // game_directory
 #include "epi.h"
 #include "epi_file.h"
 #include "epi_filesystem.h"
+#include "epi_sdl.h"
 #include "epi_str_util.h"
 #include "i_system.h"
 #include "m_argv.h"
@@ -40,6 +46,7 @@
 #include "m_random.h"
 #include "p_mobj.h"
 #include "r_defs.h"
+#include "s_blit.h"
 #include "s_doom.h"
 #include "s_mp3.h"
 #include "s_ogg.h"
@@ -47,22 +54,65 @@
 #include "s_wav.h"
 #include "snd_data.h"
 #include "snd_types.h"
+#include "stb_sprintf.h"
 #include "w_files.h"
 #include "w_wad.h"
 
 extern int  sound_device_frequency;
 extern bool pc_speaker_mode;
 
-static std::vector<SoundData *> sound_effects_cache;
+// budget for decoded sound effects, in megabytes (0 = unlimited).
+// sounds which are not playing are evicted, least recently used first.
+EDGE_DEFINE_CONSOLE_VARIABLE(sound_cache_size, "64", kConsoleVariableFlagArchive)
+
+static std::unordered_map<const SoundEffectDefinition *, SoundData *> sound_effects_cache;
+
+static size_t sound_cache_bytes = 0;
+
+// ready sounds which no channel is playing, most recently used first.
+// eviction takes them from the tail.
+static SoundData *idle_head = nullptr;
+static SoundData *idle_tail = nullptr;
+
+static void IdleUnlink(SoundData *buf)
+{
+    if (buf->idle_previous_)
+        buf->idle_previous_->idle_next_ = buf->idle_next_;
+    else if (idle_head == buf)
+        idle_head = buf->idle_next_;
+    else
+        return; // not in the list
+
+    if (buf->idle_next_)
+        buf->idle_next_->idle_previous_ = buf->idle_previous_;
+    else
+        idle_tail = buf->idle_previous_;
+
+    buf->idle_previous_ = nullptr;
+    buf->idle_next_     = nullptr;
+}
+
+static void IdlePushFront(SoundData *buf)
+{
+    buf->idle_previous_ = nullptr;
+    buf->idle_next_     = idle_head;
+
+    if (idle_head)
+        idle_head->idle_previous_ = buf;
+    else
+        idle_tail = buf;
+
+    idle_head = buf;
+}
 
 static void LoadSilence(SoundData *buf)
 {
     int length = 256;
 
     buf->frequency_ = sound_device_frequency;
-    buf->Allocate(length);
+    buf->Allocate(length, 1);
 
-    EPI_CLEAR_MEMORY(buf->data_, float, length * 2);
+    EPI_CLEAR_MEMORY(buf->data_, int16_t, length);
 }
 static bool LoadDoom(SoundData *buf, const uint8_t *lump, int length)
 {
@@ -87,19 +137,89 @@ static bool LoadMP3(SoundData *buf, const uint8_t *lump, int length)
 
 //----------------------------------------------------------------------------
 
+static void WaitForDecodeJobs(void);
+
 void SoundCacheClearAll(void)
 {
-    for (int i = 0; i < (int)sound_effects_cache.size(); i++)
-        delete sound_effects_cache[i];
+    // decoders may still be writing into some of the buffers
+    WaitForDecodeJobs();
+
+    for (std::unordered_map<const SoundEffectDefinition *, SoundData *>::iterator iter = sound_effects_cache.begin();
+         iter != sound_effects_cache.end(); iter++)
+        delete iter->second;
+
+    sound_effects_cache.clear();
+    sound_cache_bytes = 0;
+
+    idle_head = nullptr;
+    idle_tail = nullptr;
+}
+
+static size_t SoundCacheBudget(void)
+{
+    if (sound_cache_size.d_ <= 0)
+        return 0;
+
+    return (size_t)sound_cache_size.d_ * 1024 * 1024;
+}
+
+bool SoundCacheFull(void)
+{
+    size_t budget = SoundCacheBudget();
+
+    return (budget > 0 && sound_cache_bytes >= budget);
+}
+
+void SoundCacheStartPlaying(const SoundData *buf)
+{
+    SoundData *data = (SoundData *)buf;
+
+    if (data->playing_++ == 0)
+        IdleUnlink(data);
+}
+
+void SoundCacheStopPlaying(const SoundData *buf)
+{
+    SoundData *data = (SoundData *)buf;
+
+    EPI_ASSERT(data->playing_ > 0);
+
+    if (--data->playing_ == 0 && data->ready_)
+        IdlePushFront(data);
+}
+
+static void SoundCacheEvict(size_t incoming)
+{
+    size_t budget = SoundCacheBudget();
+
+    if (budget == 0)
+        return;
+
+    // free a little extra, so that we are not back here on the next load
+    size_t target = budget - HMM_MIN(budget, incoming + budget / 8);
+
+    // everything left once the list is empty is playing (or decoding)
+    while (sound_cache_bytes > target && idle_tail != nullptr)
+    {
+        SoundData *oldest = idle_tail;
+
+        IdleUnlink(oldest);
+
+        sound_cache_bytes -= oldest->Bytes();
 
-    sound_effects_cache.erase(sound_effects_cache.begin(), sound_effects_cache.end());
+        sound_effects_cache.erase((const SoundEffectDefinition *)oldest->definition_data_);
+        delete oldest;
+    }
 }
 
-static bool DoCacheLoad(SoundEffectDefinition *def, SoundData *buf)
+// reads the file or lump into memory (main thread only, since pack files
+// and lump files have a shared read position).
+static bool ReadSoundFile(SoundEffectDefinition *def, uint8_t *&data, int &length, SoundFormat &fmt)
 {
     // open the file or lump, and read it into memory
-    epi::File  *F;
-    SoundFormat fmt = kSoundUnknown;
+    epi::File *F;
+
+    fmt = kSoundUnknown;
 
     if (pc_speaker_mode)
     {
@@ -174,8 +294,8 @@ static bool DoCacheLoad(SoundEffectDefinition *def, SoundData *buf)
     }
 
     // Load the data into the buffer
-    int      length = F->GetLength();
-    uint8_t *data   = F->LoadIntoMemory();
+    length = F->GetLength();
+    data   = F->LoadIntoMemory();
 
     // no longer need the epi::File
     delete F;
@@ -189,6 +309,7 @@ static bool DoCacheLoad(SoundEffectDefinition *def, SoundData *buf)
     if (length < 4)
     {
         delete[] data;
+        data = nullptr;
         WarningOrError("SFX Loader: Ignored short data (%d bytes).\n", length);
         return false;
     }
@@ -200,6 +321,12 @@ static bool DoCacheLoad(SoundEffectDefinition *def, SoundData *buf)
         fmt = DetectSoundFormat(data, length);
     }
 
+    return true;
+}
+
+// decodes the file contents into the buffer, safe to call on any thread.
+static bool DecodeSoundFile(SoundData *buf, const uint8_t *data, int length, SoundFormat fmt)
+{
     bool OK = false;
 
     switch (fmt)
@@ -230,12 +357,265 @@ static bool DoCacheLoad(SoundEffectDefinition *def, SoundData *buf)
         break;
     }
 
-    delete[] data;
-
     return OK;
 }
 
-SoundData *SoundCacheLoad(SoundEffectDefinition *def)
+//----------------------------------------------------------------------------
+//  DECODER THREADS
+//----------------------------------------------------------------------------
+
+// Decoding (OGG/MP3 especially) is the slow part of loading a sound, so
+// it is done on a few worker threads: all at once by PrecacheSounds(), and
+// in the background when a sound is first played.  Reading the file stays
+// on the main thread.  The main thread also decodes while it waits.
+
+#if !defined(EDGE_WEB) || defined(EDGE_WEB_MULTITHREADED)
+#define SFX_DECODE_THREADS
+#endif
+
+static constexpr uint8_t kMaximumDecodeThreads = 8;
+
+class SoundDecodeJob
+{
+  public:
+    SoundData  *buf_;
+    uint8_t    *data_;
+    int         length_;
+    SoundFormat format_;
+    bool        ok_;
+
+    // warnings from the loaders, printed by the main thread
+    std::string messages_;
+};
+
+// the job being decoded by this thread, if any
+static thread_local SoundDecodeJob *current_decode_job = nullptr;
+
+static std::deque<SoundDecodeJob *>  decode_queue;
+static std::vector<SoundDecodeJob *> decode_finished;
+static int                           decode_busy = 0;
+
+#ifdef SFX_DECODE_THREADS
+static SDL_mutex                 *decode_lock = nullptr;
+static SDL_cond                  *decode_wake = nullptr;
+static SDL_cond                  *decode_done = nullptr;
+static std::vector<SDL_Thread *> decode_threads;
+static bool                       decode_quit = false;
+#endif
+
+void SoundLoaderWarning(const char *message, ...)
+{
+    char buffer[1024];
+
+    va_list argptr;
+
+    va_start(argptr, message);
+    stbsp_vsnprintf(buffer, sizeof(buffer), message, argptr);
+    va_end(argptr);
+
+    if (current_decode_job != nullptr)
+        current_decode_job->messages_ += buffer;
+    else
+        LogWarning("%s", buffer);
+}
+
+static void DecodeJob(SoundDecodeJob *job)
+{
+    current_decode_job = job;
+
+    job->ok_ = DecodeSoundFile(job->buf_, job->data_, job->length_, job->format_);
+
+    current_decode_job = nullptr;
+
+    delete[] job->data_;
+    job->data_ = nullptr;
+}
+
+static void DecodeLock(void)
+{
+#ifdef SFX_DECODE_THREADS
+    SDL_LockMutex(decode_lock);
+#endif
+}
+
+static void DecodeUnlock(void)
+{
+#ifdef SFX_DECODE_THREADS
+    SDL_UnlockMutex(decode_lock);
+#endif
+}
+
+// takes a job off the queue and decodes it, returns false if the queue
+// was empty.  must be called with the lock held (and returns with it held).
+static bool DecodeNextJob(void)
+{
+    if (decode_queue.empty())
+        return false;
+
+    SoundDecodeJob *job = decode_queue.front();
+    decode_queue.pop_front();
+
+    decode_busy++;
+
+    DecodeUnlock();
+    DecodeJob(job);
+    DecodeLock();
+
+    decode_busy--;
+    decode_finished.push_back(job);
+
+#ifdef SFX_DECODE_THREADS
+    SDL_CondBroadcast(decode_done);
+#endif
+
+    return true;
+}
+
+#ifdef SFX_DECODE_THREADS
+static int SoundDecodeProc(void *data)
+{
+    EPI_UNUSED(data);
+
+    SDL_LockMutex(decode_lock);
+
+    while (!decode_quit)
+    {
+        if (!DecodeNextJob())
+            SDL_CondWait(decode_wake, decode_lock);
+    }
+
+    SDL_UnlockMutex(decode_lock);
+
+    return 0;
+}
+#endif
+
+static void StartDecodeThreads(void)
+{
+#ifdef SFX_DECODE_THREADS
+    if (decode_lock != nullptr)
+        return;
+
+    decode_lock = SDL_CreateMutex();
+    decode_wake = SDL_CreateCond();
+    decode_done = SDL_CreateCond();
+    decode_quit = false;
+
+    int total = HMM_MIN((int)kMaximumDecodeThreads, SDL_GetCPUCount() - 1);
+
+    for (int i = 0; i < total; i++)
+    {
+        SDL_Thread *thread = SDL_CreateThread(SoundDecodeProc, "SFXDecode", nullptr);
+
+        if (thread != nullptr)
+            decode_threads.push_back(thread);
+    }
+
+    LogDebug("SFX Loader: %d decoder threads\n", (int)decode_threads.size());
+#endif
+}
+
+static void QueueDecodeJob(SoundDecodeJob *job)
+{
+    StartDecodeThreads();
+
+    DecodeLock();
+    decode_queue.push_back(job);
+    DecodeUnlock();
+
+#ifdef SFX_DECODE_THREADS
+    SDL_CondSignal(decode_wake);
+#endif
+}
+
+static void FinishDecodeJob(SoundDecodeJob *job)
+{
+    SoundData *buf = job->buf_;
+
+    if (!job->messages_.empty())
+        LogWarning("%s", job->messages_.c_str());
+
+    if (!job->ok_)
+        LoadSilence(buf);
+
+    // evict before marking it ready, otherwise the new buffer (which is
+    // not counted yet and not playing) could be chosen itself.
+    SoundCacheEvict(buf->Bytes());
+    sound_cache_bytes += buf->Bytes();
+
+    buf->ready_ = true;
+
+    if (buf->playing_ == 0)
+        IdlePushFront(buf);
+
+    delete job;
+}
+
+void SoundCacheUpdate(void)
+{
+    std::vector<SoundDecodeJob *> finished;
+
+    DecodeLock();
+    finished.swap(decode_finished);
+    DecodeUnlock();
+
+    for (size_t i = 0; i < finished.size(); i++)
+        FinishDecodeJob(finished[i]);
+}
+
+static void WaitForDecodeJobs(void)
+{
+    DecodeLock();
+
+    for (;;)
+    {
+        if (DecodeNextJob())
+            continue;
+
+        if (decode_busy == 0)
+            break;
+
+#ifdef SFX_DECODE_THREADS
+        SDL_CondWait(decode_done, decode_lock);
+#endif
+    }
+
+    DecodeUnlock();
+
+    SoundCacheUpdate();
+}
+
+void SoundCacheStopDecoders(void)
+{
+    WaitForDecodeJobs();
+
+#ifdef SFX_DECODE_THREADS
+    if (decode_lock == nullptr)
+        return;
+
+    SDL_LockMutex(decode_lock);
+    decode_quit = true;
+    SDL_CondBroadcast(decode_wake);
+    SDL_UnlockMutex(decode_lock);
+
+    for (size_t i = 0; i < decode_threads.size(); i++)
+        SDL_WaitThread(decode_threads[i], nullptr);
+
+    decode_threads.clear();
+
+    SDL_DestroyCond(decode_done);
+    SDL_DestroyCond(decode_wake);
+    SDL_DestroyMutex(decode_lock);
+
+    decode_lock = nullptr;
+    decode_wake = nullptr;
+    decode_done = nullptr;
+#endif
+}
+
+//----------------------------------------------------------------------------
+
+static SoundData *SoundCacheRequest(SoundEffectDefinition *def)
 {
     bool pc_speaker_skip = false;
 
@@ -245,28 +625,85 @@ SoundData *SoundCacheLoad(SoundEffectDefinition *def)
             pc_speaker_skip = true;
     }
 
-    for (int i = 0; i < (int)sound_effects_cache.size(); i++)
+    std::unordered_map<const SoundEffectDefinition *, SoundData *>::iterator find = sound_effects_cache.find(def);
+
+    if (find != sound_effects_cache.end())
     {
-        if (sound_effects_cache[i]->definition_data_ == (void *)def)
+        SoundData *buf = find->second;
+
+        // most recently used now
+        if (buf->ready_ && buf->playing_ == 0)
         {
-            return sound_effects_cache[i];
+            IdleUnlink(buf);
+            IdlePushFront(buf);
         }
+
+        return buf;
     }
 
     // create data structure
     SoundData *buf = new SoundData();
 
-    sound_effects_cache.push_back(buf);
-
     buf->definition_data_ = def;
 
-    if (pc_speaker_skip)
-        LoadSilence(buf);
-    else if (!DoCacheLoad(def, buf))
-        LoadSilence(buf);
+    sound_effects_cache[def] = buf;
+
+    SoundDecodeJob *job = new SoundDecodeJob;
+
+    job->buf_    = buf;
+    job->data_   = nullptr;
+    job->length_ = 0;
+    job->format_ = kSoundUnknown;
+    job->ok_     = false;
+
+    if (!pc_speaker_skip && ReadSoundFile(def, job->data_, job->length_, job->format_))
+    {
+        QueueDecodeJob(job);
+        return buf;
+    }
+
+    FinishDecodeJob(job);
 
     return buf;
 }
 
+SoundData *SoundCacheLoad(SoundEffectDefinition *def)
+{
+    SoundData *buf = SoundCacheRequest(def);
+
+    if (!buf->ready_)
+    {
+        // pick up anything finished in the meantime
+        SoundCacheUpdate();
+
+#ifdef SFX_DECODE_THREADS
+        if (decode_threads.empty())
+#endif
+            WaitForDecodeJobs();
+    }
+
+    return buf;
+}
+
+void SoundCachePrecache(const std::vector<SoundEffectDefinition *> &defs)
+{
+    // queue a batch at a time, so that the budget is still respected
+    size_t batch = 32;
+
+    for (size_t i = 0; i < defs.size(); i += batch)
+    {
+        if (SoundCacheFull())
+        {
+            LogDebug("SFX cache full, precached %d of %d sounds\n", (int)i, (int)defs.size());
+            break;
+        }
+
+        for (size_t k = i; k < i + batch && k < defs.size(); k++)
+            SoundCacheRequest(defs[k]);
+
+        WaitForDecodeJobs();
+    }
+}
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
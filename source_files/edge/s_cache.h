@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "snd_data.h"
 
 class SoundEffectDefinition;
@@ -36,8 +38,31 @@ void SoundCacheClearAll(void);
 
 SoundData *SoundCacheLoad(SoundEffectDefinition *def);
 // load a sound into the cache.  If the sound has already
-// been loaded, then it is simply returned (increasing the
-// reference count).  Returns nullptr if the lump doesn't exist.
+// been loaded, then it is simply returned.  A sound seen for
+// the first time is decoded in the background, and is not
+// ready_ until a later SoundCacheUpdate().  Sounds which are
+// not playing may be evicted to stay within sound_cache_size.
+
+void SoundCachePrecache(const std::vector<SoundEffectDefinition *> &defs);
+// decode the given sounds on all decoder threads, stopping
+// once the cache has reached sound_cache_size.
+
+void SoundCacheUpdate(void);
+// collect sounds which have finished decoding (main thread).
+
+void SoundCacheStopDecoders(void);
+// finish any outstanding work and shut down the decoder threads.
+
+bool SoundCacheFull(void);
+// true once the cache has reached sound_cache_size.
+
+void SoundCacheStartPlaying(const SoundData *buf);
+void SoundCacheStopPlaying(const SoundData *buf);
+// called by the mixer channels, sounds are only evicted while idle.
+
+void SoundLoaderWarning(const char *message, ...);
+// for the sound loaders: like LogWarning(), but safe on a
+// decoder thread (the message is printed later).
 
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
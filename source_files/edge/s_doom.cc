@@ -34,7 +34,7 @@ bool LoadDoomSound(SoundData *buf, const uint8_t *data, int length)
     buf->frequency_ = data[2] + (data[3] << 8);
 
     if (buf->frequency_ < 8000 || buf->frequency_ > 48000)
-        LogWarning("Sound Load: weird frequency: %d Hz\n", buf->frequency_);
+        SoundLoaderWarning("Sound Load: weird frequency: %d Hz\n", buf->frequency_);
 
     if (buf->frequency_ < 4000)
         buf->frequency_ = 4000;
@@ -44,21 +44,10 @@ bool LoadDoomSound(SoundData *buf, const uint8_t *data, int length)
     if (length <= 0)
         return false;
 
-    buf->Allocate(length);
+    buf->Allocate(length, 1);
 
     // convert to signed 16-bit format
-    const uint8_t *src   = data + 8;
-    const uint8_t *s_end = src + length;
-
-    float *dest = buf->data_;
-    float  out  = 0;
-
-    for (; src < s_end; src++)
-    {
-        ma_pcm_u8_to_f32(&out, src, 1, ma_dither_mode_none);
-        *dest++ = out;
-        *dest++ = out;
-    }
+    ma_pcm_u8_to_s16(buf->data_, data + 8, length, ma_dither_mode_none);
 
     return true;
 }
@@ -79,7 +68,7 @@ bool LoadPCSpeakerSound(SoundData *buf, const uint8_t *data, int length)
 {
     if (length < 4)
     {
-        LogWarning("Invalid PC Speaker Sound (too short)\n");
+        SoundLoaderWarning("Invalid PC Speaker Sound (too short)\n");
         return false;
     }
     int      sign = -1;
@@ -90,37 +79,36 @@ bool LoadPCSpeakerSound(SoundData *buf, const uint8_t *data, int length)
     memcpy(&total_samples, data + 2, 2);
     if (zeroed != 0)
     {
-        LogWarning("Invalid PC Speaker Sound (bad magic number)\n");
+        SoundLoaderWarning("Invalid PC Speaker Sound (bad magic number)\n");
         return false;
     }
     if (total_samples < 4 || total_samples > length - 4)
     {
-        LogWarning("Invalid PC Speaker Sound (bad sample count)\n");
+        SoundLoaderWarning("Invalid PC Speaker Sound (bad sample count)\n");
         return false;
     }
     data += 4;
     length -= 4;
-    buf->Allocate(length * samples_per_byte);
-    float *dst = buf->data_;
+    buf->Allocate(length * samples_per_byte, 1);
+    int16_t *dst = buf->data_;
     while (length--)
     {
         if (*data > 128)
         {
-            LogWarning("Invalid PC Speaker Sound (bad tone value %d)\n", *data);
+            SoundLoaderWarning("Invalid PC Speaker Sound (bad tone value %d)\n", *data);
             return false;
         }
         uint32_t tone         = kFrequencyTable[*data++];
         uint32_t phase_length = (sound_device_frequency * tone) / (2 * kPCInterruptTimer);
-        float    float_value  = 0;
+        int16_t  sample_value = 0;
         uint8_t  value;
         for (i = 0; i < samples_per_byte; i++)
         {
             if (tone)
             {
                 value = (128 + sign * kPCVolume);
-                ma_pcm_u8_to_f32(&float_value, &value, 1, ma_dither_mode_none);
-                *dst++ = float_value;
-                *dst++ = float_value;
+                ma_pcm_u8_to_s16(&sample_value, &value, 1, ma_dither_mode_none);
+                *dst++ = sample_value;
                 if (phase_tic++ >= phase_length)
                 {
                     sign      = -sign;
@@ -131,7 +119,6 @@ bool LoadPCSpeakerSound(SoundData *buf, const uint8_t *data, int length)
             {
                 phase_tic = 0;
                 *dst++    = 0;
-                *dst++    = 0;
             }
         }
     }
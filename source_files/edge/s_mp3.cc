@@ -200,20 +200,20 @@ AbstractMusicPlayer *PlayMP3Music(uint8_t *data, int length, bool looping)
 bool LoadMP3Sound(SoundData *buf, const uint8_t *data, int length)
 {
     ma_decoder_config decode_config = ma_decoder_config_init_default();
-    decode_config.format            = ma_format_f32;
+    decode_config.format            = ma_format_s16;
     decode_config.encodingFormat    = ma_encoding_format_mp3;
 
     ma_decoder decode;
 
     if (ma_decoder_init_memory(data, length, &decode_config, &decode) != MA_SUCCESS)
     {
-        LogWarning("Failed to load MP3 sound (corrupt mp3?)\n");
+        SoundLoaderWarning("Failed to load MP3 sound (corrupt mp3?)\n");
         return false;
     }
 
     if (decode.outputChannels > 2)
     {
-        LogWarning("MP3 SFX Loader: too many channels: %d\n", decode.outputChannels);
+        SoundLoaderWarning("MP3 SFX Loader: too many channels: %d\n", decode.outputChannels);
         ma_decoder_uninit(&decode);
         return false;
     }
@@ -222,7 +222,7 @@ bool LoadMP3Sound(SoundData *buf, const uint8_t *data, int length)
 
     if (ma_decoder_get_length_in_pcm_frames(&decode, &frame_count) != MA_SUCCESS)
     {
-        LogWarning("MP3 SFX Loader: no samples!\n");
+        SoundLoaderWarning("MP3 SFX Loader: no samples!\n");
         ma_decoder_uninit(&decode);
         return false;
     }
@@ -235,13 +235,13 @@ bool LoadMP3Sound(SoundData *buf, const uint8_t *data, int length)
 
     SoundGatherer gather;
 
-    float *buffer = gather.MakeChunk(frame_count, is_stereo);
+    int16_t *buffer = gather.MakeChunk(frame_count, is_stereo);
 
     ma_uint64 frames_read = 0;
 
     if (ma_decoder_read_pcm_frames(&decode, buffer, frame_count, &frames_read) != MA_SUCCESS)
     {
-        LogWarning("MP3 SFX Loader: failure loading samples!\n");
+        SoundLoaderWarning("MP3 SFX Loader: failure loading samples!\n");
         gather.DiscardChunk();
         ma_decoder_uninit(&decode);
         return false;
@@ -250,7 +250,7 @@ bool LoadMP3Sound(SoundData *buf, const uint8_t *data, int length)
     gather.CommitChunk(frames_read);
 
     if (!gather.Finalise(buf))
-        LogWarning("MP3 SFX Loader: no samples!\n");
+        SoundLoaderWarning("MP3 SFX Loader: no samples!\n");
 
     ma_decoder_uninit(&decode);
 
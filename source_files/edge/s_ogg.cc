@@ -707,7 +707,7 @@ AbstractMusicPlayer *PlayOGGMusic(uint8_t *data, int length, bool looping)
 bool LoadOGGSound(SoundData *buf, const uint8_t *data, int length)
 {
     ma_decoder_config decode_config      = ma_decoder_config_init_default();
-    decode_config.format                 = ma_format_f32;
+    decode_config.format                 = ma_format_s16;
     decode_config.customBackendCount     = 1;
     decode_config.pCustomBackendUserData = NULL;
     decode_config.ppCustomBackendVTables = &custom_vtable;
@@ -715,13 +715,13 @@ bool LoadOGGSound(SoundData *buf, const uint8_t *data, int length)
 
     if (ma_decoder_init_memory(data, length, &decode_config, &decode) != MA_SUCCESS)
     {
-        LogWarning("Failed to load OGG sound (corrupt ogg?)\n");
+        SoundLoaderWarning("Failed to load OGG sound (corrupt ogg?)\n");
         return false;
     }
 
     if (decode.outputChannels > 2)
     {
-        LogWarning("OGG SFX Loader: too many channels: %d\n", decode.outputChannels);
+        SoundLoaderWarning("OGG SFX Loader: too many channels: %d\n", decode.outputChannels);
         ma_decoder_uninit(&decode);
         return false;
     }
@@ -730,7 +730,7 @@ bool LoadOGGSound(SoundData *buf, const uint8_t *data, int length)
 
     if (ma_decoder_get_length_in_pcm_frames(&decode, &frame_count) != MA_SUCCESS)
     {
-        LogWarning("OGG SFX Loader: no samples!\n");
+        SoundLoaderWarning("OGG SFX Loader: no samples!\n");
         ma_decoder_uninit(&decode);
         return false;
     }
@@ -743,13 +743,13 @@ bool LoadOGGSound(SoundData *buf, const uint8_t *data, int length)
 
     SoundGatherer gather;
 
-    float *buffer = gather.MakeChunk(frame_count, is_stereo);
+    int16_t *buffer = gather.MakeChunk(frame_count, is_stereo);
 
     ma_uint64 frames_read = 0;
 
     if (ma_decoder_read_pcm_frames(&decode, buffer, frame_count, &frames_read) != MA_SUCCESS)
     {
-        LogWarning("OGG SFX Loader: failure loading samples!\n");
+        SoundLoaderWarning("OGG SFX Loader: failure loading samples!\n");
         gather.DiscardChunk();
         ma_decoder_uninit(&decode);
         return false;
@@ -758,7 +758,7 @@ bool LoadOGGSound(SoundData *buf, const uint8_t *data, int length)
     gather.CommitChunk(frames_read);
 
     if (!gather.Finalise(buf))
-        LogWarning("OGG SFX Loader: no samples!\n");
+        SoundLoaderWarning("OGG SFX Loader: no samples!\n");
 
     ma_decoder_uninit(&decode);
 
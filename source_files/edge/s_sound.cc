@@ -21,6 +21,7 @@
 #endif
 
 #include "dm_state.h"
+#include "e_profile.h"
 #include "epi.h"
 #include "epi_sdl.h"
 #include "i_movie.h"
@@ -46,6 +47,22 @@ extern float listen_z;
 
 static constexpr float kMaximumSoundClipDistance = 4000.0f;
 
+// sounds waiting for their first decode, started by SoundTicker() once
+// ready.  after this many milliseconds the moment has passed.
+static constexpr int kPendingSoundTimeout = 250;
+
+class PendingSoundEffect
+{
+  public:
+    SoundEffectDefinition *def;
+    int                    category;
+    const Position        *pos;
+    int                    flags;
+    int                    start_time;
+};
+
+static std::vector<PendingSoundEffect> pending_sound_effects;
+
 static constexpr uint8_t category_limit_table[kTotalCategories] = {
 
     /* 32 channel */
@@ -232,8 +249,11 @@ void ShutdownSound(void)
     if (no_sound)
         return;
 
+    pending_sound_effects.clear();
+
     FreeSoundChannels();
 
+    SoundCacheStopDecoders();
     SoundCacheClearAll();
 
     if (!no_music)
@@ -332,6 +352,8 @@ static void S_PlaySound(int idx, const SoundEffectDefinition *def, int category,
     chan->state_ = kChannelPlaying;
     chan->data_  = buf;
 
+    SoundCacheStartPlaying(buf);
+
     chan->definition_ = def;
     chan->position_   = pos;
     chan->category_   = category;
@@ -341,7 +363,7 @@ static void S_PlaySound(int idx, const SoundEffectDefinition *def, int category,
     bool attenuate =
         (!chan->boss_ && pos && category != kCategoryWeapon && category != kCategoryPlayer && category != kCategoryUi);
 
-    chan->ref_config_            = ma_audio_buffer_config_init(ma_format_f32, 2, buf->length_, buf->data_, NULL);
+    chan->ref_config_            = ma_audio_buffer_config_init(ma_format_s16, buf->channels_, buf->length_, buf->data_, NULL);
     chan->ref_config_.sampleRate = buf->frequency_;
     ma_audio_buffer_init(&chan->ref_config_, &chan->ref_);
     chan->ref_.ref.ds.vtable = &SFXVTable;
@@ -354,10 +376,15 @@ static void S_PlaySound(int idx, const SoundEffectDefinition *def, int category,
         ma_sound_set_attenuation_model(&chan->channel_sound_, ma_attenuation_model_exponential);
         
         // Lobo 2026: possible to get here before we actually have a player mobj so make sure
-        if (players[display_player]->map_object_ && CheckSightToPoint(players[display_player]->map_object_, pos->x, pos->y, pos->z))
-            ma_sound_set_min_distance(&chan->channel_sound_, kMinimumSoundClipDistance);
+        if (players[display_player]->map_object_)
+            UpdateSoundOcclusion(chan, players[display_player]->map_object_, true);
         else
+        {
+            chan->occlusion_tic_ = -1;
+            chan->occluded_      = true;
+            chan->clip_distance_ = kMinimumOccludedSoundClipDistance;
             ma_sound_set_min_distance(&chan->channel_sound_, kMinimumOccludedSoundClipDistance);
+        }
         ma_sound_set_max_distance(&chan->channel_sound_, kMaximumSoundClipDistance);
         ma_sound_set_position(&chan->channel_sound_, pos->x, pos->z, -pos->y);
         if (pc_speaker_mode)
@@ -499,9 +526,40 @@ void StartSoundEffect(const SoundEffect *sfx, int category, const Position *pos,
     if (!buf)
         return;
 
+    if (!buf->ready_)
+    {
+        pending_sound_effects.push_back(PendingSoundEffect{def, category, pos, flags, GetMilliseconds()});
+        return;
+    }
+
     DoStartFX(def, category, pos, flags, buf);
 }
 
+static void StartPendingSoundEffects(void)
+{
+    SoundCacheUpdate();
+
+    if (pending_sound_effects.empty())
+        return;
+
+    int    now  = GetMilliseconds();
+    size_t keep = 0;
+
+    for (size_t i = 0; i < pending_sound_effects.size(); i++)
+    {
+        PendingSoundEffect pending = pending_sound_effects[i];
+
+        SoundData *buf = SoundCacheLoad(pending.def);
+
+        if (buf->ready_)
+            DoStartFX(pending.def, pending.category, pending.pos, pending.flags, buf);
+        else if (now - pending.start_time < kPendingSoundTimeout)
+            pending_sound_effects[keep++] = pending;
+    }
+
+    pending_sound_effects.resize(keep);
+}
+
 void StopSoundEffect(const Position *pos)
 {
     if (no_sound)
@@ -517,6 +575,13 @@ void StopSoundEffect(const Position *pos)
             KillSoundChannel(i);
         }
     }
+
+    // the emitter may be about to go away
+    for (size_t i = pending_sound_effects.size(); i-- > 0;)
+    {
+        if (pending_sound_effects[i].pos == pos)
+            pending_sound_effects.erase(pending_sound_effects.begin() + i);
+    }
 }
 
 void StopSoundEffect(const SoundEffect *sfx)
@@ -536,6 +601,12 @@ void StopSoundEffect(const SoundEffect *sfx)
             KillSoundChannel(i);
         }
     }
+
+    for (size_t i = pending_sound_effects.size(); i-- > 0;)
+    {
+        if (pending_sound_effects[i].def == def)
+            pending_sound_effects.erase(pending_sound_effects.begin() + i);
+    }
 }
 
 void StopAllSoundEffects(void)
@@ -552,6 +623,8 @@ void StopAllSoundEffects(void)
             KillSoundChannel(i);
         }
     }
+
+    pending_sound_effects.clear();
 }
 
 void SoundTicker(void)
@@ -559,6 +632,10 @@ void SoundTicker(void)
     if (no_sound || playing_movie)
         return;
 
+    ProfileScope profile_sound(kProfileZoneSound);
+
+    StartPendingSoundEffects();
+
     if (game_state == kGameStateLevel)
     {
         EPI_ASSERT(::total_players > 0);
@@ -577,10 +654,8 @@ void SoundTicker(void)
 void PrecacheSounds(void)
 {
     StartupProgressMessage("Precaching SFX...");
-    for (size_t i = 0; i < sfxdefs.size(); i++)
-    {
-        SoundCacheLoad(sfxdefs[i]);
-    }
+
+    SoundCachePrecache(sfxdefs);
 }
 
 //--- editor settings ---
@@ -31,20 +31,20 @@
 bool LoadWAVSound(SoundData *buf, const uint8_t *data, int length)
 {
     ma_decoder_config decode_config = ma_decoder_config_init_default();
-    decode_config.format            = ma_format_f32;
+    decode_config.format            = ma_format_s16;
     decode_config.encodingFormat    = ma_encoding_format_wav;
 
     ma_decoder decode;
 
     if (ma_decoder_init_memory(data, length, &decode_config, &decode) != MA_SUCCESS)
     {
-        LogWarning("Failed to load WAV sound (corrupt wav?)\n");
+        SoundLoaderWarning("Failed to load WAV sound (corrupt wav?)\n");
         return false;
     }
 
     if (decode.outputChannels > 2)
     {
-        LogWarning("WAV SFX Loader: too many channels: %d\n", decode.outputChannels);
+        SoundLoaderWarning("WAV SFX Loader: too many channels: %d\n", decode.outputChannels);
         ma_decoder_uninit(&decode);
         return false;
     }
@@ -53,7 +53,7 @@ bool LoadWAVSound(SoundData *buf, const uint8_t *data, int length)
 
     if (ma_decoder_get_length_in_pcm_frames(&decode, &frame_count) != MA_SUCCESS)
     {
-        LogWarning("WAV SFX Loader: no samples!\n");
+        SoundLoaderWarning("WAV SFX Loader: no samples!\n");
         ma_decoder_uninit(&decode);
         return false;
     }
@@ -66,13 +66,13 @@ bool LoadWAVSound(SoundData *buf, const uint8_t *data, int length)
 
     SoundGatherer gather;
 
-    float *buffer = gather.MakeChunk(frame_count, is_stereo);
+    int16_t *buffer = gather.MakeChunk(frame_count, is_stereo);
 
     ma_uint64 frames_read = 0;
 
     if (ma_decoder_read_pcm_frames(&decode, buffer, frame_count, &frames_read) != MA_SUCCESS)
     {
-        LogWarning("WAV SFX Loader: failure loading samples!\n");
+        SoundLoaderWarning("WAV SFX Loader: failure loading samples!\n");
         gather.DiscardChunk();
         ma_decoder_uninit(&decode);
         return false;
@@ -81,7 +81,7 @@ bool LoadWAVSound(SoundData *buf, const uint8_t *data, int length)
     gather.CommitChunk(frames_read);
 
     if (!gather.Finalise(buf))
-        LogWarning("WAV SFX Loader: no samples!\n");
+        SoundLoaderWarning("WAV SFX Loader: no samples!\n");
 
     ma_decoder_uninit(&decode);
 
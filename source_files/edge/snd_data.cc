@@ -23,7 +23,9 @@
 #include "HandmadeMath.h"
 #include "epi.h"
 
-SoundData::SoundData() : length_(0), frequency_(0), data_(nullptr), definition_data_(nullptr)
+SoundData::SoundData()
+    : length_(0), frequency_(0), channels_(1), data_(nullptr), definition_data_(nullptr), ready_(false), playing_(0),
+      idle_previous_(nullptr), idle_next_(nullptr)
 {
 }
 
@@ -41,20 +43,23 @@ void SoundData::Free()
     data_ = nullptr;
 }
 
-void SoundData::Allocate(int samples)
+void SoundData::Allocate(int frames, int channels)
 {
+    EPI_ASSERT(channels == 1 || channels == 2);
+
     // early out when requirements are already met
-    if (data_ && length_ >= samples)
+    if (data_ && channels_ == channels && length_ >= frames)
     {
-        length_ = samples;
+        length_ = frames;
         return;
     }
 
     Free();
 
-    length_ = samples;
+    length_   = frames;
+    channels_ = channels;
 
-    data_ = new float[samples * 2];
+    data_ = new int16_t[frames * channels];
 }
 
 //--- editor settings ---
@@ -18,24 +18,41 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 class SoundData
 {
   public:
-    int length_;    // number of samples
+    int length_;    // number of frames
     int frequency_; // frequency
+    int channels_;  // 1 (mono) or 2 (interleaved stereo)
 
-    // floating point samples
-    float *data_;
+    // signed 16-bit samples, miniaudio converts them when mixing
+    int16_t *data_;
 
     // values for the engine to use
     void *definition_data_;
 
+    // for the SFX cache: whether it has been decoded yet (see
+    // SoundCacheLoad), how many channels are playing it, and its place
+    // in the list of idle sounds (most recently used first)
+    bool       ready_;
+    int        playing_;
+    SoundData *idle_previous_;
+    SoundData *idle_next_;
+
   public:
     SoundData();
     ~SoundData();
 
-    void Allocate(int samples);
+    void Allocate(int frames, int channels);
     void Free();
+
+    size_t Bytes() const
+    {
+        return (size_t)length_ * channels_ * sizeof(int16_t);
+    }
 };
 
 //--- editor settings ---
@@ -23,7 +23,7 @@
 class GatherChunk
 {
   public:
-    float *samples_;
+    int16_t *samples_;
 
     int total_samples_; // total number is *2 for stereo
 
@@ -34,7 +34,7 @@ class GatherChunk
     {
         EPI_ASSERT(total_samples_ > 0);
 
-        samples_ = new float[total_samples_ * (is_stereo_ ? 2 : 1)];
+        samples_ = new int16_t[total_samples_ * (is_stereo_ ? 2 : 1)];
     }
 
     ~GatherChunk()
@@ -58,7 +58,7 @@ SoundGatherer::~SoundGatherer()
         delete chunks_[i];
 }
 
-float *SoundGatherer::MakeChunk(int max_samples, bool _stereo)
+int16_t *SoundGatherer::MakeChunk(int max_samples, bool _stereo)
 {
     EPI_ASSERT(!request_);
     EPI_ASSERT(max_samples > 0);
@@ -101,13 +101,21 @@ bool SoundGatherer::Finalise(SoundData *buf)
     if (total_samples_ == 0)
         return false;
 
-    buf->Allocate(total_samples_);
+    bool is_stereo = false;
+
+    for (unsigned int i = 0; i < chunks_.size(); i++)
+    {
+        if (chunks_[i]->is_stereo_)
+            is_stereo = true;
+    }
+
+    buf->Allocate(total_samples_, is_stereo ? 2 : 1);
 
     int pos = 0;
 
     for (unsigned int i = 0; i < chunks_.size(); i++)
     {
-        TransferStereo(chunks_[i], buf, pos);
+        Transfer(chunks_[i], buf, pos);
         pos += chunks_[i]->total_samples_;
     }
 
@@ -116,20 +124,20 @@ bool SoundGatherer::Finalise(SoundData *buf)
     return true;
 }
 
-void SoundGatherer::TransferStereo(GatherChunk *chunk, const SoundData *buf, int pos)
+void SoundGatherer::Transfer(GatherChunk *chunk, const SoundData *buf, int pos)
 {
     int count = chunk->total_samples_;
 
-    float *dest = buf->data_ + pos;
-    float *src  = chunk->samples_;
+    int16_t *dest = buf->data_ + pos * buf->channels_;
+    int16_t *src  = chunk->samples_;
 
-    if (chunk->is_stereo_)
+    if (chunk->is_stereo_ || buf->channels_ == 1)
     {
-        memcpy(dest, src, count * 2 * sizeof(float));
+        memcpy(dest, src, count * buf->channels_ * sizeof(int16_t));
     }
     else
     {
-        const float *src_end = src + count;
+        const int16_t *src_end = src + count;
         while (src < src_end)
         {
             *dest++ = *src;
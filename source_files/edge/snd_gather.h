@@ -38,7 +38,7 @@ class SoundGatherer
     SoundGatherer();
     ~SoundGatherer();
 
-    float *MakeChunk(int max_samples, bool stereo);
+    int16_t *MakeChunk(int max_samples, bool stereo);
     // prepare to add a chunk of sound samples.  Returns a buffer
     // containing the number of samples (* 2 for stereo) which the
     // user can fill up.
@@ -55,14 +55,15 @@ class SoundGatherer
 
     bool Finalise(SoundData *buf);
     // take all the stored sound data and transfer it to the
-    // SoundData object, making it all contiguous, and
-    // converting from/to stereoness where needed.
+    // SoundData object, making it all contiguous.  The result
+    // is mono when every chunk was mono, otherwise stereo
+    // (with mono chunks duplicated into both channels).
     //
     // Returns false (failure) if total samples was zero,
     // otherwise returns true (success).
 
   private:
-    void TransferStereo(GatherChunk *chunk, const SoundData *buf, int pos);
+    void Transfer(GatherChunk *chunk, const SoundData *buf, int pos);
 };
 
 //--- editor settings ---
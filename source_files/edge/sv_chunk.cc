@@ -24,11 +24,16 @@
 
 #include "sv_chunk.h"
 
+#include <vector>
+
+#include "dm_state.h"
 #include "epi.h"
 #include "epi_crc.h"
 #include "epi_filesystem.h"
+#include "epi_str_util.h"
 #include "i_system.h"
 #include "miniz.h"
+#include "sv_main.h"
 
 #define EDGE_DEBUG_SAVE_GET_BYTE       0
 #define EDGE_DEBUG_SAVE_PUT_BYTE       0
@@ -64,33 +69,57 @@ static int       chunk_stack_size = 0;
 static FILE      *current_file_pointer = nullptr;
 static epi::CRC32 current_crc;
 
+// when reading a snapshot from memory instead of a file
+static const uint8_t *memory_start    = nullptr;
+static const uint8_t *memory_position = nullptr;
+static const uint8_t *memory_end      = nullptr;
+
+// a top-level chunk, still uncompressed
+struct SavePendingChunk
+{
+    char     marker[6];
+    uint8_t *data;
+    int      length;
+};
+
+class SavePendingFile
+{
+  public:
+    std::string                   filename_;
+    int                           version_;
+    std::vector<SavePendingChunk> chunks_;
+};
+
+// the file being built by SavePushWriteChunk() etc
+static SavePendingFile *pending_file = nullptr;
+
+// size of the scratch buffer used when skipping over chunk data
+static constexpr int kVerifyBlockSize = 16384;
+
+// marker + compressed length + original length
+static constexpr int kTopLevelChunkHeader = 12;
+
 static bool CheckMagic(void)
 {
-    int i;
-    int len = strlen(kEdgeSaveMagic);
+    int     len = strlen(kEdgeSaveMagic);
+    uint8_t buffer[16];
 
-    for (i = 0; i < len; i++)
-        if (SaveChunkGetByte() != kEdgeSaveMagic[i])
-            return false;
+    SaveChunkGetBytes(buffer, len);
 
-    return true;
+    return memcmp(buffer, kEdgeSaveMagic, len) == 0;
 }
 
-static void PutMagic(void)
+static inline void EncodeInteger(uint8_t *dest, uint32_t value)
 {
-    int i;
-    int len = strlen(kEdgeSaveMagic);
-
-    for (i = 0; i < len; i++)
-        SaveChunkPutByte(kEdgeSaveMagic[i]);
+    dest[0] = value & 0xff;
+    dest[1] = (value >> 8) & 0xff;
+    dest[2] = (value >> 16) & 0xff;
+    dest[3] = value >> 24;
 }
 
-static void PutPadding(void)
+static inline uint32_t DecodeInteger(const uint8_t *src)
 {
-    SaveChunkPutByte(0x1A);
-    SaveChunkPutByte(0x0D);
-    SaveChunkPutByte(0x0A);
-    SaveChunkPutByte(0x00);
+    return src[0] | (src[1] << 8) | (src[2] << 16) | ((uint32_t)src[3] << 24);
 }
 
 static inline bool VerifyMarker(const char *id)
@@ -115,6 +144,9 @@ bool SaveFileOpenRead(const std::string &filename)
 {
     LogDebug("Opening savegame file (R): %s\n", filename.c_str());
 
+    // the file may still be queued for writing
+    SaveWaitForWrites();
+
     chunk_stack_size = 0;
     last_error       = 0;
 
@@ -128,14 +160,32 @@ bool SaveFileOpenRead(const std::string &filename)
     return true;
 }
 
+bool SaveMemoryOpenRead(const uint8_t *data, int length)
+{
+    chunk_stack_size = 0;
+    last_error       = 0;
+
+    current_crc.Reset();
+
+    memory_start    = data;
+    memory_position = data;
+    memory_end      = data + length;
+
+    return true;
+}
+
 bool SaveFileCloseRead(void)
 {
-    EPI_ASSERT(current_file_pointer);
+    EPI_ASSERT(current_file_pointer || memory_start);
 
     if (chunk_stack_size > 0)
         FatalError("SV_CloseReadFile: Too many Pushes (missing Pop somewhere).\n");
 
-    fclose(current_file_pointer);
+    if (current_file_pointer)
+        fclose(current_file_pointer);
+
+    current_file_pointer = nullptr;
+    memory_start = memory_position = memory_end = nullptr;
 
     if (last_error)
         LogWarning("LOADGAME: Error(s) occurred during reading.\n");
@@ -158,10 +208,8 @@ bool SaveFileVerifyHeader(int *version)
     }
 
     // skip padding
-    SaveChunkGetByte();
-    SaveChunkGetByte();
-    SaveChunkGetByte();
-    SaveChunkGetByte();
+    uint8_t padding[4];
+    SaveChunkGetBytes(padding, 4);
 
     // We don't do anything with version anymore, but still consume it
     (*version) = SaveChunkGetInteger();
@@ -177,9 +225,11 @@ bool SaveFileVerifyHeader(int *version)
 
 bool SaveFileVerifyContents(void)
 {
-    EPI_ASSERT(current_file_pointer);
+    EPI_ASSERT(current_file_pointer || memory_start);
     EPI_ASSERT(chunk_stack_size == 0);
 
+    std::vector<uint8_t> scratch(kVerifyBlockSize);
+
     // skip top-level chunks until end...
     for (;;)
     {
@@ -216,8 +266,13 @@ bool SaveFileVerifyContents(void)
         }
 
         // skip data bytes (merely compute the CRC)
-        for (; (file_len > 0) && !last_error; file_len--)
-            SaveChunkGetByte();
+        while (file_len > 0 && !last_error)
+        {
+            int block = HMM_MIN(file_len, (uint32_t)kVerifyBlockSize);
+
+            SaveChunkGetBytes(scratch.data(), block);
+            file_len -= block;
+        }
 
         // run out of data ?
         if (last_error)
@@ -248,8 +303,13 @@ bool SaveFileVerifyContents(void)
     }
 
     // Move file pointer back to beginning
-    fseek(current_file_pointer, kFirstChunkOffset, SEEK_SET);
-    clearerr(current_file_pointer);
+    if (current_file_pointer)
+    {
+        fseek(current_file_pointer, kFirstChunkOffset, SEEK_SET);
+        clearerr(current_file_pointer);
+    }
+    else
+        memory_position = memory_start + kFirstChunkOffset;
 
     return true;
 }
@@ -265,27 +325,13 @@ uint8_t SaveChunkGetByte(void)
     // read directly from file when no chunks are on the stack
     if (chunk_stack_size == 0)
     {
-        int c = fgetc(current_file_pointer);
-
-        if (c == EOF)
-        {
-            FatalError("LOADGAME: Corrupt Savegame (reached EOF).\n");
-        }
-
-        current_crc += (uint8_t)c;
+        SaveChunkGetBytes(&result, 1);
 
 #if (EDGE_DEBUG_SAVE_GET_BYTE)
-        {
-            static int position = 0;
-            position++;
-            LogDebug("%08X: %02X \n", ftell(current_file_pointer), c);
-            //			LogDebug("0.%02X%s", result, ((position %
-            // 10)==0) ?
-            //"\n" : " ");
-        }
+        LogDebug("0.%02X\n", result);
 #endif
 
-        return (uint8_t)c;
+        return result;
     }
 
     cur = &chunk_stack[chunk_stack_size - 1];
@@ -313,6 +359,51 @@ uint8_t SaveChunkGetByte(void)
     return result;
 }
 
+void SaveChunkGetBytes(uint8_t *dest, int len)
+{
+    EPI_ASSERT(len >= 0);
+
+    if (last_error)
+    {
+        memset(dest, 0, len);
+        return;
+    }
+
+    // read directly from file (or memory) when no chunks are on the stack
+    if (chunk_stack_size == 0)
+    {
+        if (memory_start)
+        {
+            if (memory_end - memory_position < len)
+                FatalError("LOADGAME: Corrupt Savegame (reached EOF).\n");
+
+            memcpy(dest, memory_position, len);
+            memory_position += len;
+        }
+        else if (fread(dest, 1, len, current_file_pointer) != (size_t)len)
+        {
+            FatalError("LOADGAME: Corrupt Savegame (reached EOF).\n");
+        }
+
+        current_crc.AddBlock(dest, len);
+        return;
+    }
+
+    SaveChunk *cur = &chunk_stack[chunk_stack_size - 1];
+
+    EPI_ASSERT(cur->start);
+    EPI_ASSERT(cur->position >= cur->start);
+    EPI_ASSERT(cur->position <= cur->end);
+
+    if (cur->end - cur->position < len)
+    {
+        FatalError("LOADGAME: Corrupt Savegame (reached end of [%s] chunk).\n", cur->start_marker);
+    }
+
+    memcpy(dest, cur->position, len);
+    cur->position += len;
+}
+
 bool SavePushReadChunk(const char *id)
 {
     SaveChunk *cur;
@@ -337,8 +428,6 @@ bool SavePushReadChunk(const char *id)
     // top level chunk ?
     if (chunk_stack_size == 0)
     {
-        uint32_t i;
-
         uint32_t orig_len;
         uint32_t decomp_len;
 
@@ -349,8 +438,7 @@ bool SavePushReadChunk(const char *id)
 
         uint8_t *file_data = new uint8_t[file_len + 1];
 
-        for (i = 0; (i < file_len) && !last_error; i++)
-            file_data[i] = SaveChunkGetByte();
+        SaveChunkGetBytes(file_data, file_len);
 
         EPI_ASSERT(!last_error);
 
@@ -457,50 +545,196 @@ bool SaveFileOpenWrite(const std::string &filename, int version)
 {
     LogDebug("Opening savegame file (W): %s\n", filename.c_str());
 
+    if (pending_file)
+        FatalError("SV_OpenWriteFile: Previous file was never closed.\n");
+
     chunk_stack_size = 0;
     last_error       = 0;
 
-    current_crc.Reset();
+    // nothing touches the disk until the file is written out
+    pending_file = new SavePendingFile;
 
-    current_file_pointer = epi::FileOpenRaw(filename, epi::kFileAccessWrite | epi::kFileAccessBinary);
+    pending_file->filename_ = filename;
+    pending_file->version_  = version;
 
-    if (!current_file_pointer)
+    return true;
+}
+
+SavePendingFile *SaveFileFinishWrite(void)
+{
+    EPI_ASSERT(pending_file);
+
+    if (chunk_stack_size != 0)
+        FatalError("SV_CloseWriteFile: Too many Pushes (missing Pop somewhere).\n");
+
+    SavePendingFile *file = pending_file;
+    pending_file          = nullptr;
+
+    return file;
+}
+
+bool SaveFileCloseWrite(void)
+{
+    SavePendingFile *file = SaveFileFinishWrite();
+
+    std::string error;
+
+    bool ok = SavePendingFileWrite(file, error);
+
+    SavePendingFileFree(file);
+
+    if (!ok)
+        LogWarning("%s", error.c_str());
+
+    return ok;
+}
+
+//
+// Compresses each top-level chunk and writes the whole file, including
+// header and trailer.  Only touches `file`, so this is safe to call on
+// another thread while the game carries on.
+//
+bool SavePendingFileWrite(SavePendingFile *file, std::string &error)
+{
+    epi::FileDelete(file->filename_);
+
+    FILE *fp = epi::FileOpenRaw(file->filename_, epi::kFileAccessWrite | epi::kFileAccessBinary);
+
+    if (!fp)
     {
-        LogWarning("SAVEGAME: Couldn't open file: %s\n", filename.c_str());
+        error = epi::StringFormat("SAVEGAME: Couldn't open file: %s\n", file->filename_.c_str());
         return false;
     }
 
-    // write header
+    epi::CRC32 crc;
 
-    PutMagic();
-    PutPadding();
-    SaveChunkPutInteger(version);
+    // header: magic, padding, version
+    uint8_t header[16];
 
-    return true;
+    memcpy(header, kEdgeSaveMagic, 8);
+    header[8]  = 0x1A;
+    header[9]  = 0x0D;
+    header[10] = 0x0A;
+    header[11] = 0x00;
+    EncodeInteger(header + 12, (uint32_t)file->version_);
+
+    fwrite(header, 1, sizeof(header), fp);
+    crc.AddBlock(header, sizeof(header));
+
+    for (const SavePendingChunk &chunk : file->chunks_)
+    {
+        int len = chunk.length;
+
+        // the marker and both lengths are placed in front of the
+        // compressed data, so the whole chunk is a single write.
+        uLongf out_len = (compressBound(len) + 4);
+
+        uint8_t *out_buf = new uint8_t[kTopLevelChunkHeader + out_len + 1];
+        uint8_t *data    = out_buf + kTopLevelChunkHeader;
+
+        int res = compress2(data, &out_len, chunk.data, len, Z_BEST_SPEED);
+
+        if (res != Z_OK || (int)out_len >= len)
+        {
+#if (EDGE_DEBUG_SAVE_CHUNK_COMPRESS)
+            LogDebug("WriteChunk UNCOMPRESSED (res %d != %d, out_len %d >= %d)\n", res, Z_OK, (int)out_len, len);
+#endif
+            // compression failed, so write uncompressed
+            memcpy(data, chunk.data, len);
+            out_len = len;
+        }
+#if (EDGE_DEBUG_SAVE_CHUNK_COMPRESS)
+        else
+        {
+            LogDebug("WriteChunk compress (res %d == %d, out_len %d < %d)\n", res, Z_OK, (int)out_len, len);
+        }
+#endif
+
+        EPI_ASSERT((int)out_len <= (int)(compressBound(len) + 4));
+
+        memcpy(out_buf, chunk.marker, 4);
+
+        // compressed length, then original length
+        EncodeInteger(out_buf + 4, (uint32_t)out_len);
+        EncodeInteger(out_buf + 8, (uint32_t)len);
+
+        fwrite(out_buf, 1, kTopLevelChunkHeader + out_len, fp);
+        crc.AddBlock(out_buf, kTopLevelChunkHeader + (int)out_len);
+
+        delete[] out_buf;
+    }
+
+    // trailer: end marker, magic, CRC of everything before it
+    uint8_t trailer[16];
+
+    memcpy(trailer, kDataEndMarker, 4);
+    memcpy(trailer + 4, kEdgeSaveMagic, 8);
+
+    crc.AddBlock(trailer, 12);
+    EncodeInteger(trailer + 12, crc.GetCRC());
+
+    fwrite(trailer, 1, sizeof(trailer), fp);
+
+    bool ok = !ferror(fp);
+
+    if (fclose(fp) != 0)
+        ok = false;
+
+    if (!ok)
+        error = epi::StringFormat("SAVEGAME: Write error occurred in file: %s\n", file->filename_.c_str());
+
+    return ok;
 }
 
-bool SaveFileCloseWrite(void)
+//
+// Flattens the file into a complete (but uncompressed) savegame image,
+// for keeping snapshots in memory.  SaveMemoryOpenRead() reads it back.
+//
+void SavePendingFileImage(SavePendingFile *file, std::vector<uint8_t> &image)
 {
-    EPI_ASSERT(current_file_pointer);
+    size_t total = 16 + 16;
 
-    if (chunk_stack_size != 0)
-        FatalError("SV_CloseWriteFile: Too many Pushes (missing Pop somewhere).\n");
+    for (const SavePendingChunk &chunk : file->chunks_)
+        total += kTopLevelChunkHeader + chunk.length;
 
-    // write trailer
+    image.resize(total);
 
-    SaveChunkPutMarker(kDataEndMarker);
-    PutMagic();
+    uint8_t *pos = image.data();
 
-    epi::CRC32 final_crc(current_crc);
+    memcpy(pos, kEdgeSaveMagic, 8);
+    pos[8]  = 0x1A;
+    pos[9]  = 0x0D;
+    pos[10] = 0x0A;
+    pos[11] = 0x00;
+    EncodeInteger(pos + 12, (uint32_t)file->version_);
+    pos += 16;
 
-    SaveChunkPutInteger(final_crc.GetCRC());
+    // the same length twice means "stored", i.e. not compressed
+    for (const SavePendingChunk &chunk : file->chunks_)
+    {
+        memcpy(pos, chunk.marker, 4);
+        EncodeInteger(pos + 4, (uint32_t)chunk.length);
+        EncodeInteger(pos + 8, (uint32_t)chunk.length);
+        memcpy(pos + kTopLevelChunkHeader, chunk.data, chunk.length);
 
-    if (last_error)
-        LogWarning("SAVEGAME: Error(s) occurred during writing.\n");
+        pos += kTopLevelChunkHeader + chunk.length;
+    }
 
-    fclose(current_file_pointer);
+    memcpy(pos, kDataEndMarker, 4);
+    memcpy(pos + 4, kEdgeSaveMagic, 8);
 
-    return true;
+    epi::CRC32 crc;
+    crc.AddBlock(image.data(), (int)(total - 4));
+
+    EncodeInteger(pos + 12, crc.GetCRC());
+}
+
+void SavePendingFileFree(SavePendingFile *file)
+{
+    for (SavePendingChunk &chunk : file->chunks_)
+        delete[] chunk.data;
+
+    delete file;
 }
 
 bool SavePushWriteChunk(const char *id)
@@ -531,7 +765,6 @@ bool SavePushWriteChunk(const char *id)
 
 bool SavePopWriteChunk(void)
 {
-    int        i;
     SaveChunk *cur;
     int        len;
 
@@ -547,65 +780,40 @@ bool SavePopWriteChunk(void)
     len = cur->position - cur->start;
 
     // pad chunk to multiple of 4 characters
-    for (; len & 3; len++)
-        SaveChunkPutByte(0);
+    if (len & 3)
+    {
+        static const uint8_t zeros[4] = {0, 0, 0, 0};
+
+        SaveChunkPutBytes(zeros, 4 - (len & 3));
+        len = (len + 3) & ~3;
+    }
 
     // decrement stack size, so future PutBytes go where they should
     chunk_stack_size--;
 
-    // firstly, write out marker
-    SaveChunkPutMarker(cur->start_marker);
-
-    // write out data.  For top-level chunks, compress it.
+    // Top-level chunks are kept until the whole file is written out by
+    // SavePendingFileWrite(), which also compresses them.
 
     if (chunk_stack_size == 0)
     {
-        uLongf out_len = (compressBound(len) + 4);
+        EPI_ASSERT(pending_file);
 
-        uint8_t *out_buf = new uint8_t[out_len + 1];
+        SavePendingChunk chunk;
 
-        int res = compress2(out_buf, &out_len, cur->start, len, Z_BEST_SPEED);
+        memcpy(chunk.marker, cur->start_marker, sizeof(chunk.marker));
+        chunk.data   = cur->start;
+        chunk.length = len;
 
-        if (res != Z_OK || (int)out_len >= len)
-        {
-#if (EDGE_DEBUG_SAVE_CHUNK_COMPRESS)
-            LogDebug("WriteChunk UNCOMPRESSED (res %d != %d, out_len %d >= %d)\n", res, Z_OK, (int)out_len, len);
-#endif
-            // compression failed, so write uncompressed
-            memcpy(out_buf, cur->start, len);
-            out_len = len;
-        }
-#if (EDGE_DEBUG_SAVE_CHUNK_COMPRESS)
-        else
-        {
-            LogDebug("WriteChunk compress (res %d == %d, out_len %d < %d)\n", res, Z_OK, (int)out_len, len);
-        }
-#endif
+        pending_file->chunks_.push_back(chunk);
 
-        EPI_ASSERT((int)out_len <= (int)(compressBound(len) + 4));
-
-        // write compressed length
-        SaveChunkPutInteger((int)out_len);
-
-        // write original length to parent
-        SaveChunkPutInteger(len);
-
-        for (i = 0; i < (int)out_len && !last_error; i++)
-            SaveChunkPutByte(out_buf[i]);
-
-        EPI_ASSERT(!last_error);
-
-        delete[] out_buf;
+        cur->start = cur->position = cur->end = nullptr;
+        return true;
     }
-    else
-    {
-        // write chunk length to parent
-        SaveChunkPutInteger(len);
 
-        // FIXME: optimise this (transfer data directly into parent)
-        for (i = 0; i < len; i++)
-            SaveChunkPutByte(cur->start[i]);
-    }
+    // write marker and chunk length to parent, then the data itself
+    SaveChunkPutMarker(cur->start_marker);
+    SaveChunkPutInteger(len);
+    SaveChunkPutBytes(cur->start, len);
 
     // all done, free stuff
     delete[] cur->start;
@@ -629,21 +837,8 @@ void SaveChunkPutByte(uint8_t value)
     if (last_error)
         return;
 
-    // write directly to the file when chunk stack is empty
     if (chunk_stack_size == 0)
-    {
-        fputc(value, current_file_pointer);
-
-        if (ferror(current_file_pointer))
-        {
-            LogWarning("SAVEGAME: Write error occurred !\n");
-            last_error = 3;
-            return;
-        }
-
-        current_crc += (uint8_t)value;
-        return;
-    }
+        FatalError("SV_PutByte: Data written outside of a chunk.\n");
 
     cur = &chunk_stack[chunk_stack_size - 1];
 
@@ -671,6 +866,46 @@ void SaveChunkPutByte(uint8_t value)
     *(cur->position++) = value;
 }
 
+void SaveChunkPutBytes(const uint8_t *data, int len)
+{
+    EPI_ASSERT(len >= 0);
+
+    if (last_error)
+        return;
+
+    if (chunk_stack_size == 0)
+        FatalError("SV_PutBytes: Data written outside of a chunk.\n");
+
+    SaveChunk *cur = &chunk_stack[chunk_stack_size - 1];
+
+    EPI_ASSERT(cur->start);
+    EPI_ASSERT(cur->position >= cur->start);
+    EPI_ASSERT(cur->position <= cur->end);
+
+    // space left in chunk ?  If not, resize it.
+    if (cur->end - cur->position < len)
+    {
+        int old_len      = (cur->end - cur->start);
+        int position_idx = (cur->position - cur->start);
+        int new_len      = old_len * 2;
+
+        while (new_len - position_idx < len)
+            new_len *= 2;
+
+        uint8_t *new_start = new uint8_t[new_len];
+        memcpy(new_start, cur->start, position_idx);
+
+        delete[] cur->start;
+        cur->start = new_start;
+
+        cur->end      = cur->start + new_len;
+        cur->position = cur->start + position_idx;
+    }
+
+    memcpy(cur->position, data, len);
+    cur->position += len;
+}
+
 //----------------------------------------------------------------------------
 
 //
@@ -679,32 +914,33 @@ void SaveChunkPutByte(uint8_t value)
 
 void SaveChunkPutShort(uint16_t value)
 {
-    SaveChunkPutByte(value & 0xff);
-    SaveChunkPutByte(value >> 8);
+    uint8_t buffer[2] = {(uint8_t)(value & 0xff), (uint8_t)(value >> 8)};
+
+    SaveChunkPutBytes(buffer, 2);
 }
 
 void SaveChunkPutInteger(uint32_t value)
 {
-    SaveChunkPutShort(value & 0xffff);
-    SaveChunkPutShort(value >> 16);
+    uint8_t buffer[4];
+
+    EncodeInteger(buffer, value);
+    SaveChunkPutBytes(buffer, 4);
 }
 
 uint16_t SaveChunkGetShort(void)
 {
-    // -ACB- 2004/02/08 Force the order of execution; otherwise
-    // compilr optimisations may reverse the order of execution
-    uint8_t b1 = SaveChunkGetByte();
-    uint8_t b2 = SaveChunkGetByte();
-    return b1 | (b2 << 8);
+    uint8_t buffer[2];
+
+    SaveChunkGetBytes(buffer, 2);
+    return buffer[0] | (buffer[1] << 8);
 }
 
 uint32_t SaveChunkGetInteger(void)
 {
-    // -ACB- 2004/02/08 Force the order of execution; otherwise
-    // compiler optimisations may reverse the order of execution
-    uint16_t s1 = SaveChunkGetShort();
-    uint16_t s2 = SaveChunkGetShort();
-    return s1 | (s2 << 16);
+    uint8_t buffer[4];
+
+    SaveChunkGetBytes(buffer, 4);
+    return DecodeInteger(buffer);
 }
 
 //----------------------------------------------------------------------------
@@ -770,24 +1006,21 @@ void SaveChunkPutString(const char *str)
         return;
     }
 
-    SaveChunkPutByte(kStringMarker);
-    SaveChunkPutShort(strlen(str));
+    int len = strlen(str);
 
-    for (; *str; str++)
-        SaveChunkPutByte(*str);
+    SaveChunkPutByte(kStringMarker);
+    SaveChunkPutShort(len);
+    SaveChunkPutBytes((const uint8_t *)str, len);
 }
 
 void SaveChunkPutMarker(const char *id)
 {
-    int i;
-
     // LogPrint("ID: %s\n", id);
 
     EPI_ASSERT(id);
     EPI_ASSERT(strlen(id) == 4);
 
-    for (i = 0; i < 4; i++)
-        SaveChunkPutByte((uint8_t)id[i]);
+    SaveChunkPutBytes((const uint8_t *)id, 4);
 }
 
 const char *SaveChunkGetString(void)
@@ -805,8 +1038,7 @@ const char *SaveChunkGetString(void)
     char *result = new char[len + 1];
     result[len]  = 0;
 
-    for (int i = 0; i < len; i++)
-        result[i] = (char)SaveChunkGetByte();
+    SaveChunkGetBytes((uint8_t *)result, len);
 
     return result;
 }
@@ -831,15 +1063,107 @@ void SaveChunkFreeString(const char *str)
 
 bool SaveChunkGetMarker(char id[5])
 {
-    int i;
-
-    for (i = 0; i < 4; i++)
-        id[i] = (char)SaveChunkGetByte();
+    SaveChunkGetBytes((uint8_t *)id, 4);
 
     id[4] = 0;
 
     return VerifyMarker(id);
 }
 
+//----------------------------------------------------------------------------
+//  BENCHMARK
+//----------------------------------------------------------------------------
+
+//
+// Writes and reads back a savegame holding a single "Data" chunk of
+// synthetic map objects, laid out like the real ones (one nested chunk
+// per object, mostly floats and integers plus a few strings).
+//
+void SaveChunkBenchmark(int mobjs)
+{
+    std::string filename = epi::PathAppend(save_directory, "savebench.tmp");
+
+    uint32_t start = GetMicroseconds();
+
+    if (!SaveFileOpenWrite(filename, 0))
+        return;
+
+    SavePushWriteChunk("Data");
+    SaveChunkPutString("mobjs");
+
+    for (int i = 0; i < mobjs; i++)
+    {
+        SavePushWriteChunk("mobj");
+
+        for (int k = 0; k < 32; k++)
+            SaveChunkPutFloat((float)(i * 32 + k) * 0.25f);
+
+        for (int k = 0; k < 12; k++)
+            SaveChunkPutInteger(i ^ (k << 16));
+
+        SaveChunkPutAngle((BAMAngle)i << 12);
+        SaveChunkPutString("IMP");
+        SaveChunkPutString("IMP:CHASE:3");
+        SaveChunkPutString(nullptr);
+
+        SavePopWriteChunk();
+    }
+
+    SavePopWriteChunk();
+    SaveFileCloseWrite();
+
+    uint32_t middle = GetMicroseconds();
+
+    int  version;
+    char marker[6];
+
+    if (!SaveFileOpenRead(filename))
+        return;
+
+    bool verified = SaveFileVerifyHeader(&version) && SaveFileVerifyContents() && SaveChunkGetMarker(marker);
+
+    if (verified)
+    {
+        SavePushReadChunk("Data");
+        SaveChunkFreeString(SaveChunkGetString());
+
+        for (int i = 0; i < mobjs; i++)
+        {
+            SaveChunkGetMarker(marker);
+            SavePushReadChunk("mobj");
+
+            for (int k = 0; k < 32; k++)
+                SaveChunkGetFloat();
+
+            for (int k = 0; k < 12; k++)
+                SaveChunkGetInteger();
+
+            SaveChunkGetAngle();
+
+            for (int k = 0; k < 3; k++)
+                SaveChunkFreeString(SaveChunkGetString());
+
+            SavePopReadChunk();
+        }
+
+        SavePopReadChunk();
+    }
+
+    SaveFileCloseRead();
+
+    uint32_t finish = GetMicroseconds();
+
+    epi::FileDelete(filename);
+
+    if (!verified)
+    {
+        LogWarning("Save benchmark: verification failed\n");
+        return;
+    }
+
+    LogPrint("Save benchmark: %d mobjs, write %1.2f ms, read %1.2f ms\n", mobjs, (middle - start) / 1000.0,
+             (finish - middle) / 1000.0);
+}
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -39,6 +39,7 @@ int SaveGetError(void);
 //
 
 bool SaveFileOpenRead(const std::string &filename);
+bool SaveMemoryOpenRead(const uint8_t *data, int length);
 bool SaveFileCloseRead(void);
 bool SaveFileVerifyHeader(int *version);
 bool SaveFileVerifyContents(void);
@@ -52,6 +53,9 @@ uint8_t  SaveChunkGetByte(void);
 uint16_t SaveChunkGetShort(void);
 uint32_t SaveChunkGetInteger(void);
 
+// reads `len` raw bytes in one go (a single fread at the top level)
+void SaveChunkGetBytes(uint8_t *dest, int len);
+
 BAMAngle SaveChunkGetAngle(void);
 float    SaveChunkGetFloat(void);
 
@@ -65,9 +69,24 @@ bool SaveChunkGetMarker(char id[5]);
 //  WRITING
 //
 
+// Chunks are collected in memory: nothing is written to disk until the
+// file is closed, or finished and passed to SavePendingFileWrite().
 bool SaveFileOpenWrite(const std::string &filename, int version);
 bool SaveFileCloseWrite(void);
 
+class SavePendingFile;
+
+// Detach the collected file, for writing it out later (or elsewhere).
+SavePendingFile *SaveFileFinishWrite(void);
+
+// Compress and write the file.  Safe to call from another thread.
+// On failure a message is stored in `error`.
+bool SavePendingFileWrite(SavePendingFile *file, std::string &error);
+void SavePendingFileFree(SavePendingFile *file);
+
+// Flatten into an uncompressed savegame image, see SaveMemoryOpenRead().
+void SavePendingFileImage(SavePendingFile *file, std::vector<uint8_t> &image);
+
 bool SavePushWriteChunk(const char *id);
 bool SavePopWriteChunk(void);
 
@@ -75,11 +94,22 @@ void SaveChunkPutByte(uint8_t value);
 void SaveChunkPutShort(uint16_t value);
 void SaveChunkPutInteger(uint32_t value);
 
+// appends `len` raw bytes in one go (a single fwrite at the top level)
+void SaveChunkPutBytes(const uint8_t *data, int len);
+
 void SaveChunkPutAngle(BAMAngle value);
 void SaveChunkPutFloat(float value);
 
 void SaveChunkPutString(const char *str);
 void SaveChunkPutMarker(const char *id);
 
+//
+//  BENCHMARK
+//
+
+// Save and reload a synthetic level with `mobjs` map objects, printing
+// the time taken by each half.  Used by the "savebench" console command.
+void SaveChunkBenchmark(int mobjs);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
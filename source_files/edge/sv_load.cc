@@ -106,6 +106,8 @@ void BeginSaveGameLoad(bool is_hub)
 
     for (A = sv_known_arrays; A; A = A->next)
         A->counterpart = nullptr;
+
+    SaveGameClearIndexTables();
 }
 
 static void LoadFreeStruct(SaveStruct *S)
@@ -161,6 +163,8 @@ void FinishSaveGameLoad(void)
 
         LoadFreeArray(A);
     }
+
+    SaveGameClearIndexTables();
 }
 
 static SaveField *StructFindField(SaveStruct *info, const char *name)
@@ -22,14 +22,20 @@
 
 #include "sv_main.h"
 
+#include <deque>
+#include <vector>
+
+#include "con_main.h"
 #include "dm_state.h"
 #include "dstrings.h"
 #include "e_main.h"
 #include "epi.h"
 #include "epi_filesystem.h"
+#include "epi_sdl.h"
 #include "epi_str_util.h"
 #include "f_interm.h"
 #include "g_game.h"
+#include "i_system.h"
 #include "m_math.h"
 #include "m_random.h"
 #include "p_local.h"
@@ -324,7 +330,7 @@ std::string SV_DirName(const char *slot_name)
     return epi::PathAppend(save_directory, slot_name);
 }
 
-void SaveClearSlot(const char *slot_name)
+static bool ClearSlotFiles(const char *slot_name)
 {
     std::string full_dir = SV_DirName(slot_name);
 
@@ -336,7 +342,7 @@ void SaveClearSlot(const char *slot_name)
     if (!ReadDirectory(fsd, full_dir, "*.*"))
     {
         LogDebug("Failed to read directory: %s\n", full_dir.c_str());
-        return;
+        return false;
     }
 
     LogDebug("SV_ClearSlot: removing %d files\n", (int)fsd.size());
@@ -350,9 +356,11 @@ void SaveClearSlot(const char *slot_name)
 
         epi::FileDelete(cur_file);
     }
+
+    return true;
 }
 
-void SaveCopySlot(const char *src_name, const char *dest_name)
+static bool CopySlotFiles(const char *src_name, const char *dest_name, std::string &error)
 {
     std::string src_dir  = SV_DirName(src_name);
     std::string dest_dir = SV_DirName(dest_name);
@@ -360,7 +368,10 @@ void SaveCopySlot(const char *src_name, const char *dest_name)
     std::vector<epi::DirectoryEntry> fsd;
 
     if (!ReadDirectory(fsd, src_dir, "*.*"))
-        FatalError("SV_CopySlot: failed to read dir: %s\n", src_dir.c_str());
+    {
+        error = epi::StringFormat("SV_CopySlot: failed to read dir: %s\n", src_dir.c_str());
+        return false;
+    }
 
     LogDebug("SV_CopySlot: copying %d files\n", (int)fsd.size());
 
@@ -376,7 +387,317 @@ void SaveCopySlot(const char *src_name, const char *dest_name)
         LogDebug("  Copying %s --> %s\n", src_file.c_str(), dest_file.c_str());
 
         if (!epi::FileCopy(src_file, dest_file))
-            FatalError("SV_CopySlot: failed to copy '%s' to '%s'\n", src_file.c_str(), dest_file.c_str());
+        {
+            error = epi::StringFormat("SV_CopySlot: failed to copy '%s' to '%s'\n", src_file.c_str(),
+                                      dest_file.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SaveClearSlot(const char *slot_name)
+{
+    SaveWaitForWrites();
+
+    ClearSlotFiles(slot_name);
+}
+
+void SaveCopySlot(const char *src_name, const char *dest_name)
+{
+    SaveWaitForWrites();
+
+    std::string error;
+
+    if (!CopySlotFiles(src_name, dest_name, error))
+        FatalError("%s", error.c_str());
+}
+
+//----------------------------------------------------------------------------
+//  BACKGROUND WRITER
+//----------------------------------------------------------------------------
+
+// Compressing and writing a savegame is done on a worker thread, so that
+// hub transitions and saving from the menu don't stall the game.  Tasks
+// are handled strictly in order, which keeps back-to-back saves to the
+// same slot (and the "current" directory shared by all of them) sane.
+// Anything on the main thread which reads or modifies the save
+// directories waits for the queue to drain first.
+
+#if !defined(EDGE_WEB) || defined(EDGE_WEB_MULTITHREADED)
+#define SAVE_WRITER_THREAD
+#endif
+
+class SaveWriteTask
+{
+  public:
+    SavePendingFile *file_;
+    std::string      copy_to_; // slot receiving a copy of "current" afterwards
+    std::string      message_; // shown on the console once done
+    bool             fatal_;
+    bool             ok_;
+    std::string      error_;
+
+    SaveWriteFinished finished_;
+    void             *finished_data_;
+
+    // a job instead of a file to write
+    void (*job_)(void *data);
+    void *job_data_;
+};
+
+static std::deque<SaveWriteTask *>  write_queue;
+static std::vector<SaveWriteTask *> write_finished;
+static bool                         write_busy = false;
+
+#ifdef SAVE_WRITER_THREAD
+static SDL_mutex  *write_lock   = nullptr;
+static SDL_cond   *write_wake   = nullptr;
+static SDL_cond   *write_done   = nullptr;
+static SDL_Thread *write_thread = nullptr;
+static bool        write_quit   = false;
+#endif
+
+static void RunWriteTask(SaveWriteTask *task)
+{
+    if (task->job_ != nullptr)
+    {
+        (*task->job_)(task->job_data_);
+        task->ok_ = true;
+        return;
+    }
+
+    task->ok_ = SavePendingFileWrite(task->file_, task->error_);
+
+    SavePendingFileFree(task->file_);
+    task->file_ = nullptr;
+
+    if (task->ok_ && !task->copy_to_.empty())
+    {
+        ClearSlotFiles(task->copy_to_.c_str());
+
+        task->ok_ = CopySlotFiles("current", task->copy_to_.c_str(), task->error_);
+    }
+}
+
+#ifdef SAVE_WRITER_THREAD
+static int SaveWriterProc(void *data)
+{
+    EPI_UNUSED(data);
+
+    SDL_LockMutex(write_lock);
+
+    while (!write_quit)
+    {
+        if (write_queue.empty())
+        {
+            SDL_CondWait(write_wake, write_lock);
+            continue;
+        }
+
+        SaveWriteTask *task = write_queue.front();
+        write_queue.pop_front();
+
+        write_busy = true;
+
+        SDL_UnlockMutex(write_lock);
+        RunWriteTask(task);
+        SDL_LockMutex(write_lock);
+
+        write_busy = false;
+        write_finished.push_back(task);
+
+        SDL_CondBroadcast(write_done);
+    }
+
+    SDL_UnlockMutex(write_lock);
+
+    return 0;
+}
+#endif
+
+static void StartSaveWriter(void)
+{
+#ifdef SAVE_WRITER_THREAD
+    if (write_lock != nullptr)
+        return;
+
+    write_lock = SDL_CreateMutex();
+    write_wake = SDL_CreateCond();
+    write_done = SDL_CreateCond();
+    write_quit = false;
+
+    write_thread = SDL_CreateThread(SaveWriterProc, "SaveWriter", nullptr);
+
+    if (write_thread == nullptr)
+        LogWarning("SaveWriter: unable to create thread, saving in the foreground\n");
+#endif
+}
+
+static void QueueWriteTask(SaveWriteTask *task)
+{
+    StartSaveWriter();
+
+#ifdef SAVE_WRITER_THREAD
+    if (write_thread != nullptr)
+    {
+        SDL_LockMutex(write_lock);
+        write_queue.push_back(task);
+        SDL_UnlockMutex(write_lock);
+
+        SDL_CondSignal(write_wake);
+        return;
+    }
+#endif
+
+    RunWriteTask(task);
+    write_finished.push_back(task);
+}
+
+void SaveQueueWrite(SavePendingFile *file, const char *copy_to_slot, const char *message, bool fatal,
+                    SaveWriteFinished finished, void *finished_data)
+{
+    SaveWriteTask *task = new SaveWriteTask;
+
+    task->file_          = file;
+    task->copy_to_       = copy_to_slot ? copy_to_slot : "";
+    task->message_       = message ? message : "";
+    task->fatal_         = fatal;
+    task->ok_            = false;
+    task->finished_      = finished;
+    task->finished_data_ = finished_data;
+    task->job_           = nullptr;
+    task->job_data_      = nullptr;
+
+    QueueWriteTask(task);
+}
+
+void SaveQueueJob(void (*job)(void *data), void *data)
+{
+    SaveWriteTask *task = new SaveWriteTask;
+
+    task->file_          = nullptr;
+    task->fatal_         = false;
+    task->ok_            = false;
+    task->finished_      = nullptr;
+    task->finished_data_ = nullptr;
+    task->job_           = job;
+    task->job_data_      = data;
+
+    QueueWriteTask(task);
+}
+
+static void WaitForWriteQueue(void)
+{
+#ifdef SAVE_WRITER_THREAD
+    if (write_thread == nullptr)
+        return;
+
+    SDL_LockMutex(write_lock);
+
+    while (!write_queue.empty() || write_busy)
+        SDL_CondWait(write_done, write_lock);
+
+    SDL_UnlockMutex(write_lock);
+#endif
+}
+
+static void TakeFinishedWrites(std::vector<SaveWriteTask *> &list)
+{
+#ifdef SAVE_WRITER_THREAD
+    if (write_lock != nullptr)
+        SDL_LockMutex(write_lock);
+#endif
+
+    list.swap(write_finished);
+
+#ifdef SAVE_WRITER_THREAD
+    if (write_lock != nullptr)
+        SDL_UnlockMutex(write_lock);
+#endif
+}
+
+void SaveWriterTicker(void)
+{
+    std::vector<SaveWriteTask *> list;
+
+    TakeFinishedWrites(list);
+
+    for (SaveWriteTask *task : list)
+    {
+        if (task->job_ != nullptr)
+        {
+            delete task;
+            continue;
+        }
+
+        if (task->ok_)
+        {
+            epi::SyncFilesystem();
+
+            if (!task->message_.empty())
+                ConsoleMessage(kConsoleOnly, "%s", task->message_.c_str());
+        }
+        else if (task->fatal_)
+        {
+            FatalError("%s", task->error_.c_str());
+        }
+        else
+        {
+            LogWarning("%s", task->error_.c_str());
+            ConsoleMessage(kConsoleOnly, "Unable to save the game.\n");
+        }
+
+        if (task->finished_ != nullptr)
+            (*task->finished_)(task->ok_, task->finished_data_);
+
+        delete task;
+    }
+}
+
+void SaveWaitForWrites(void)
+{
+    WaitForWriteQueue();
+    SaveWriterTicker();
+}
+
+void SaveShutdownWriter(void)
+{
+    WaitForWriteQueue();
+
+#ifdef SAVE_WRITER_THREAD
+    if (write_lock != nullptr)
+    {
+        SDL_LockMutex(write_lock);
+        write_quit = true;
+        SDL_UnlockMutex(write_lock);
+
+        SDL_CondBroadcast(write_wake);
+
+        if (write_thread != nullptr)
+            SDL_WaitThread(write_thread, nullptr);
+
+        SDL_DestroyCond(write_done);
+        SDL_DestroyCond(write_wake);
+        SDL_DestroyMutex(write_lock);
+
+        write_thread = nullptr;
+        write_lock   = nullptr;
+    }
+#endif
+
+    // too late for anything but a warning
+    std::vector<SaveWriteTask *> list;
+
+    TakeFinishedWrites(list);
+
+    for (SaveWriteTask *task : list)
+    {
+        if (!task->ok_)
+            LogWarning("%s", task->error_.c_str());
+
+        delete task;
     }
 }
 
@@ -275,7 +275,9 @@ void FinishSaveGameLoad(void);
 bool SaveGameStructLoad(void *base, SaveStruct *info);
 bool LoadAllSaveChunks(void);
 
-void BeginSaveGameSave(void);
+// Snapshots (see sv_snapshot.h) must not change the game, so they leave
+// references to removed objects in place instead of clearing them.
+void BeginSaveGameSave(bool snapshot);
 void FinishSaveGameSave(void);
 
 void SaveGameStructSave(void *base, SaveStruct *info);
@@ -286,9 +288,37 @@ const char *SaveMapName(const MapDefinition *map);
 
 std::string SaveFilename(const char *slot_name, const char *map_name);
 
+// both of these wait for any queued writes first
 void SaveClearSlot(const char *slot_name);
 void SaveCopySlot(const char *src_name, const char *dest_name);
 
+//
+//  BACKGROUND WRITING
+//
+
+class SavePendingFile;
+
+typedef void (*SaveWriteFinished)(bool ok, void *data);
+
+// Takes ownership of `file` (see SaveFileFinishWrite) and writes it on the
+// writer thread, followed by copying "current" into `copy_to_slot` when
+// that is not null.  `message` is shown on the console once done; failure
+// is a fatal error when `fatal` is set, otherwise just reported.  Either
+// way `finished` (when not null) is then called on the main thread.
+void SaveQueueWrite(SavePendingFile *file, const char *copy_to_slot, const char *message, bool fatal,
+                    SaveWriteFinished finished = nullptr, void *finished_data = nullptr);
+
+// Runs `job` on the writer thread, in order with the queued writes.
+void SaveQueueJob(void (*job)(void *data), void *data);
+
+// Reports finished writes, called once per frame.
+void SaveWriterTicker(void);
+
+// Blocks until every queued write has finished.
+void SaveWaitForWrites(void);
+
+void SaveShutdownWriter(void);
+
 //
 //  EXTERNAL DEFS
 //
@@ -304,6 +334,11 @@ void SaveGamePutMapObject(void *storage, int index);
 int   SaveGameMapObjectGetIndex(MapObject *elem);
 void *SaveGameMapObjectFindByIndex(int index);
 
+// Drops the index <-> pointer tables used by the above (and the item
+// queue equivalents).  They are rebuilt on first use, and must be dropped
+// whenever a save or load begins or ends.
+void SaveGameClearIndexTables(void);
+
 int   SaveGamePlayerGetIndex(Player *elem);
 void *SaveGamePlayerFindByIndex(int index);
 
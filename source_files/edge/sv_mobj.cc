@@ -27,6 +27,9 @@
 
 #include <string.h>
 
+#include <unordered_map>
+#include <vector>
+
 #include "epi.h"
 #include "epi_str_compare.h"
 #include "epi_str_util.h"
@@ -317,6 +320,24 @@ SaveArray sv_array_iteminque = {
 
 //----------------------------------------------------------------------------
 
+// Index <-> pointer tables for the mobj list and item queue.  Neither
+// list changes while a save or load is in progress, so these are built
+// on first use instead of walking the list for every reference.
+static std::vector<MapObject *>                  mobj_by_index;
+static std::unordered_map<const MapObject *, int> mobj_indexes;
+
+static std::vector<RespawnQueueItem *>                  itemq_by_index;
+static std::unordered_map<const RespawnQueueItem *, int> itemq_indexes;
+
+void SaveGameClearIndexTables(void)
+{
+    mobj_by_index.clear();
+    mobj_indexes.clear();
+
+    itemq_by_index.clear();
+    itemq_indexes.clear();
+}
+
 //
 // SaveGameMapObjectCountElems
 //
@@ -338,17 +359,16 @@ int SaveGameMapObjectCountElems(void)
 //
 void *SaveGameMapObjectFindByIndex(int index)
 {
-    MapObject *cur;
-
-    for (cur = map_object_list_head; cur && index > 0; cur = cur->next_)
-        index--;
+    if (mobj_by_index.empty())
+    {
+        for (MapObject *cur = map_object_list_head; cur; cur = cur->next_)
+            mobj_by_index.push_back(cur);
+    }
 
-    if (!cur)
+    if (index < 0 || index >= (int)mobj_by_index.size())
         FatalError("LOADGAME: Invalid Mobj: %d\n", index);
 
-    EPI_ASSERT(index == 0);
-
-    return cur;
+    return mobj_by_index[index];
 }
 
 //
@@ -358,16 +378,20 @@ void *SaveGameMapObjectFindByIndex(int index)
 //
 int SaveGameMapObjectGetIndex(MapObject *elem)
 {
-    MapObject *cur;
-    int        index;
+    if (mobj_indexes.empty())
+    {
+        int index = 0;
+
+        for (MapObject *cur = map_object_list_head; cur; cur = cur->next_)
+            mobj_indexes[cur] = index++;
+    }
 
-    for (cur = map_object_list_head, index = 0; cur && cur != elem; cur = cur->next_)
-        index++;
+    std::unordered_map<const MapObject *, int>::iterator iter = mobj_indexes.find(elem);
 
-    if (!cur)
+    if (iter == mobj_indexes.end())
         FatalError("LOADGAME: No such MobjPtr: %p\n", elem);
 
-    return index;
+    return iter->second;
 }
 
 void SaveGameMapObjectCreateElems(int num_elems)
@@ -378,6 +402,9 @@ void SaveGameMapObjectCreateElems(int num_elems)
 
     EPI_ASSERT(map_object_list_head == nullptr);
 
+    mobj_by_index.clear();
+    mobj_indexes.clear();
+
     for (; num_elems > 0; num_elems--)
     {
         MapObject *cur = MapObject::Allocate();
@@ -467,16 +494,16 @@ int SV_ItemqCountElems(void)
 //
 void *SV_ItemqFindByIndex(int index)
 {
-    RespawnQueueItem *cur;
-
-    for (cur = respawn_queue_head; cur && index > 0; cur = cur->next)
-        index--;
+    if (itemq_by_index.empty())
+    {
+        for (RespawnQueueItem *cur = respawn_queue_head; cur; cur = cur->next)
+            itemq_by_index.push_back(cur);
+    }
 
-    if (!cur)
+    if (index < 0 || index >= (int)itemq_by_index.size())
         FatalError("LOADGAME: Invalid ItemInQue: %d\n", index);
 
-    EPI_ASSERT(index == 0);
-    return cur;
+    return itemq_by_index[index];
 }
 
 //
@@ -486,16 +513,20 @@ void *SV_ItemqFindByIndex(int index)
 //
 int SV_ItemqGetIndex(RespawnQueueItem *elem)
 {
-    RespawnQueueItem *cur;
-    int               index;
+    if (itemq_indexes.empty())
+    {
+        int index = 0;
 
-    for (cur = respawn_queue_head, index = 0; cur && cur != elem; cur = cur->next)
-        index++;
+        for (RespawnQueueItem *cur = respawn_queue_head; cur; cur = cur->next)
+            itemq_indexes[cur] = index++;
+    }
+
+    std::unordered_map<const RespawnQueueItem *, int>::iterator iter = itemq_indexes.find(elem);
 
-    if (!cur)
+    if (iter == itemq_indexes.end())
         FatalError("LOADGAME: No such ItemInQue ptr: %p\n", elem);
 
-    return index;
+    return iter->second;
 }
 
 //
@@ -507,6 +538,9 @@ void SV_ItemqCreateElems(int num_elems)
 
     respawn_queue_head = nullptr;
 
+    itemq_by_index.clear();
+    itemq_indexes.clear();
+
     for (; num_elems > 0; num_elems--)
     {
         RespawnQueueItem *cur = new RespawnQueueItem;
@@ -36,16 +36,21 @@
 #include "sv_main.h"
 #include "w_wad.h"
 
-void BeginSaveGameSave(void)
+void BeginSaveGameSave(bool snapshot)
 {
     LogDebug("SV_BeginSave...\n");
 
-    ClearAllStaleReferences();
+    if (!snapshot)
+        ClearAllStaleReferences();
+
+    SaveGameClearIndexTables();
 }
 
 void FinishSaveGameSave(void)
 {
     LogDebug("SV_FinishSave...\n");
+
+    SaveGameClearIndexTables();
 }
 
 void SaveGameStructSave(void *base, SaveStruct *info)
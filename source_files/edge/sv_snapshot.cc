@@ -0,0 +1,238 @@
+//----------------------------------------------------------------------------
+//  EDGE In-Memory Savegame Snapshots
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "sv_snapshot.h"
+
+#include <string.h>
+
+#include <deque>
+
+#include "epi.h"
+#include "epi_sdl.h"
+#include "i_system.h"
+#include "miniz.h"
+#include "sv_chunk.h"
+#include "sv_main.h"
+
+// layout of an uncompressed image: 16 byte header, then chunks of
+// marker + length + length + data, then the "ENDE" trailer.
+static constexpr int kImageHeaderSize = 16;
+static constexpr int kChunkHeaderSize = 12;
+
+struct SnapshotEntry
+{
+    int level_time;
+    int length; // of the image itself
+
+    // the image for the newest entry, otherwise the compressed delta
+    // against the next newer one.
+    std::vector<uint8_t> data;
+};
+
+// oldest first
+static std::deque<SnapshotEntry> snapshot_ring;
+
+// deltas still being compressed on the save writer thread
+static SDL_atomic_t snapshot_jobs;
+
+static inline int ReadLength(const uint8_t *src)
+{
+    return (int)(src[0] | (src[1] << 8) | (src[2] << 16) | ((uint32_t)src[3] << 24));
+}
+
+//
+// XORs the data of each chunk in `delta` with the data of the chunk at
+// the same position in `base`.  Headers and lengths are left alone, so
+// this both makes a delta and undoes it.  Chunks line up by position
+// rather than by byte offset, so a change in size (e.g. more mobjs)
+// only affects the chunk it happens in.
+//
+static void XorChunks(std::vector<uint8_t> &delta, const std::vector<uint8_t> &base)
+{
+    int d_pos = kImageHeaderSize;
+    int b_pos = kImageHeaderSize;
+
+    int d_size = (int)delta.size();
+    int b_size = (int)base.size();
+
+    while (d_pos + kChunkHeaderSize <= d_size)
+    {
+        if (memcmp(&delta[d_pos], kDataEndMarker, 4) == 0)
+            break;
+
+        int d_len = ReadLength(&delta[d_pos + 4]);
+
+        EPI_ASSERT(d_pos + kChunkHeaderSize + d_len <= d_size);
+
+        if (b_pos + kChunkHeaderSize <= b_size && memcmp(&base[b_pos], kDataEndMarker, 4) != 0)
+        {
+            int b_len = ReadLength(&base[b_pos + 4]);
+
+            uint8_t       *dest = &delta[d_pos + kChunkHeaderSize];
+            const uint8_t *src  = &base[b_pos + kChunkHeaderSize];
+
+            for (int i = HMM_MIN(d_len, b_len) - 1; i >= 0; i--)
+                dest[i] ^= src[i];
+
+            b_pos += kChunkHeaderSize + b_len;
+        }
+
+        d_pos += kChunkHeaderSize + d_len;
+    }
+}
+
+static void CompressDelta(SnapshotEntry &entry, const std::vector<uint8_t> &newer)
+{
+    XorChunks(entry.data, newer);
+
+    uLongf out_len = compressBound(entry.length);
+
+    std::vector<uint8_t> packed(out_len);
+
+    if (compress2(packed.data(), &out_len, entry.data.data(), entry.length, Z_BEST_SPEED) != Z_OK)
+        FatalError("Snapshot: ZLIB compress error.\n");
+
+    packed.resize(out_len);
+    packed.shrink_to_fit();
+
+    entry.data.swap(packed);
+}
+
+static void ExpandDelta(SnapshotEntry &entry, const std::vector<uint8_t> &newer)
+{
+    std::vector<uint8_t> image(entry.length);
+
+    uLongf out_len = entry.length;
+
+    if (uncompress(image.data(), &out_len, entry.data.data(), (uLong)entry.data.size()) != Z_OK ||
+        (int)out_len != entry.length)
+        FatalError("Snapshot: ZLIB uncompress error.\n");
+
+    XorChunks(image, newer);
+
+    entry.data.swap(image);
+}
+
+struct SnapshotDeltaJob
+{
+    SnapshotEntry              *entry;
+    const std::vector<uint8_t> *newer;
+};
+
+static void SnapshotDeltaJobProc(void *data)
+{
+    SnapshotDeltaJob *job = (SnapshotDeltaJob *)data;
+
+    CompressDelta(*job->entry, *job->newer);
+
+    delete job;
+
+    SDL_AtomicAdd(&snapshot_jobs, -1);
+}
+
+// Entries may only be touched once the writer thread is done with them.
+static void WaitForSnapshotJobs(void)
+{
+    if (SDL_AtomicGet(&snapshot_jobs) > 0)
+        SaveWaitForWrites();
+}
+
+void SnapshotRingPush(std::vector<uint8_t> &image, int level_time, int limit)
+{
+    SnapshotEntry entry;
+
+    entry.level_time = level_time;
+    entry.length     = (int)image.size();
+
+    snapshot_ring.push_back(entry);
+    snapshot_ring.back().data.swap(image);
+
+    if ((int)snapshot_ring.size() > HMM_MAX(1, limit))
+    {
+        WaitForSnapshotJobs();
+
+        while ((int)snapshot_ring.size() > HMM_MAX(1, limit))
+            snapshot_ring.pop_front();
+    }
+
+    if (snapshot_ring.size() < 2)
+        return;
+
+    // the previous newest becomes a delta.  Jobs run in order, and the
+    // newest image is left alone until the next push, so the writer
+    // thread is the only one touching these meanwhile.
+    SnapshotDeltaJob *job = new SnapshotDeltaJob;
+
+    job->entry = &snapshot_ring[snapshot_ring.size() - 2];
+    job->newer = &snapshot_ring.back().data;
+
+    SDL_AtomicAdd(&snapshot_jobs, 1);
+
+    SaveQueueJob(SnapshotDeltaJobProc, job);
+}
+
+bool SnapshotRingRestore(int steps, std::vector<uint8_t> &image, int *level_time)
+{
+    WaitForSnapshotJobs();
+
+    if (steps < 1 || steps > (int)snapshot_ring.size())
+        return false;
+
+    // walk backwards from the newest, which is a plain image
+    for (; steps > 1; steps--)
+    {
+        SnapshotEntry &newest = snapshot_ring.back();
+        SnapshotEntry &older  = snapshot_ring[snapshot_ring.size() - 2];
+
+        ExpandDelta(older, newest.data);
+
+        snapshot_ring.pop_back();
+    }
+
+    image       = snapshot_ring.back().data;
+    *level_time = snapshot_ring.back().level_time;
+
+    return true;
+}
+
+void SnapshotRingClear(void)
+{
+    WaitForSnapshotJobs();
+
+    snapshot_ring.clear();
+}
+
+int SnapshotRingSize(void)
+{
+    return (int)snapshot_ring.size();
+}
+
+size_t SnapshotRingMemory(void)
+{
+    WaitForSnapshotJobs();
+
+    size_t total = 0;
+
+    for (const SnapshotEntry &entry : snapshot_ring)
+        total += entry.data.capacity();
+
+    return total;
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,49 @@
+//----------------------------------------------------------------------------
+//  EDGE In-Memory Savegame Snapshots
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+//  A ring of recent savegame images (see SavePendingFileImage) used for
+//  rewinding.  The newest one is kept as-is, every older one as a
+//  compressed delta against the next newer, XORed chunk by chunk, so
+//  data which did not change costs next to nothing.  The deltas are
+//  compressed on the save writer thread.
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+// Adds `image` (its contents are taken) as the newest snapshot,
+// dropping the oldest ones beyond `limit`.
+void SnapshotRingPush(std::vector<uint8_t> &image, int level_time, int limit);
+
+// Rebuilds the snapshot `steps` back (1 = newest) into `image`.  Newer
+// snapshots are dropped, so the restored one becomes the newest.
+bool SnapshotRingRestore(int steps, std::vector<uint8_t> &image, int *level_time);
+
+void SnapshotRingClear(void);
+
+int SnapshotRingSize(void);
+
+// bytes used by the whole ring
+size_t SnapshotRingMemory(void);
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
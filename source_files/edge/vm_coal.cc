@@ -127,6 +127,54 @@ void COALSetVectorZ(coal::VM *vm, const char *mod_name, const char *var_name, do
     vm->SetVectorZ(mod_name, var_name, val);
 }
 
+struct COALEngineVariableInfo
+{
+    const char *mod_name;
+    const char *var_name;
+    bool        is_vector;
+};
+
+static const COALEngineVariableInfo coal_engine_variable_info[kTotalCOALEngineVariables] = {
+    {"sys", "gametic", false},
+    {"hud", "universal_y_adjust", false},
+    {"hud", "x_left", false},
+    {"hud", "x_right", false},
+    {"player", "inventory_event_handler", true},
+};
+
+static int coal_engine_variables[kTotalCOALEngineVariables];
+
+static void COALBindEngineVariables(void)
+{
+    for (int i = 0; i < kTotalCOALEngineVariables; i++)
+    {
+        const COALEngineVariableInfo &info = coal_engine_variable_info[i];
+
+        if (info.is_vector)
+            coal_engine_variables[i] = ui_vm->BindVector(info.mod_name, info.var_name);
+        else
+            coal_engine_variables[i] = ui_vm->BindFloat(info.mod_name, info.var_name);
+
+        if (coal_engine_variables[i] == coal::VM::NOT_FOUND)
+            LogWarning("COAL: missing variable %s.%s\n", info.mod_name, info.var_name);
+    }
+}
+
+double COALGetFloat(COALEngineVariable var)
+{
+    return ui_vm->GetFloat(coal_engine_variables[var]);
+}
+
+void COALSetFloat(COALEngineVariable var, double value)
+{
+    ui_vm->SetFloat(coal_engine_variables[var], value);
+}
+
+void COALSetVector(COALEngineVariable var, double val_1, double val_2, double val_3)
+{
+    ui_vm->SetVector(coal_engine_variables[var], val_1, val_2, val_3);
+}
+
 void COALCallFunction(coal::VM *vm, const char *name)
 {
     int func = vm->FindFunction(name);
@@ -481,7 +529,9 @@ void COALLoadScripts()
 
     unread_scripts.clear();
 
-    COALSetFloat(ui_vm, "sys", "gametic", game_tic);
+    COALBindEngineVariables();
+
+    COALSetFloat(kCOALVariableGameTic, game_tic);
 
     if (IsLumpInPwad("STBAR"))
     {
@@ -33,6 +33,23 @@ void COALLoadScripts();
 void COALRegisterHUD();
 void COALRegisterPlaysim();
 
+// Variables the engine reads or writes every frame.  These are bound to
+// handles once the scripts have been compiled, instead of being looked
+// up by name on each access.
+enum COALEngineVariable
+{
+    kCOALVariableGameTic = 0,           // sys.gametic
+    kCOALVariableUniversalYAdjust,      // hud.universal_y_adjust
+    kCOALVariableXLeft,                 // hud.x_left
+    kCOALVariableXRight,                // hud.x_right
+    kCOALVariableInventoryEventHandler, // player.inventory_event_handler
+    kTotalCOALEngineVariables
+};
+
+double COALGetFloat(COALEngineVariable var);
+void   COALSetFloat(COALEngineVariable var, double value);
+void   COALSetVector(COALEngineVariable var, double val_1, double val_2, double val_3);
+
 // HUD stuff
 void COALNewGame(void);
 void COALLoadGame(void);
@@ -41,9 +41,6 @@
 
 extern coal::VM *ui_vm;
 
-extern void COALSetVector(coal::VM *vm, const char *mod_name, const char *var_name, double val_1, double val_2,
-                          double val_3);
-extern void COALSetFloat(coal::VM *vm, const char *mod, const char *name, double value);
 extern void COALCallFunction(coal::VM *vm, const char *name);
 
 // Needed for color functions
@@ -100,8 +97,8 @@ static void HD_coord_sys(coal::VM *vm, int argc)
 
     HUDSetCoordinateSystem(w, h);
 
-    COALSetFloat(ui_vm, "hud", "x_left", hud_x_left);
-    COALSetFloat(ui_vm, "hud", "x_right", hud_x_right);
+    COALSetFloat(kCOALVariableXLeft, hud_x_left);
+    COALSetFloat(kCOALVariableXRight, hud_x_right);
 }
 
 // hud.game_mode()
@@ -1214,7 +1211,7 @@ void COALRunHUD(void)
 
     COALCallFunction(ui_vm, "draw_all");
 
-    COALSetVector(ui_vm, "player", "inventory_event_handler", 0, 0, 0);
+    COALSetVector(kCOALVariableInventoryEventHandler, 0, 0, 0);
 
     HUDReset();
 }
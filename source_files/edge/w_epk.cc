@@ -469,6 +469,14 @@ static PackFile *ProcessZip(DataFile *df)
     return pack;
 }
 
+// Entries which get seeked backwards (mainly WADs inside an EPK, whose
+// lumps are read in any order) are inflated once into memory, as long
+// as all such entries together stay below this size.  Anything else
+// has to rewind and inflate again from the start.
+static constexpr size_t kZIPCacheLimit = 256 * 1024 * 1024;
+
+static size_t zip_cache_total = 0;
+
 class ZIPFile : public epi::File
 {
   private:
@@ -481,6 +489,9 @@ class ZIPFile : public epi::File
 
     mz_zip_reader_extract_iter_state *iter = nullptr;
 
+    // the whole entry, once it has been inflated
+    uint8_t *cache = nullptr;
+
   public:
     ZIPFile(PackFile *_pack, mz_uint _idx) : pack(_pack), zip_idx(_idx)
     {
@@ -497,6 +508,12 @@ class ZIPFile : public epi::File
     {
         if (iter != nullptr)
             mz_zip_reader_extract_iter_free(iter);
+
+        if (cache != nullptr)
+        {
+            delete[] cache;
+            zip_cache_total -= length;
+        }
     }
 
     int GetLength() override
@@ -518,6 +535,13 @@ class ZIPFile : public epi::File
         if (count > length - pos)
             count = length - pos;
 
+        if (cache != nullptr)
+        {
+            memcpy(dest, cache + pos, count);
+            pos += count;
+            return count;
+        }
+
         size_t got = mz_zip_reader_extract_iter_read(iter, dest, count);
 
         pos += got;
@@ -559,15 +583,22 @@ class ZIPFile : public epi::File
         if (want_pos > length)
             return false;
 
-        if (want_pos == length)
+        if (want_pos == length || cache != nullptr)
         {
-            pos = length;
+            pos = want_pos;
             return true;
         }
 
-        // to go backwards, we are forced to rewind to beginning
+        // to go backwards, inflate the whole entry into memory if it
+        // fits in the cache, otherwise we are forced to rewind to beginning
         if (want_pos < pos)
         {
+            if (FillCache())
+            {
+                pos = want_pos;
+                return true;
+            }
+
             Rewind();
         }
 
@@ -580,6 +611,28 @@ class ZIPFile : public epi::File
     }
 
   private:
+    bool FillCache()
+    {
+        if (length == 0 || length > kZIPCacheLimit - zip_cache_total)
+            return false;
+
+        uint8_t *data = new uint8_t[length];
+
+        if (!mz_zip_reader_extract_to_mem(pack->archive_, zip_idx, data, length, 0))
+        {
+            delete[] data;
+            return false;
+        }
+
+        mz_zip_reader_extract_iter_free(iter);
+        iter = nullptr;
+
+        cache = data;
+        zip_cache_total += length;
+
+        return true;
+    }
+
     void Rewind()
     {
         mz_zip_reader_extract_iter_free(iter);
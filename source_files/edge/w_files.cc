@@ -54,7 +54,7 @@
 std::vector<DataFile *> data_files;
 
 DataFile::DataFile(std::string_view name, FileKind kind)
-    : name_(name), kind_(kind), file_(nullptr), wad_(nullptr), pack_(nullptr)
+    : name_(name), kind_(kind), file_(nullptr), mapped_(nullptr), wad_(nullptr), pack_(nullptr)
 {
 }
 
@@ -184,7 +184,17 @@ void ProcessFile(DataFile *df)
 
     if (df->kind_ <= kFileKindXWAD)
     {
-        epi::File *file = epi::FileOpen(filename, epi::kFileAccessRead | epi::kFileAccessBinary);
+        epi::File       *file   = nullptr;
+        epi::MappedFile *mapped = epi::FileOpenMapped(filename);
+
+        if (mapped != nullptr)
+        {
+            file        = mapped;
+            df->mapped_ = mapped->GetData();
+        }
+        else
+            file = epi::FileOpen(filename, epi::kFileAccessRead | epi::kFileAccessBinary);
+
         if (file == nullptr)
             FatalError("Couldn't open file: %s\n", filename.c_str());
 
@@ -67,6 +67,10 @@ class DataFile
     // file object   [ TODO review when active ]
     epi::File *file_;
 
+    // when file_ is memory-mapped: the whole file, otherwise nullptr.
+    // lump views point straight into this.
+    const uint8_t *mapped_;
+
     // for kFileKindIWAD, PWAD, EWad, XWAD.
     WadFile *wad_;
 
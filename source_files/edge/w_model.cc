@@ -20,6 +20,7 @@
 
 #include "e_main.h"
 #include "epi.h"
+#include "epi_sdl.h"
 #include "epi_str_compare.h"
 #include "epi_str_util.h"
 #include "i_defs_gl.h"
@@ -337,12 +338,26 @@ ModelDefinition *GetModel(int model_num)
     EPI_ASSERT(model_num > 0);
     EPI_ASSERT(model_num < total_models);
 
-    if (!models[model_num])
+    ModelDefinition *md = (ModelDefinition *)SDL_AtomicGetPtr((void **)&models[model_num]);
+
+    if (!md)
     {
-        models[model_num] = LoadModelFromLump(model_num);
+        // only the main thread loads models, the BSP threads use
+        // GetLoadedModel() instead.
+        md = LoadModelFromLump(model_num);
+
+        SDL_AtomicSetPtr((void **)&models[model_num], md);
     }
 
-    return models[model_num];
+    return md;
+}
+
+ModelDefinition *GetLoadedModel(int model_num)
+{
+    EPI_ASSERT(model_num > 0);
+    EPI_ASSERT(model_num < total_models);
+
+    return (ModelDefinition *)SDL_AtomicGetPtr((void **)&models[model_num]);
 }
 
 void PrecacheModels(void)
@@ -50,7 +50,11 @@ void InitializeModels(void);
 
 void PrecacheModels(void);
 
+// Loads the model on first use, so must only be called from the main thread.
 ModelDefinition *GetModel(int model_num);
 
+// Safe from any thread: returns nullptr if the model is not loaded yet.
+ModelDefinition *GetLoadedModel(int model_num);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -88,7 +88,7 @@ static void InstallTextureLumps(int file, const WadTextureResource *WT)
     const int *directory;
 
     // Load the patch names from pnames.lmp.
-    const char *names         = (const char *)LoadLumpIntoMemory(WT->pnames);
+    const char *names         = (const char *)LoadLumpView(WT->pnames);
     int         nummappatches = AlignedLittleEndianS32(*((const int *)names)); // Eww...
 
     const char *name_p = names + 4;
@@ -108,7 +108,7 @@ static void InstallTextureLumps(int file, const WadTextureResource *WT)
         patchlookup[i] = CheckPatchLumpNumberForName(patch_names[i].c_str());
     }
 
-    delete[] names;
+    ReleaseLumpView(WT->pnames, (const uint8_t *)names);
 
     //
     // Load the map texture definitions from textures.lmp.
@@ -117,14 +117,14 @@ static void InstallTextureLumps(int file, const WadTextureResource *WT)
     //   TEXTURE1 for shareware
     //   TEXTURE2 for commercial.
     //
-    maptex = maptex1 = (const int *)LoadLumpIntoMemory(WT->texture1);
+    maptex = maptex1 = (const int *)LoadLumpView(WT->texture1);
     numtextures1     = AlignedLittleEndianS32(*maptex);
     maxoff           = GetLumpLength(WT->texture1);
     directory        = maptex + 1;
 
     if (WT->texture2 != -1)
     {
-        maptex2      = (const int *)LoadLumpIntoMemory(WT->texture2);
+        maptex2      = (const int *)LoadLumpView(WT->texture2);
         numtextures2 = AlignedLittleEndianS32(*maptex2);
         maxoff2      = GetLumpLength(WT->texture2);
     }
@@ -227,10 +227,10 @@ static void InstallTextureLumps(int file, const WadTextureResource *WT)
     // free stuff
     patch_names.clear();
 
-    delete[] maptex1;
+    ReleaseLumpView(WT->texture1, (const uint8_t *)maptex1);
 
     if (maptex2)
-        delete[] maptex2;
+        ReleaseLumpView(WT->texture2, (const uint8_t *)maptex2);
 
     delete[] patchlookup;
 }
@@ -249,7 +249,7 @@ static void InstallTextureLumpsStrife(int file, const WadTextureResource *WT)
     const int *directory;
 
     // Load the patch names from pnames.lmp.
-    const char *names         = (const char *)LoadLumpIntoMemory(WT->pnames);
+    const char *names         = (const char *)LoadLumpView(WT->pnames);
     int         nummappatches = AlignedLittleEndianS32(*((const int *)names)); // Eww...
 
     const char *name_p = names + 4;
@@ -269,7 +269,7 @@ static void InstallTextureLumpsStrife(int file, const WadTextureResource *WT)
         patchlookup[i] = CheckPatchLumpNumberForName(patch_names[i].c_str());
     }
 
-    delete[] names;
+    ReleaseLumpView(WT->pnames, (const uint8_t *)names);
 
     //
     // Load the map texture definitions from textures.lmp.
@@ -278,14 +278,14 @@ static void InstallTextureLumpsStrife(int file, const WadTextureResource *WT)
     //   TEXTURE1 for shareware
     //   TEXTURE2 for commercial.
     //
-    maptex = maptex1 = (const int *)LoadLumpIntoMemory(WT->texture1);
+    maptex = maptex1 = (const int *)LoadLumpView(WT->texture1);
     numtextures1     = AlignedLittleEndianS32(*maptex);
     maxoff           = GetLumpLength(WT->texture1);
     directory        = maptex + 1;
 
     if (WT->texture2 != -1)
     {
-        maptex2      = (const int *)LoadLumpIntoMemory(WT->texture2);
+        maptex2      = (const int *)LoadLumpView(WT->texture2);
         numtextures2 = AlignedLittleEndianS32(*maptex2);
         maxoff2      = GetLumpLength(WT->texture2);
     }
@@ -382,10 +382,10 @@ static void InstallTextureLumpsStrife(int file, const WadTextureResource *WT)
     // free stuff
     patch_names.clear();
 
-    delete[] maptex1;
+    ReleaseLumpView(WT->texture1, (const uint8_t *)maptex1);
 
     if (maptex2)
-        delete[] maptex2;
+        ReleaseLumpView(WT->texture2, (const uint8_t *)maptex2);
 
     delete[] patchlookup;
 }
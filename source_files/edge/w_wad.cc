@@ -57,6 +57,7 @@
 #include "epi_file.h"
 #include "epi_filesystem.h"
 #include "epi_md5.h"
+#include "epi_sdl.h"
 #include "epi_str_compare.h"
 #include "epi_str_util.h"
 #include "i_system.h"
@@ -163,6 +164,12 @@ void CloseWADFile(DataFile *df)
     df->wad_ = nullptr;
 }
 
+std::string GetWADFileMD5(DataFile *df)
+{
+    EPI_ASSERT(df->wad_);
+    return df->wad_->md5_string_;
+}
+
 enum LumpKind
 {
     kLumpNormal   = 0,  // fallback value
@@ -1208,6 +1215,94 @@ void ProcessWad(DataFile *df, size_t file_index)
     ProcessLuaInWad(df);
 }
 
+#if !defined(EDGE_WEB) || defined(EDGE_WEB_MULTITHREADED)
+#define XGL_MULTITHREAD
+#endif
+
+#ifdef XGL_MULTITHREAD
+
+// Levels are handed out in order to the worker threads.  Loading a level
+// and saving its nodes both touch the wad files, so they happen under
+// `lock`; the nodes are saved in level order so the XWA file is the same
+// as one from a serial build.
+
+struct XGLBuildQueue
+{
+    SDL_mutex   *lock;
+    SDL_cond    *level_saved;
+    SDL_atomic_t next_level;
+    int          next_to_save;
+    int          total_levels;
+};
+
+static int XGLBuildProc(void *data)
+{
+    XGLBuildQueue *queue = (XGLBuildQueue *)data;
+
+    for (;;)
+    {
+        int level = SDL_AtomicAdd(&queue->next_level, 1);
+
+        if (level >= queue->total_levels)
+            break;
+
+        SDL_LockMutex(queue->lock);
+        ajbsp::BeginLevel(level, false);
+        SDL_UnlockMutex(queue->lock);
+
+        ajbsp::BuildLevelNodes();
+
+        SDL_LockMutex(queue->lock);
+
+        while (queue->next_to_save != level)
+            SDL_CondWait(queue->level_saved, queue->lock);
+
+        ajbsp::FinishLevel();
+
+        queue->next_to_save++;
+        SDL_CondBroadcast(queue->level_saved);
+
+        SDL_UnlockMutex(queue->lock);
+    }
+
+    return 0;
+}
+
+static void BuildXGLLevelsParallel(int total_levels, int total_threads)
+{
+    StartupProgressMessage(
+        epi::StringFormat("Building nodes for %d levels (%d threads)\n", total_levels, total_threads).c_str());
+
+    XGLBuildQueue queue;
+
+    queue.lock        = SDL_CreateMutex();
+    queue.level_saved = SDL_CreateCond();
+    SDL_AtomicSet(&queue.next_level, 0);
+    queue.next_to_save = 0;
+    queue.total_levels = total_levels;
+
+    std::vector<SDL_Thread *> threads;
+
+    for (int i = 0; i < total_threads; i++)
+    {
+        SDL_Thread *thread = SDL_CreateThread(XGLBuildProc, "AJBSP", &queue);
+
+        if (thread != nullptr)
+            threads.push_back(thread);
+    }
+
+    // the main thread takes part too, which also covers thread creation failing
+    XGLBuildProc(&queue);
+
+    for (SDL_Thread *thread : threads)
+        SDL_WaitThread(thread, nullptr);
+
+    SDL_DestroyCond(queue.level_saved);
+    SDL_DestroyMutex(queue.lock);
+}
+
+#endif
+
 std::string BuildXGLNodesForWAD(DataFile *df)
 {
     if (df->wad_->level_markers_.empty())
@@ -1244,8 +1339,22 @@ std::string BuildXGLNodesForWAD(DataFile *df)
 
         ajbsp::CreateXWA(xwa_filename);
 
-        for (int i = 0; i < ajbsp::LevelsInWad(); i++)
-            ajbsp::BuildLevel(i);
+        int total_levels = ajbsp::LevelsInWad();
+
+#ifdef XGL_MULTITHREAD
+        // one thread per level where possible, and any CPUs left over
+        // evaluate partitions within each level (a single huge map gets all of them)
+        int total_cpus    = HMM_MAX(1, SDL_GetCPUCount());
+        int level_threads = HMM_MAX(1, HMM_MIN(total_cpus, total_levels));
+
+        ajbsp::SetPartitionThreads(total_cpus / level_threads);
+
+        if (level_threads > 1)
+            BuildXGLLevelsParallel(total_levels, level_threads - 1);
+        else
+#endif
+            for (int i = 0; i < total_levels; i++)
+                ajbsp::BuildLevel(i);
 
         ajbsp::FinishXWA();
         ajbsp::CloseWad();
@@ -1766,6 +1875,13 @@ void ReadUMAPINFOLumps(void)
     }
 }
 
+// the directory of a broken WAD can point past the end of the file
+static void CheckMappedLump(const LumpInfo *L, const DataFile *df, int lump)
+{
+    if (L->position < 0 || L->size < 0 || L->position > df->file_->GetLength() - L->size)
+        FatalError("W_ReadLump: lump %i lies outside of %s", lump, df->name_.c_str());
+}
+
 epi::File *LoadLumpAsFile(int lump)
 {
     EPI_ASSERT(IsLumpIndexValid(lump));
@@ -1776,6 +1892,12 @@ epi::File *LoadLumpAsFile(int lump)
 
     EPI_ASSERT(df->file_);
 
+    if (df->mapped_ != nullptr)
+    {
+        CheckMappedLump(l, df, lump);
+        return new epi::MemFile(df->mapped_ + l->position, l->size, false);
+    }
+
     return new epi::SubFile(df->file_, l->position, l->size);
 }
 
@@ -2204,6 +2326,13 @@ static void W_RawReadLump(int lump, void *dest)
     LumpInfo *L  = &lump_info[lump];
     DataFile *df = data_files[L->file];
 
+    if (df->mapped_ != nullptr)
+    {
+        CheckMappedLump(L, df, lump);
+        memcpy(dest, df->mapped_ + L->position, L->size);
+        return;
+    }
+
     df->file_->Seek(L->position, epi::File::kSeekpointStart);
 
     int c = df->file_->Read(dest, L->size);
@@ -2239,6 +2368,48 @@ uint8_t *LoadLumpIntoMemory(const char *name, int *length)
     return LoadLumpIntoMemory(GetLumpNumberForName(name), length);
 }
 
+// callers read the views through int32_t and struct pointers, and lump
+// offsets inside a WAD are not guaranteed to be aligned.
+static constexpr uintptr_t kLumpViewAlignment = 4;
+
+// true when the lump can be viewed in place, false when it must be copied.
+static bool LumpViewIsMapped(const LumpInfo *L, const DataFile *df)
+{
+    if (df->mapped_ == nullptr)
+        return false;
+
+    return ((uintptr_t)(df->mapped_ + L->position) % kLumpViewAlignment) == 0;
+}
+
+const uint8_t *LoadLumpView(int lump, int *length)
+{
+    if (!IsLumpIndexValid(lump))
+        FatalError("LoadLumpView: %i >= numlumps", lump);
+
+    const LumpInfo *L  = &lump_info[lump];
+    const DataFile *df = data_files[L->file];
+
+    if (!LumpViewIsMapped(L, df))
+        return LoadLumpIntoMemory(lump, length);
+
+    CheckMappedLump(L, df, lump);
+
+    if (length != nullptr)
+        *length = L->size;
+
+    return df->mapped_ + L->position;
+}
+
+void ReleaseLumpView(int lump, const uint8_t *data)
+{
+    EPI_ASSERT(IsLumpIndexValid(lump));
+
+    const LumpInfo *L = &lump_info[lump];
+
+    if (!LumpViewIsMapped(L, data_files[L->file]))
+        delete[] data;
+}
+
 std::string LoadLumpAsString(int lump)
 {
     // WISH: optimise this to remove temporary buffer
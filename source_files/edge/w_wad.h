@@ -79,6 +79,14 @@ int GetLumpLength(int lump);
 uint8_t *LoadLumpIntoMemory(int lump, int *length = nullptr);
 uint8_t *LoadLumpIntoMemory(const char *name, int *length = nullptr);
 
+// Read-only view of a binary lump, without the copy of LoadLumpIntoMemory
+// when its WAD is memory-mapped and the lump is 4-byte aligned (otherwise
+// it is copied).  It is NOT NUL-terminated, so text lumps should use
+// LoadLumpIntoMemory or LoadLumpAsString.  The view stays valid while the
+// file is loaded; hand it back with ReleaseLumpView().
+const uint8_t *LoadLumpView(int lump, int *length = nullptr);
+void           ReleaseLumpView(int lump, const uint8_t *data);
+
 std::string LoadLumpAsString(int lump);
 std::string LoadLumpAsString(const char *name);
 
@@ -115,5 +123,8 @@ int GetKindForLump(int lump);
 
 void CloseWADFile(DataFile *df);
 
+// MD5 of the WAD directory, also used to name the XWA node cache
+std::string GetWADFileMD5(DataFile *df);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
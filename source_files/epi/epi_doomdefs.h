@@ -372,6 +372,7 @@ EPI_KNOWN_STRINGHASH(kThing, "THING")
 EPI_KNOWN_STRINGHASH(kVertex, "VERTEX")
 EPI_KNOWN_STRINGHASH(kLinedef, "LINEDEF")
 EPI_KNOWN_STRINGHASH(kSidedef, "SIDEDEF")
+EPI_KNOWN_STRINGHASH(kNamespace, "NAMESPACE")
 
 // vertexes
 EPI_KNOWN_STRINGHASH(kZFloor, "ZFLOOR")
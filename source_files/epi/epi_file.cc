@@ -318,6 +318,12 @@ unsigned int MemFile::Write(const void *src, unsigned int size)
     FatalError("MemFile::Write called.\n");
 }
 
+// the destructor (unmapping) lives with FileOpenMapped() in epi_filesystem.cc
+MappedFile::MappedFile(const uint8_t *mapping, int len)
+    : MemFile(mapping, len, false), mapping_(mapping), mapping_length_(len)
+{
+}
+
 } // namespace epi
 
 //--- editor settings ---
@@ -143,6 +143,26 @@ class MemFile : public File
     bool Seek(int offset, int seekpoint) override;
 };
 
+// read-only view of a whole file mapped into memory, see FileOpenMapped().
+// the data stays valid (and never moves) for the lifetime of the object.
+class MappedFile : public MemFile
+{
+  private:
+    const uint8_t *mapping_;
+
+    int mapping_length_;
+
+  public:
+    // takes ownership of the mapping
+    MappedFile(const uint8_t *mapping, int len);
+    ~MappedFile() override;
+
+    const uint8_t *GetData() const
+    {
+        return mapping_;
+    }
+};
+
 } // namespace epi
 
 //--- editor settings ---
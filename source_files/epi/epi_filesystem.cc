@@ -28,7 +28,9 @@
 #endif
 #ifndef _WIN32
 #include <dirent.h>
+#include <fcntl.h>
 #include <ftw.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -102,6 +104,42 @@ FILE *FileOpenRaw(std::string_view name, unsigned int flags)
     std::wstring wname = epi::UTF8ToWString(name);
     return _wfopen(wname.c_str(), mode);
 }
+MappedFile *FileOpenMapped(std::string_view name)
+{
+    EPI_ASSERT(!name.empty());
+    std::wstring wname = epi::UTF8ToWString(name);
+
+    HANDLE fhandle = CreateFileW(wname.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fhandle == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fhandle, &size) || size.QuadPart <= 0 || size.QuadPart > INT_MAX)
+    {
+        CloseHandle(fhandle);
+        return nullptr;
+    }
+
+    HANDLE mapping = CreateFileMappingW(fhandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(fhandle);
+
+    if (mapping == nullptr)
+        return nullptr;
+
+    // the view keeps the mapping (and file) open by itself
+    const uint8_t *data = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (data == nullptr)
+        return nullptr;
+
+    return new MappedFile(data, (int)size.QuadPart);
+}
+MappedFile::~MappedFile()
+{
+    UnmapViewOfFile(mapping_);
+}
 bool FileDelete(std::string_view name)
 {
     EPI_ASSERT(!name.empty());
@@ -289,6 +327,39 @@ FILE *FileOpenRaw(std::string_view name, unsigned int flags)
     EPI_ASSERT(!name.empty());
     return fopen(std::string(name).c_str(), mode);
 }
+MappedFile *FileOpenMapped(std::string_view name)
+{
+    EPI_ASSERT(!name.empty());
+#ifdef EDGE_WEB
+    // MEMFS would only give us a copy
+    return nullptr;
+#else
+    int fd = open(std::string(name).c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0 || info.st_size > INT_MAX)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    void *data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    return new MappedFile((const uint8_t *)data, (int)info.st_size);
+#endif
+}
+MappedFile::~MappedFile()
+{
+    munmap((void *)mapping_, (size_t)mapping_length_);
+}
 bool FileDelete(std::string_view name)
 {
     EPI_ASSERT(!name.empty());
@@ -36,6 +36,7 @@ enum Access
 
 // Forward declarations
 class File;
+class MappedFile;
 
 // A Filesystem directory entry
 struct DirectoryEntry
@@ -72,6 +73,9 @@ bool  FileExists(std::string_view name);
 bool  TestFileAccess(std::string_view name);
 File *FileOpen(std::string_view name, unsigned int flags);
 FILE *FileOpenRaw(std::string_view name, unsigned int flags);
+// Maps the whole file read-only into memory.  Returns nullptr when that is
+// not possible (empty file, no mmap on this platform); use FileOpen then.
+MappedFile *FileOpenMapped(std::string_view name);
 // NOTE: there's no CloseFile function, just delete the object.
 bool FileCopy(std::string_view src, std::string_view dest);
 bool FileDelete(std::string_view name);
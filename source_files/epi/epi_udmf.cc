@@ -0,0 +1,484 @@
+//----------------------------------------------------------------------------
+//  EPI UDMF TEXTMAP Parser
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "epi_udmf.h"
+
+#include <stdlib.h>
+
+#include "epi.h"
+#include "epi_doomdefs.h"
+#include "epi_str_compare.h"
+#include "epi_str_util.h"
+
+namespace epi
+{
+
+enum UDMFTokenKind
+{
+    kUDMFTokenEnd = 0,
+    kUDMFTokenIdentifier,
+    kUDMFTokenInteger,
+    kUDMFTokenFloat,
+    kUDMFTokenString,
+    kUDMFTokenSymbol, // any other single character
+    kUDMFTokenBad     // unterminated string or comment
+};
+
+struct UDMFToken
+{
+    UDMFTokenKind kind;
+    char          symbol;
+    uint32_t      start;
+    uint32_t      length;
+};
+
+static inline bool IsIdentifierChar(char c)
+{
+    return c == '_' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+}
+
+static inline bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static void SkipWhitespace(std::string_view data, uint32_t &pos, bool &unterminated)
+{
+    uint32_t end = (uint32_t)data.size();
+
+    while (pos < end)
+    {
+        char c    = data[pos];
+        char next = (pos + 1 < end) ? data[pos + 1] : 0;
+
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v' || c == 0)
+        {
+            pos++;
+        }
+        else if (c == '/' && next == '/')
+        {
+            while (pos < end && data[pos] != '\n')
+                pos++;
+        }
+        else if (c == '/' && next == '*')
+        {
+            pos += 2;
+
+            while (pos + 1 < end && !(data[pos] == '*' && data[pos + 1] == '/'))
+                pos++;
+
+            if (pos + 1 >= end)
+            {
+                unterminated = true;
+                return;
+            }
+
+            pos += 2;
+        }
+        else
+            return;
+    }
+}
+
+static void NextToken(std::string_view data, uint32_t &pos, UDMFToken &tok)
+{
+    uint32_t end          = (uint32_t)data.size();
+    bool     unterminated = false;
+
+    SkipWhitespace(data, pos, unterminated);
+
+    tok.start  = pos;
+    tok.length = 0;
+    tok.symbol = 0;
+
+    if (unterminated)
+    {
+        tok.kind = kUDMFTokenBad;
+        return;
+    }
+
+    if (pos >= end)
+    {
+        tok.kind = kUDMFTokenEnd;
+        return;
+    }
+
+    char c    = data[pos];
+    char next = (pos + 1 < end) ? data[pos + 1] : 0;
+
+    if (c == '_' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))
+    {
+        while (pos < end && IsIdentifierChar(data[pos]))
+            pos++;
+
+        tok.kind = kUDMFTokenIdentifier;
+    }
+    else if (IsDigit(c) || ((c == '-' || c == '+') && (IsDigit(next) || next == '.')) || (c == '.' && IsDigit(next)))
+    {
+        bool is_hex   = false;
+        bool is_float = false;
+
+        pos++;
+
+        if (c == '0' && (next == 'x' || next == 'X'))
+        {
+            is_hex = true;
+            pos++;
+        }
+
+        while (pos < end)
+        {
+            char d = data[pos];
+
+            if (d == '.')
+                is_float = true;
+            else if (!is_hex && (d == 'e' || d == 'E'))
+            {
+                is_float = true;
+
+                // exponent sign
+                if (pos + 1 < end && (data[pos + 1] == '-' || data[pos + 1] == '+'))
+                    pos++;
+            }
+            else if (!IsIdentifierChar(d))
+                break;
+
+            pos++;
+        }
+
+        tok.kind = (c == '.' || is_float) ? kUDMFTokenFloat : kUDMFTokenInteger;
+    }
+    else if (c == '"')
+    {
+        pos++;
+
+        tok.start = pos;
+
+        while (pos < end && data[pos] != '"')
+            pos += (data[pos] == '\\') ? 2 : 1;
+
+        if (pos >= end)
+        {
+            tok.kind = kUDMFTokenBad;
+            return;
+        }
+
+        tok.kind   = kUDMFTokenString;
+        tok.length = pos - tok.start;
+
+        pos++; // closing quote
+        return;
+    }
+    else
+    {
+        pos++;
+
+        tok.kind   = kUDMFTokenSymbol;
+        tok.symbol = c;
+    }
+
+    tok.length = pos - tok.start;
+}
+
+static inline bool IsSymbol(const UDMFToken &tok, char symbol)
+{
+    return tok.kind == kUDMFTokenSymbol && tok.symbol == symbol;
+}
+
+UDMFTextMap::UDMFTextMap()
+{
+}
+
+UDMFTextMap::~UDMFTextMap()
+{
+}
+
+void UDMFTextMap::Clear()
+{
+    data_ = std::string_view();
+
+    blocks_.clear();
+    blocks_.shrink_to_fit();
+    fields_.clear();
+    fields_.shrink_to_fit();
+    globals_.clear();
+
+    error_.clear();
+}
+
+bool UDMFTextMap::ParseError(uint32_t position, const char *message)
+{
+    int line = 1;
+
+    for (uint32_t i = 0; i < position && i < data_.size(); i++)
+        if (data_[i] == '\n')
+            line++;
+
+    error_ = StringFormat("Malformed TEXTMAP lump: %s (line %d)", message, line);
+
+    return false;
+}
+
+bool UDMFTextMap::Parse(std::string_view data)
+{
+    Clear();
+
+    if (data.size() >= 0xFFFFFFFFu)
+        return ParseError(0, "lump is too large");
+
+    data_ = data;
+
+    // a typical field ("x = 1024.000;" plus indentation) takes around
+    // twenty bytes, so this avoids most of the regrowth on large maps.
+    fields_.reserve(data.size() / 24);
+
+    uint32_t  pos = 0;
+    UDMFToken tok;
+
+    for (;;)
+    {
+        NextToken(data, pos, tok);
+
+        if (tok.kind == kUDMFTokenEnd)
+            break;
+
+        if (tok.kind == kUDMFTokenBad)
+            return ParseError(tok.start, "unterminated string or comment");
+
+        if (tok.kind != kUDMFTokenIdentifier)
+            return ParseError(tok.start, "expected a block or assignment");
+
+        uint32_t name = StringHash::Calculate(data.data() + tok.start, tok.length);
+
+        NextToken(data, pos, tok);
+
+        bool is_global = IsSymbol(tok, '=');
+
+        if (!is_global && !IsSymbol(tok, '{'))
+            return ParseError(tok.start, "missing '{'");
+
+        UDMFBlock block;
+
+        block.name        = name;
+        block.first_field = (uint32_t)fields_.size();
+
+        for (;;)
+        {
+            UDMFField field;
+
+            if (is_global)
+            {
+                field.key = name;
+            }
+            else
+            {
+                NextToken(data, pos, tok);
+
+                if (IsSymbol(tok, '}'))
+                    break;
+
+                if (tok.kind == kUDMFTokenEnd)
+                    return ParseError(tok.start, "unclosed block");
+
+                if (tok.kind == kUDMFTokenBad)
+                    return ParseError(tok.start, "unterminated string or comment");
+
+                if (tok.kind != kUDMFTokenIdentifier)
+                    return ParseError(tok.start, "missing key");
+
+                field.key = StringHash::Calculate(data.data() + tok.start, tok.length);
+
+                NextToken(data, pos, tok);
+
+                if (!IsSymbol(tok, '='))
+                    return ParseError(tok.start, "missing '='");
+            }
+
+            NextToken(data, pos, tok);
+
+            switch (tok.kind)
+            {
+            case kUDMFTokenInteger:
+                field.type = kUDMFValueInteger;
+                break;
+            case kUDMFTokenFloat:
+                field.type = kUDMFValueFloat;
+                break;
+            case kUDMFTokenString:
+                field.type = kUDMFValueString;
+                break;
+            case kUDMFTokenIdentifier:
+                field.type = kUDMFValueKeyword;
+                break;
+            case kUDMFTokenBad:
+                return ParseError(tok.start, "unterminated string or comment");
+            default:
+                return ParseError(tok.start, "missing value");
+            }
+
+            field.start  = tok.start;
+            field.length = tok.length;
+
+            NextToken(data, pos, tok);
+
+            if (!IsSymbol(tok, ';'))
+                return ParseError(tok.start, "missing ';'");
+
+            if (is_global)
+            {
+                globals_.push_back(field);
+                break;
+            }
+
+            fields_.push_back(field);
+        }
+
+        if (!is_global)
+        {
+            block.total_fields = (uint32_t)fields_.size() - block.first_field;
+            blocks_.push_back(block);
+        }
+    }
+
+    return true;
+}
+
+std::string UDMFTextMap::GetNamespace() const
+{
+    for (const UDMFField &field : globals_)
+    {
+        if (field.key == udmf::kNamespace)
+            return String(field);
+    }
+
+    return "";
+}
+
+int UDMFTextMap::CountBlocks(uint32_t name) const
+{
+    int count = 0;
+
+    for (const UDMFBlock &block : blocks_)
+    {
+        if (block.name == name)
+            count++;
+    }
+
+    return count;
+}
+
+int UDMFTextMap::Number(const UDMFField &field) const
+{
+    switch (field.type)
+    {
+    case kUDMFValueInteger: {
+        char     buffer[64];
+        uint32_t length = (field.length < sizeof(buffer)) ? field.length : sizeof(buffer) - 1;
+
+        memcpy(buffer, data_.data() + field.start, length);
+        buffer[length] = 0;
+
+        int base = 10;
+
+        if (buffer[0] == '0' && length > 1)
+            base = (buffer[1] == 'x' || buffer[1] == 'X') ? 16 : 8;
+
+        return (int)strtol(buffer, nullptr, base);
+    }
+    case kUDMFValueFloat:
+        return (int)Decimal(field);
+    case kUDMFValueKeyword:
+        return Boolean(field) ? 1 : 0;
+    default:
+        return 0;
+    }
+}
+
+double UDMFTextMap::Decimal(const UDMFField &field) const
+{
+    if (field.type != kUDMFValueFloat)
+        return Number(field);
+
+    char     buffer[64];
+    uint32_t length = (field.length < sizeof(buffer)) ? field.length : sizeof(buffer) - 1;
+
+    memcpy(buffer, data_.data() + field.start, length);
+    buffer[length] = 0;
+
+    return atof(buffer);
+}
+
+bool UDMFTextMap::Boolean(const UDMFField &field) const
+{
+    switch (field.type)
+    {
+    case kUDMFValueInteger:
+    case kUDMFValueFloat:
+        return Number(field) != 0;
+    case kUDMFValueKeyword:
+        return StringCaseCompareASCII(RawString(field), "true") == 0;
+    default:
+        return false;
+    }
+}
+
+std::string_view UDMFTextMap::RawString(const UDMFField &field) const
+{
+    return data_.substr(field.start, field.length);
+}
+
+std::string UDMFTextMap::String(const UDMFField &field) const
+{
+    std::string_view raw = RawString(field);
+
+    if (field.type != kUDMFValueString || raw.find('\\') == std::string_view::npos)
+        return std::string(raw);
+
+    std::string result;
+    result.reserve(raw.size());
+
+    for (size_t i = 0; i < raw.size(); i++)
+    {
+        char c = raw[i];
+
+        if (c == '\\' && i + 1 < raw.size())
+        {
+            char next = raw[i + 1];
+
+            if (next == '\\' || next == '"')
+            {
+                c = next;
+                i++;
+            }
+            else if (next == 'n')
+            {
+                c = '\n';
+                i++;
+            }
+        }
+
+        result.push_back(c);
+    }
+
+    return result;
+}
+
+} // namespace epi
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,125 @@
+//----------------------------------------------------------------------------
+//  EPI UDMF TEXTMAP Parser
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+//  Tokenizes a whole TEXTMAP lump in a single pass into a flat table of
+//  blocks and fields.  Block names and keys are stored as StringHash
+//  values (compare them against the udmf:: hashes in epi_doomdefs.h),
+//  values as spans into the original text which are only converted when
+//  asked for.  Nothing is allocated per token, so consumers which need
+//  several passes (e.g. sidedefs after linedefs) simply walk the table
+//  again instead of re-lexing the text.
+//
+//  The table refers to the text it was built from, which must outlive it.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace epi
+{
+
+enum UDMFValueType
+{
+    kUDMFValueInteger = 0,
+    kUDMFValueFloat,
+    kUDMFValueString,  // quoted, may contain escapes
+    kUDMFValueKeyword, // unquoted, e.g. true or false
+};
+
+struct UDMFField
+{
+    uint32_t key;    // StringHash value of the key
+    uint32_t start;  // offset of the value in the text
+    uint32_t length; // length of the value (without quotes)
+    uint8_t  type;   // UDMFValueType
+};
+
+struct UDMFBlock
+{
+    uint32_t name;        // StringHash value of the block name
+    uint32_t first_field; // index into the field table
+    uint32_t total_fields;
+};
+
+class UDMFTextMap
+{
+  public:
+    UDMFTextMap();
+    ~UDMFTextMap();
+
+    // Parses the whole TEXTMAP.  Returns false on malformed input, with
+    // GetError() describing the problem and the line it occurred on.
+    bool Parse(std::string_view data);
+
+    // Frees the tables.
+    void Clear();
+
+    const std::string &GetError() const
+    {
+        return error_;
+    }
+
+    // The value of the top-level "namespace" assignment, or an empty
+    // string if there was none.
+    std::string GetNamespace() const;
+
+    // All blocks, in the order they appear in the TEXTMAP.
+    const std::vector<UDMFBlock> &Blocks() const
+    {
+        return blocks_;
+    }
+
+    const UDMFField *BlockFields(const UDMFBlock &block) const
+    {
+        return fields_.data() + block.first_field;
+    }
+
+    int CountBlocks(uint32_t name) const;
+
+    // Value conversions, following the same rules as epi::Scanner:
+    // integers may be octal or hexadecimal, floats are truncated for
+    // Number(), and booleans are any non-zero number or "true".
+    int              Number(const UDMFField &field) const;
+    double           Decimal(const UDMFField &field) const;
+    bool             Boolean(const UDMFField &field) const;
+    std::string_view RawString(const UDMFField &field) const;
+    std::string      String(const UDMFField &field) const; // escapes processed
+
+  private:
+    std::string_view data_;
+
+    std::vector<UDMFBlock> blocks_;
+    std::vector<UDMFField> fields_;
+
+    // top-level assignments, e.g. namespace = "doom";
+    std::vector<UDMFField> globals_;
+
+    std::string error_;
+
+    bool ParseError(uint32_t position, const char *message);
+};
+
+} // namespace epi
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab